@@ -0,0 +1,280 @@
+#include "benchmarks/BenchmarkRegistry.h"
+#include "benchmarks/Bf16Bench.h"
+#include "benchmarks/CacheBench.h"
+#include "benchmarks/CpuComputeBench.h"
+#include "benchmarks/Fp16Bench.h"
+#include "benchmarks/Fp32Bench.h"
+#include "benchmarks/Fp4Bench.h"
+#include "benchmarks/Fp64Bench.h"
+#include "benchmarks/Fp8Bench.h"
+#include "benchmarks/Int4Bench.h"
+#include "benchmarks/Int8Bench.h"
+#include "benchmarks/MemBandwidthBench.h"
+#include "benchmarks/SysMemBandwidthBench.h"
+#include "benchmarks/SysMemLatencyBench.h"
+#include "benchmarks/SysMemNumaBench.h"
+#ifdef HAVE_VULKAN
+#include "benchmarks/RayASBuildBench.h"
+#include "benchmarks/RayAnyHitBench.h"
+#include "benchmarks/RayDivergenceBench.h"
+#include "benchmarks/RayIncoherentBench.h"
+#include "benchmarks/RayMaterialDivergenceBench.h"
+#include "benchmarks/RayPayloadBench.h"
+#include "benchmarks/RayProceduralBench.h"
+#include "benchmarks/RayTracingBench.h"
+#endif
+// #include "benchmarks/Fp6Bench.h" // Temporarily disabled
+#include <algorithm>
+#include <numeric>
+#include <random>
+
+// Helper function to create a shuffled index array for pointer chasing
+static std::vector<uint32_t> create_shuffled_indices(size_t size) {
+  std::vector<uint32_t> indices(size);
+  std::iota(indices.begin(), indices.end(), 0);
+  std::mt19937 g(1337); // Use a fixed seed for reproducibility
+  std::shuffle(indices.begin(), indices.end(), g);
+  return indices;
+}
+
+static std::string to_lower(std::string s) {
+  std::transform(s.begin(), s.end(), s.begin(),
+                 [](unsigned char c) { return std::tolower(c); });
+  return s;
+}
+
+template <typename T>
+static BenchmarkDescriptor describe(std::string name,
+                                    std::vector<std::string> aliases,
+                                    std::string component,
+                                    std::string subcategory,
+                                    bool deviceDependent = true) {
+  return {std::move(name),        std::move(aliases),
+          std::move(component),   std::move(subcategory),
+          deviceDependent,        [] { return std::make_unique<T>(); }};
+}
+
+static BenchmarkDescriptor
+describeCacheLatency(std::string name, std::string alias, size_t size,
+                     std::string kernel, int targetCacheLevel) {
+  // The shuffled chase indices (up to 64 MB) are only generated once the
+  // benchmark is actually instantiated
+  return {name, {alias}, "Memory", "Latency", true,
+          [=] {
+            return std::make_unique<CacheBench>(
+                name, "ns", size, kernel,
+                create_shuffled_indices(size / sizeof(uint32_t)),
+                std::vector<std::string>{alias}, targetCacheLevel);
+          }};
+}
+
+static std::vector<BenchmarkDescriptor> builtinBenchmarks() {
+  std::vector<BenchmarkDescriptor> list;
+  list.push_back(describe<Fp64Bench>("FP64", {"f64", "performance"},
+                                     "Compute", "FP64"));
+  list.push_back(describe<Fp32Bench>("FP32", {"f32", "performance"},
+                                     "Compute", "FP32"));
+  list.push_back(describe<Fp16Bench>("FP16", {"f16", "performance"},
+                                     "Compute", "FP16"));
+  list.push_back(describe<Bf16Bench>("BF16", {"bf16", "performance"},
+                                     "Compute", "BF16"));
+  list.push_back(describe<Fp8Bench>("FP8", {"f8", "performance"}, "Compute",
+                                    "FP8"));
+  // Fp6Bench temporarily disabled
+  list.push_back(describe<Fp4Bench>("FP4", {"f4", "performance"}, "Compute",
+                                    "FP4"));
+  list.push_back(describe<Int8Bench>("INT8", {"int8", "int8b", "performance"},
+                                     "Compute", "INT8"));
+  list.push_back(describe<Int4Bench>("INT4", {"int4", "performance"},
+                                     "Compute", "INT4"));
+  list.push_back(describe<MemBandwidthBench>("Performance", {"membw"},
+                                             "Memory", "Bandwidth"));
+  list.push_back(describe<SysMemBandwidthBench>(
+      "System Memory Bandwidth", {"sysmem", "ram", "bw"}, "Memory",
+      "Bandwidth", false));
+  list.push_back(describe<SysMemLatencyBench>(
+      "System Memory Latency", {"sysmem_latency", "ram_latency", "sl"},
+      "Memory", "Latency", false));
+  list.push_back(describe<SysMemNumaBench>(
+      "System Memory NUMA", {"numa", "sysmem_numa"}, "Memory", "Bandwidth",
+      false));
+  list.push_back(describe<CpuComputeBench>(
+      "CPU Compute", {"cpu", "cpu_compute"}, "Compute", "FP64", false));
+#ifdef HAVE_VULKAN
+  list.push_back(describe<RayTracingBench>("RayTracing", {"rt", "raytracing"},
+                                           "Ray Tracing",
+                                           "Intersection tests"));
+  list.push_back(describe<RayDivergenceBench>(
+      "RayDivergence",
+      {"raydiv", "divergence", "materialdivergence", "raymaterialdivergence"},
+      "Ray Tracing", "Material Divergence"));
+  list.push_back(describe<RayAnyHitBench>("RayAnyHit", {}, "Ray Tracing",
+                                          "Alpha-Tested Geometry"));
+  list.push_back(describe<RayIncoherentBench>("RayIncoherent", {},
+                                              "Ray Tracing",
+                                              "Incoherent Traversal"));
+  list.push_back(describe<RayPayloadBench>("RayPayload", {}, "Ray Tracing",
+                                           "Payload Register Pressure"));
+  list.push_back(describe<RayASBuildBench>("RayASBuild", {}, "Ray Tracing",
+                                           "BLAS Build"));
+  list.push_back(describe<RayProceduralBench>("RayProcedural", {},
+                                              "Ray Tracing",
+                                              "Procedural Intersection"));
+  list.push_back(describe<RayMaterialDivergenceBench>(
+      "RayMaterialDivergence",
+      {"raymatdiv", "materialdivergence", "raydivergence"}, "Ray Tracing",
+      "Material Divergence"));
+#endif // HAVE_VULKAN
+
+  // Cache Bandwidth is currently difficult to measure reliably because shader
+  // compilers aggressively optimize out the memory reading loops via
+  // Dead-Code Elimination. The "cache_bw_robust" L0-L3 bandwidth variants
+  // stay disabled until a more robust measurement technique is implemented.
+
+  // Cache Latency
+  list.push_back(describeCacheLatency("L0 Cache Latency", "l0l", 16 * 1024,
+                                      "l0_cache_latency", 0));
+  list.push_back(describeCacheLatency("L1 Cache Latency", "l1l", 128 * 1024,
+                                      "cache_latency", -1));
+  list.push_back(describeCacheLatency("L2 Cache Latency", "l2l",
+                                      4 * 1024 * 1024, "cache_latency", -1));
+  list.push_back(describeCacheLatency("L3 Cache Latency", "l3l",
+                                      64 * 1024 * 1024, "cache_latency", -1));
+  return list;
+}
+
+bool BenchmarkDescriptor::matches(
+    const std::vector<std::string> &lower_names) const {
+  if (lower_names.empty())
+    return true;
+  std::string name_lower = to_lower(name);
+  if (name_lower == "performance") {
+    name_lower += " (" + to_lower(subcategory) + ")";
+  }
+  for (const auto &run_name : lower_names) {
+    if (name_lower.find(run_name) != std::string::npos)
+      return true;
+    for (const auto &alias : aliases) {
+      if (to_lower(alias) == run_name)
+        return true;
+    }
+  }
+  return false;
+}
+
+std::vector<BenchmarkDescriptor> &BenchmarkRegistry::registry() {
+  static std::vector<BenchmarkDescriptor> benchmarks = builtinBenchmarks();
+  return benchmarks;
+}
+
+const std::vector<BenchmarkDescriptor> &BenchmarkRegistry::all() {
+  return registry();
+}
+
+void BenchmarkRegistry::add(BenchmarkDescriptor descriptor) {
+  registry().push_back(std::move(descriptor));
+}
+
+std::vector<SelectedBenchmark>
+BenchmarkRegistry::select(const std::vector<std::string> &benchmarks_to_run) {
+  struct Entry {
+    std::vector<std::string> lower_name; // Single name, as matches() expects
+    ConfigFilter configs;
+  };
+  std::vector<Entry> entries;
+  std::string pending_name, pending_spec;
+  auto flush = [&]() {
+    if (pending_name.empty() && pending_spec.empty())
+      return;
+    Entry entry;
+    entry.lower_name.push_back(to_lower(pending_name));
+    if (!pending_spec.empty())
+      entry.configs = ConfigFilter::parse(pending_spec);
+    entries.push_back(std::move(entry));
+    pending_name.clear();
+    pending_spec.clear();
+  };
+  for (const auto &b : benchmarks_to_run) {
+    // The -b list is split on commas before it gets here, so "raydiv:2,4"
+    // arrives as "raydiv:2" and "4". Index and glob terms without a colon
+    // continue the previous entry's config list.
+    bool is_config_term =
+        !b.empty() && b.find(':') == std::string::npos &&
+        (b.find_first_of("*?") != std::string::npos ||
+         std::all_of(b.begin(), b.end(),
+                     [](unsigned char c) { return std::isdigit(c); }));
+    if (is_config_term && !pending_spec.empty()) {
+      pending_spec += "," + b;
+      continue;
+    }
+    flush();
+    size_t colon = b.find(':');
+    pending_name = b.substr(0, colon);
+    if (colon != std::string::npos)
+      pending_spec = b.substr(colon + 1);
+  }
+  flush();
+
+  std::vector<SelectedBenchmark> selected;
+  for (const auto &desc : registry()) {
+    if (entries.empty()) {
+      selected.push_back({&desc, {}});
+      continue;
+    }
+    bool matched = false;
+    ConfigFilter configs;
+    for (const auto &entry : entries) {
+      if (!desc.matches(entry.lower_name))
+        continue;
+      if (matched)
+        configs.merge(entry.configs);
+      else
+        configs = entry.configs;
+      matched = true;
+    }
+    if (matched)
+      selected.push_back({&desc, configs});
+  }
+  return selected;
+}
+
+std::vector<std::unique_ptr<IBenchmark>>
+BenchmarkRegistry::create(const std::vector<std::string> &benchmarks_to_run) {
+  std::vector<std::unique_ptr<IBenchmark>> benchmarks;
+  for (const auto &selected : select(benchmarks_to_run)) {
+    auto bench = selected.descriptor->create();
+    bench->SetConfigFilter(selected.configs);
+    benchmarks.push_back(std::move(bench));
+  }
+  return benchmarks;
+}
+
+std::vector<std::string> BenchmarkRegistry::verify() {
+  std::vector<std::string> errors;
+  for (const auto &desc : registry()) {
+    auto bench = desc.create();
+    std::string prefix = "\"" + desc.name + "\": ";
+    if (desc.name != bench->GetName()) {
+      errors.push_back(prefix + "benchmark is named \"" + bench->GetName() +
+                       "\"");
+    }
+    if (desc.aliases != bench->GetAliases())
+      errors.push_back(prefix + "aliases differ from GetAliases()");
+    if (desc.deviceDependent != bench->IsDeviceDependent())
+      errors.push_back(prefix + "device dependence differs");
+
+    // Some benchmarks only know their configs after Setup(); config 0 is
+    // the default for those
+    uint32_t configs = std::max<uint32_t>(bench->GetNumConfigs(), 1);
+    bool found = false;
+    for (uint32_t i = 0; i < configs && !found; ++i) {
+      found = desc.component == bench->GetComponent(i) &&
+              desc.subcategory == bench->GetSubCategory(i);
+    }
+    if (!found) {
+      errors.push_back(prefix + "no config has component/subcategory \"" +
+                       desc.component + "/" + desc.subcategory + "\"");
+    }
+  }
+  return errors;
+}
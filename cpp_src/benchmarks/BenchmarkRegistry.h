@@ -0,0 +1,69 @@
+#pragma once
+
+#include "benchmarks/ConfigFilter.h"
+#include "benchmarks/IBenchmark.h"
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Static description of a benchmark. Everything needed to list and select a
+// benchmark is available here without constructing it; create() is only
+// called for benchmarks that are actually going to run.
+struct BenchmarkDescriptor {
+  // Checked against the benchmark by BenchmarkRegistry::verify()
+  std::string name;                 // IBenchmark::GetName()
+  std::vector<std::string> aliases; // IBenchmark::GetAliases()
+  std::string component;            // GetComponent() of some config
+  std::string subcategory;          // GetSubCategory() of the same config
+  bool deviceDependent = true;
+  std::function<std::unique_ptr<IBenchmark>()> create;
+
+  // Same rules as the runner: substring match on the (lowercased) name,
+  // exact match on an alias. "Performance" is qualified by its subcategory.
+  bool matches(const std::vector<std::string> &lower_names) const;
+};
+
+// A registered benchmark picked by the -b selection, together with the
+// configs requested for it ("name:filter" entries).
+struct SelectedBenchmark {
+  const BenchmarkDescriptor *descriptor;
+  ConfigFilter configs;
+};
+
+class BenchmarkRegistry {
+public:
+  // All registered benchmarks, in report order. The built-in benchmarks are
+  // registered on first use.
+  static const std::vector<BenchmarkDescriptor> &all();
+
+  // Register an additional benchmark (e.g. from an optional module).
+  static void add(BenchmarkDescriptor descriptor);
+
+  // Resolve a -b selection (all if empty), in registry order. Each entry is
+  // a benchmark name or alias optionally followed by ":configs".
+  static std::vector<SelectedBenchmark>
+  select(const std::vector<std::string> &benchmarks_to_run);
+
+  // Instantiate every benchmark matching the selection, in select() order.
+  static std::vector<std::unique_ptr<IBenchmark>>
+  create(const std::vector<std::string> &benchmarks_to_run);
+
+  // Instantiates every registered benchmark and checks its descriptor
+  // against it: name, aliases and device dependence must be equal, and the
+  // component and subcategory must be those of one of its configs. Returns
+  // one message per mismatch.
+  static std::vector<std::string> verify();
+
+private:
+  static std::vector<BenchmarkDescriptor> &registry();
+};
+
+// Helper for registering a benchmark from a translation unit's static
+// initializer. Note that the built-ins are listed in BenchmarkRegistry.cpp
+// instead: a static library drops object files nothing else references.
+struct BenchmarkRegistrar {
+  explicit BenchmarkRegistrar(BenchmarkDescriptor descriptor) {
+    BenchmarkRegistry::add(std::move(descriptor));
+  }
+};
@@ -7,8 +7,50 @@ bool Bf16Bench::IsSupported(const DeviceInfo &info,
   return info.bf16Support;
 }
 
+KernelSource Bf16Bench::kernelSource(bool matrix, ComputeBackend backend,
+                                     const DeviceInfo &info,
+                                     const std::string &kernel_dir) const {
+  std::filesystem::path kdir(kernel_dir);
+  if (backend == ComputeBackend::ROCm) {
+    if (!matrix)
+      return {(kdir / "rocm" / "bf16.hip").string(), "run_benchmark", 1};
+    // Matrix WMMA is disabled on ROCm due to 7.1.1 backend crash for RDNA4.
+    // RDNA3 (gfx11) is fine.
+    if (info.name.find("gfx11") != std::string::npos)
+      return {(kdir / "rocm" / "bf16_matrix.hip").string(), "run_benchmark",
+              1};
+    return {};
+  }
+  if (backend == ComputeBackend::OpenCL) {
+    if (!matrix)
+      return {(kdir / "opencl" / "bf16.cl").string(), "main", 1};
+    return {};
+  }
+  if (!matrix)
+    return {(kdir / "vulkan" / "bf16.comp").string(), "main", 1};
+  if (info.cooperativeMatrixSupport)
+    return {(kdir / "vulkan" / "coop_matrix_bf16.comp").string(), "main", 1};
+  return {};
+}
+
 void Bf16Bench::Setup(IComputeContext &context, const std::string &kernel_dir) {
   this->context = &context;
+  const DeviceInfo &info = context.getCurrentDeviceInfo();
+
+  KernelSource vector =
+      kernelSource(false, context.getBackend(), info, kernel_dir);
+  KernelSource matrix =
+      kernelSource(true, context.getBackend(), info, kernel_dir);
+
+  // The vector config keeps index 0 when the filter excludes it, so matrix
+  // indices don't depend on the filter. Skip the kernels of excluded configs,
+  // and the buffer too if nothing is selected.
+  hasVector = !vector.file.empty();
+  bool wantVector = hasVector && configFilter.matches(0, GetConfigName(0));
+  bool wantMatrix = !matrix.file.empty() &&
+                    configFilter.matches(hasVector ? 1 : 0, "Matrix");
+  if (!wantVector && !wantMatrix)
+    return;
 
   // Create storage buffer
   size_t bufferSize =
@@ -16,44 +58,22 @@ void Bf16Bench::Setup(IComputeContext &context, const std::string &kernel_dir) {
   buffer = context.createBuffer(bufferSize);
 
   // Load Vector Kernel
-  std::filesystem::path kdir(kernel_dir);
-  std::filesystem::path vector_file;
-  std::filesystem::path matrix_file;
-
-  if (context.getBackend() == ComputeBackend::ROCm) {
-    vector_file = kdir / "rocm" / "bf16.hip";
-    matrix_file = kdir / "rocm" / "bf16_matrix.hip";
-  } else if (context.getBackend() == ComputeBackend::OpenCL) {
-    vector_file = kdir / "opencl" / "bf16.cl";
-  } else {
-    vector_file = kdir / "vulkan" / "bf16.comp";
-    matrix_file = kdir / "vulkan" / "coop_matrix_bf16.comp";
-  }
-
-  std::string vec_func_name = (context.getBackend() == ComputeBackend::ROCm) ? "run_benchmark" : "main";
-  try {
-    vectorKernel = context.createKernel(vector_file.string(), vec_func_name, 1);
-    context.setKernelArg(vectorKernel, 0, buffer);
-  } catch (...) {
-    vectorKernel = nullptr;
+  if (wantVector) {
+    try {
+      vectorKernel =
+          context.createKernel(vector.file, vector.name, vector.numArgs);
+      context.setKernelArg(vectorKernel, 0, buffer);
+    } catch (...) {
+      vectorKernel = nullptr;
+      hasVector = false;
+    }
   }
 
   // Optionally load Matrix Kernel if supported
-  bool try_load_matrix = false;
-  if (context.getBackend() == ComputeBackend::Vulkan && context.getCurrentDeviceInfo().cooperativeMatrixSupport) {
-      try_load_matrix = true;
-  } else if (context.getBackend() == ComputeBackend::ROCm) {
-      // Matrix WMMA is disabled on ROCm due to 7.1.1 backend crash for RDNA4.
-      // If we are on RDNA3 (gfx1100), we could enable it, but for now we skip.
-      if (context.getCurrentDeviceInfo().name.find("gfx11") != std::string::npos) {
-          try_load_matrix = true;
-      }
-  }
-
-  if (try_load_matrix) {
+  if (wantMatrix) {
     try {
-      std::string func_name = (context.getBackend() == ComputeBackend::ROCm) ? "run_benchmark" : "main";
-      matrixKernel = context.createKernel(matrix_file.string(), func_name, 1);
+      matrixKernel =
+          context.createKernel(matrix.file, matrix.name, matrix.numArgs);
       if (matrixKernel) {
           context.setKernelArg(matrixKernel, 0, buffer);
       }
@@ -63,11 +83,34 @@ void Bf16Bench::Setup(IComputeContext &context, const std::string &kernel_dir) {
   }
 }
 
+std::vector<KernelSource>
+Bf16Bench::GetKernelSources(ComputeBackend backend, const DeviceInfo &info,
+                            const std::string &kernel_dir) const {
+  std::vector<KernelSource> sources;
+  uint32_t config_idx = 0;
+  for (bool matrix : {false, true}) {
+    KernelSource source = kernelSource(matrix, backend, info, kernel_dir);
+    if (source.file.empty())
+      continue;
+    if (configFilter.matches(config_idx++, matrix ? "Matrix" : "Vector"))
+      sources.push_back(source);
+  }
+  return sources;
+}
+
+uint32_t
+Bf16Bench::GetExpectedKernelCount(ComputeBackend backend,
+                                  const DeviceInfo &info,
+                                  const std::string &kernel_dir) const {
+  return static_cast<uint32_t>(
+      GetKernelSources(backend, info, kernel_dir).size());
+}
+
 void Bf16Bench::Run(uint32_t config_idx) {
-  if (config_idx == 0 && vectorKernel != nullptr) {
-    context->dispatch(vectorKernel, 8192, 1, 1, 64, 1, 1);
+  if (config_idx == 0 && hasVector) {
+    submitDispatch(context, vectorKernel, 8192, 1, 1, 64, 1, 1);
   } else if (matrixKernel) {
-    context->dispatch(matrixKernel, 32768, 1, 1, 32, 1, 1);
+    submitDispatch(context, matrixKernel, 32768, 1, 1, 32, 1, 1);
   }
 }
 
@@ -81,10 +124,11 @@ void Bf16Bench::Teardown() {
   vectorKernel = nullptr;
   matrixKernel = nullptr;
   buffer = nullptr;
+  hasVector = false;
 }
 
 BenchmarkResult Bf16Bench::GetResult(uint32_t config_idx) const {
-  if (config_idx == 0 && vectorKernel != nullptr) { // Vector
+  if (config_idx == 0 && hasVector) { // Vector
     uint64_t iters = 16384;
     uint64_t ops_per_iter = 128; // Vulkan/OpenCL use f16vec2 (128 ops)
     if (context && context->getBackend() == ComputeBackend::ROCm) {
@@ -107,12 +151,12 @@ BenchmarkResult Bf16Bench::GetResult(uint32_t config_idx) const {
 
 uint32_t Bf16Bench::GetNumConfigs() const {
   int configs = 0;
-  if (vectorKernel != nullptr) configs++;
+  if (hasVector) configs++;
   if (matrixKernel != nullptr) configs++;
   return configs;
 }
 
 std::string Bf16Bench::GetConfigName(uint32_t config_idx) const {
-  if (config_idx == 0 && vectorKernel != nullptr) return "Vector";
+  if (config_idx == 0 && hasVector) return "Vector";
   return "Matrix";
 }
@@ -7,6 +7,9 @@ public:
   bool IsSupported(const DeviceInfo &info,
                    IComputeContext *context) const override;
   void Setup(IComputeContext &context, const std::string &kernel_dir) override;
+  std::vector<KernelSource>
+  GetKernelSources(ComputeBackend backend, const DeviceInfo &info,
+                   const std::string &kernel_dir) const override;
   void Run(uint32_t config_idx) override;
   void Teardown() override;
 
@@ -24,11 +27,22 @@ public:
     return "BF16";
   }
   int GetSortWeight() const override { return 35; }
-  uint32_t GetExpectedKernelCount() const override { return 2; }
+  bool SupportsBatching() const override { return true; }
+  uint32_t GetExpectedKernelCount(ComputeBackend backend,
+                                  const DeviceInfo &info,
+                                  const std::string &kernel_dir) const override;
 
 private:
   IComputeContext *context = nullptr;
   ComputeKernel vectorKernel = nullptr;
   ComputeKernel matrixKernel = nullptr;
   ComputeBuffer buffer = nullptr;
+  // Config 0 is Vector when set, even if the config filter skipped its kernel
+  bool hasVector = false;
+
+  // The vector or matrix kernel for this backend and device, with an empty
+  // file if there is none. Setup() creates these, GetKernelSources() lists them.
+  KernelSource kernelSource(bool matrix, ComputeBackend backend,
+                            const DeviceInfo &info,
+                            const std::string &kernel_dir) const;
 };
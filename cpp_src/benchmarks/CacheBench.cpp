@@ -1,4 +1,5 @@
 #include "benchmarks/CacheBench.h"
+#include "core/HostContext.h"
 #include <algorithm> // for std::min
 #include <cstdlib>
 #include <cstring>
@@ -7,15 +8,6 @@
 #include <numeric>
 #include <stdexcept>
 
-#ifdef _WIN32
-#include <malloc.h>
-#define ALIGNED_ALLOC(alignment, size) _aligned_malloc(size, alignment)
-#define ALIGNED_FREE(ptr) _aligned_free(ptr)
-#else
-#define ALIGNED_ALLOC(alignment, size) aligned_alloc(alignment, size)
-#define ALIGNED_FREE(ptr) free(ptr)
-#endif
-
 CacheBench::CacheBench(std::string name, std::string metric,
                        uint64_t bufferSize, std::string kernelFile,
                        std::vector<uint32_t> initData,
@@ -43,6 +35,9 @@ CacheBench::~CacheBench() {
 
 bool CacheBench::IsSupported(const DeviceInfo &info,
                              IComputeContext *context) const {
+  // The Host backend only implements some of the cache kernels
+  if (context && context->getBackend() == ComputeBackend::Host)
+    return HostContext::hasKernel(kernelFile);
   return true;
 }
 
@@ -61,10 +56,28 @@ static uint64_t roundDownToPowerOf2(uint64_t v) {
   return v - (v >> 1);
 }
 
+KernelSource CacheBench::kernelSource(ComputeBackend backend,
+                                      const std::string &kernel_dir) const {
+  std::filesystem::path kdir(kernel_dir);
+  if (backend == ComputeBackend::ROCm)
+    return {(kdir / "rocm" / (kernelFile + ".hip")).string(), "run_benchmark",
+            2};
+  if (backend == ComputeBackend::OpenCL)
+    return {(kdir / "opencl" / (kernelFile + ".cl")).string(),
+            "run_benchmark", 2};
+  return {(kdir / "vulkan" / (kernelFile + ".comp")).string(), "main", 2};
+}
+
+std::vector<KernelSource>
+CacheBench::GetKernelSources(ComputeBackend backend, const DeviceInfo &info,
+                             const std::string &kernel_dir) const {
+  return {kernelSource(backend, kernel_dir)};
+}
+
 void CacheBench::Setup(IComputeContext &context,
                        const std::string &kernel_dir) {
   this->context = &context;
-  DeviceInfo info = context.getCurrentDeviceInfo();
+  const DeviceInfo &info = context.getCurrentDeviceInfo();
 
   // Adjust buffer size based on cache level if available
   if (targetCacheLevel == 3 && info.l3CacheSize > 0) {
@@ -101,67 +114,37 @@ void CacheBench::Setup(IComputeContext &context,
     numWorkgroups = 1;
   }
 
-  if (bufferSize > 0) {
-    // Allocate page-aligned host memory for Zero Copy / Pinned access.
-    // This is critical for stability on Unified Memory (APU) platforms like
-    // Strix Halo to ensure the driver can map the memory without page faults or
-    // copying.
-    hostMem = ALIGNED_ALLOC(4096, bufferSize);
-
-    if (hostMem) {
-      // Initialize memory
-      if (!initData.empty()) {
-        size_t copySize =
-            std::min((size_t)bufferSize, initData.size() * sizeof(uint32_t));
-        memcpy(hostMem, initData.data(), copySize);
-        // Zero fill the rest if any
-        if (copySize < bufferSize) {
-          memset((char *)hostMem + copySize, 0, bufferSize - copySize);
-        }
-      } else {
-        memset(hostMem, 0, bufferSize);
-      }
-
-      // Create buffer using the aligned host pointer (CL_MEM_USE_HOST_PTR)
-      // Print buffer range for debugging
-      if (debug) {
-        std::cout << "  [DEBUG] CacheBench Buffer: " << hostMem << " - "
-                  << (void *)((char *)hostMem + bufferSize) << " ("
-                  << (bufferSize / 1024 / 1024) << " MB)" << std::endl;
-      }
-      buffer = context.createBuffer(bufferSize, hostMem);
-    } else {
-      // Fallback to standard allocation if host allocation fails (unlikely)
-      buffer = context.createBuffer(bufferSize);
-      if (!initData.empty()) {
-        context.writeBuffer(buffer, 0, initData.size() * sizeof(uint32_t),
-                            initData.data());
-      }
+  if (bufferSize > 0 && context.getCurrentDeviceInfo().unifiedMemory &&
+      context.supportsBufferFlags(BUFFER_REBAR)) {
+    // On unified-memory (APU) platforms like Strix Halo, initialize the
+    // buffer in place through a zero-copy mapping instead of staging it
+    buffer = context.createBuffer(bufferSize, BUFFER_REBAR);
+    char *mapped = static_cast<char *>(context.map(buffer));
+    size_t copySize =
+        std::min((size_t)bufferSize, initData.size() * sizeof(uint32_t));
+    if (copySize)
+      memcpy(mapped, initData.data(), copySize);
+    memset(mapped + copySize, 0, bufferSize - copySize);
+    if (debug) {
+      std::cout << "  [DEBUG] CacheBench Buffer: " << (void *)mapped << " - "
+                << (void *)(mapped + bufferSize) << " ("
+                << (bufferSize / 1024 / 1024) << " MB)" << std::endl;
+    }
+    context.unmap(buffer);
+  } else if (bufferSize > 0) {
+    // Initialize on the device and upload only the pointer-chase data
+    buffer = context.createBuffer(bufferSize);
+    context.fillBuffer(buffer, 0, bufferSize, 0);
+    if (!initData.empty()) {
+      size_t copySize =
+          std::min((size_t)bufferSize, initData.size() * sizeof(uint32_t));
+      context.writeBuffer(buffer, 0, copySize, initData.data());
     }
-  }
-
-  std::filesystem::path kdir(kernel_dir);
-  std::filesystem::path full_kernel_path;
-
-  if (context.getBackend() == ComputeBackend::ROCm) {
-    full_kernel_path = kdir / "rocm" / (kernelFile + ".hip");
-  } else if (context.getBackend() == ComputeBackend::OpenCL) {
-    full_kernel_path = kdir / "opencl" / (kernelFile + ".cl");
-  } else { // Default to Vulkan
-    full_kernel_path = kdir / "vulkan" / (kernelFile + ".comp");
-  }
-
-  std::string kernel_name;
-  if (context.getBackend() == ComputeBackend::Vulkan) {
-    kernel_name = "main";
-  } else if (context.getBackend() == ComputeBackend::ROCm) {
-    kernel_name = "run_benchmark";
-  } else { // OpenCL
-    kernel_name = "run_benchmark";
   }
 
   // We now pass 3 push constants: stride, mask, iterations
-  kernel = context.createKernel(full_kernel_path.string(), kernel_name, 2);
+  KernelSource source = kernelSource(context.getBackend(), kernel_dir);
+  kernel = context.createKernel(source.file, source.name, source.numArgs);
   if (buffer) {
     context.setKernelArg(kernel, 0, buffer);
 
@@ -211,10 +194,10 @@ void CacheBench::Run(uint32_t config_idx) {
     throw std::runtime_error("Context is not set up");
   }
   if (metric == "GB/s") {
-    context->dispatch(kernel, numWorkgroups, 1, 1, 256, 1, 1);
+    submitDispatch(context, kernel, numWorkgroups, 1, 1, 256, 1, 1);
   } else {
     // For latency, we run a single thread to measure the dependency chain.
-    context->dispatch(kernel, 1, 1, 1, 1, 1, 1);
+    submitDispatch(context, kernel, 1, 1, 1, 1, 1, 1);
   }
 }
 
@@ -227,10 +210,6 @@ void CacheBench::Teardown() {
     context->releaseBuffer(buffer);
     buffer = nullptr;
   }
-  if (hostMem) {
-    ALIGNED_FREE(hostMem);
-    hostMem = nullptr;
-  }
 }
 
 const char *CacheBench::GetName() const { return name.c_str(); }
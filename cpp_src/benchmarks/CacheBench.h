@@ -19,12 +19,16 @@ public:
   bool IsSupported(const DeviceInfo &info,
                    IComputeContext *context) const override;
   void Setup(IComputeContext &context, const std::string &kernel_dir) override;
+  std::vector<KernelSource>
+  GetKernelSources(ComputeBackend backend, const DeviceInfo &info,
+                   const std::string &kernel_dir) const override;
   void Run(uint32_t config_idx = 0) override;
   void Teardown() override;
   BenchmarkResult GetResult(uint32_t config_idx = 0) const override;
   const char *GetComponent(uint32_t config_idx = 0) const override;
   const char *GetSubCategory(uint32_t config_idx = 0) const override;
   int GetSortWeight() const override;
+  bool SupportsBatching() const override { return true; }
 
 private:
   std::string name;
@@ -37,11 +41,13 @@ private:
   ComputeBuffer buffer = nullptr;
   ComputeBuffer pcBuffer = nullptr;
   std::vector<uint32_t> initData;
-  void *hostMem = nullptr;
   int targetCacheLevel = -1;
   uint32_t numWorkgroups = 1;
   bool debug = false;
 
+  KernelSource kernelSource(ComputeBackend backend,
+                            const std::string &kernel_dir) const;
+
 public:
   void setDebug(bool d) { debug = d; }
 };
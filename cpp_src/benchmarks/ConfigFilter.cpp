@@ -0,0 +1,107 @@
+#include "benchmarks/ConfigFilter.h"
+#include <algorithm>
+#include <cctype>
+#include <sstream>
+#include <stdexcept>
+
+static std::string to_lower(std::string s) {
+  std::transform(s.begin(), s.end(), s.begin(),
+                 [](unsigned char c) { return std::tolower(c); });
+  return s;
+}
+
+static std::string trim(const std::string &s) {
+  size_t begin = s.find_first_not_of(" \t");
+  if (begin == std::string::npos)
+    return "";
+  size_t end = s.find_last_not_of(" \t");
+  return s.substr(begin, end - begin + 1);
+}
+
+// Iterative glob match with single-star backtracking
+static bool glob_match(const std::string &pattern, const std::string &text) {
+  size_t p = 0, t = 0;
+  size_t star = std::string::npos, retry = 0;
+  while (t < text.size()) {
+    if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == text[t])) {
+      ++p;
+      ++t;
+    } else if (p < pattern.size() && pattern[p] == '*') {
+      star = p++;
+      retry = t;
+    } else if (star != std::string::npos) {
+      p = star + 1;
+      t = ++retry;
+    } else {
+      return false;
+    }
+  }
+  while (p < pattern.size() && pattern[p] == '*')
+    ++p;
+  return p == pattern.size();
+}
+
+ConfigFilter ConfigFilter::parse(const std::string &spec) {
+  ConfigFilter filter;
+  std::stringstream ss(spec);
+  std::string term;
+  while (std::getline(ss, term, ',')) {
+    term = trim(term);
+    if (term.empty())
+      throw std::runtime_error("Empty config selector in '" + spec + "'");
+    filter.all = false;
+    if (std::all_of(term.begin(), term.end(),
+                    [](unsigned char c) { return std::isdigit(c); })) {
+      filter.indices.push_back(static_cast<uint32_t>(std::stoul(term)));
+    } else {
+      filter.patterns.push_back(to_lower(term));
+    }
+  }
+  return filter;
+}
+
+bool ConfigFilter::matches(uint32_t config_idx,
+                           const std::string &config_name) const {
+  if (all)
+    return true;
+  if (std::find(indices.begin(), indices.end(), config_idx) != indices.end())
+    return true;
+  std::string name_lower = to_lower(config_name);
+  for (const auto &pattern : patterns) {
+    if (glob_match(pattern, name_lower))
+      return true;
+  }
+  return false;
+}
+
+void ConfigFilter::merge(const ConfigFilter &other) {
+  if (all || other.all) {
+    *this = ConfigFilter();
+    return;
+  }
+  indices.insert(indices.end(), other.indices.begin(), other.indices.end());
+  patterns.insert(patterns.end(), other.patterns.begin(),
+                  other.patterns.end());
+}
+
+uint32_t ConfigFilter::countUpperBound(uint32_t num_configs) const {
+  if (all || !patterns.empty())
+    return num_configs;
+  uint32_t count = 0;
+  for (uint32_t i = 0; i < num_configs; ++i) {
+    if (std::find(indices.begin(), indices.end(), i) != indices.end())
+      ++count;
+  }
+  return count;
+}
+
+std::string ConfigFilter::toString() const {
+  if (all)
+    return "*";
+  std::string out;
+  for (uint32_t idx : indices)
+    out += (out.empty() ? "" : ",") + std::to_string(idx);
+  for (const auto &pattern : patterns)
+    out += (out.empty() ? "" : ",") + pattern;
+  return out;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Restricts a benchmark to a subset of its configs, parsed from the part of a
+// -b entry after the colon: "membw:Read*", "raydiv:2,4". Each comma-separated
+// term is either a config index or a case-insensitive glob (* and ?) on the
+// config name. An empty filter selects every config.
+class ConfigFilter {
+public:
+  ConfigFilter() = default;
+  // Throws std::runtime_error on an empty term
+  static ConfigFilter parse(const std::string &spec);
+
+  bool empty() const { return all; }
+  bool matches(uint32_t config_idx, const std::string &config_name) const;
+
+  // Union of both selections (used when several -b entries name the same
+  // benchmark)
+  void merge(const ConfigFilter &other);
+
+  // Number of configs selected out of num_configs, if it can be known
+  // without the config names (i.e. the filter only has indices).
+  uint32_t countUpperBound(uint32_t num_configs) const;
+
+  std::string toString() const;
+
+private:
+  bool all = true;
+  std::vector<uint32_t> indices;
+  std::vector<std::string> patterns; // Lowercased
+};
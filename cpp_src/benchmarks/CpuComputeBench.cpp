@@ -0,0 +1,327 @@
+#include "benchmarks/CpuComputeBench.h"
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+// The SIMD kernels need GCC/Clang target attributes and x86 intrinsics;
+// elsewhere only the portable kernels are built.
+#if !defined(_MSC_VER) && (defined(__x86_64__) || defined(__i386__))
+#define CPU_COMPUTE_X86 1
+#include <immintrin.h>
+#endif
+
+// First compiler releases with the AVX512-FP16, AVX512-BF16 and AVX-VNNI
+// intrinsics
+#if defined(CPU_COMPUTE_X86) && defined(__clang__)
+#define HAVE_CPU_FP16 (__clang_major__ >= 14)
+#define HAVE_CPU_BF16 (__clang_major__ >= 9)
+#define HAVE_CPU_AVXVNNI (__clang_major__ >= 12)
+#elif defined(CPU_COMPUTE_X86)
+#define HAVE_CPU_FP16 (__GNUC__ >= 12)
+#define HAVE_CPU_BF16 (__GNUC__ >= 10)
+#define HAVE_CPU_AVXVNNI (__GNUC__ >= 11)
+#endif
+
+// Iterations of each kernel per thread, a few milliseconds at peak
+static constexpr uint64_t kIterations = 1 << 21;
+
+// Every accumulator goes through acc = acc * kMul + kAdd, which converges to
+// 1 instead of overflowing or going denormal.
+static constexpr float kMul = 0.999f;
+static constexpr float kAdd = 0.001f;
+
+// Portable kernels: 32 independent scalar chains the compiler vectorizes to
+// the baseline ISA
+template <typename T> static double portableFma(uint64_t iterations) {
+  constexpr int kChains = 32;
+  T acc[kChains];
+  for (int k = 0; k < kChains; ++k)
+    acc[k] = T(1) + T(k) * T(0.01);
+  for (uint64_t it = 0; it < iterations; ++it) {
+#pragma GCC unroll 32
+    for (int k = 0; k < kChains; ++k)
+      acc[k] = acc[k] * T(kMul) + T(kAdd);
+  }
+  T sum = 0;
+  for (int k = 0; k < kChains; ++k)
+    sum += acc[k];
+  return double(sum);
+}
+
+#ifdef CPU_COMPUTE_X86
+template <typename T, size_t N> static double laneSum(const T (&lanes)[N]) {
+  double sum = 0.0;
+  for (const T &lane : lanes)
+    sum += double(lane);
+  return sum;
+}
+
+// 24 of the 32 zmm registers hold accumulators, enough to cover FMA latency
+// times two FMA ports
+static constexpr int kAcc512 = 24;
+// 12 of the 16 ymm registers
+static constexpr int kAcc256 = 12;
+
+__attribute__((target("avx512f"))) static double fp64Avx512(uint64_t iterations) {
+  __m512d acc[kAcc512];
+  const __m512d m = _mm512_set1_pd(kMul), c = _mm512_set1_pd(kAdd);
+  for (int k = 0; k < kAcc512; ++k)
+    acc[k] = _mm512_set1_pd(1.0 + k * 0.01);
+  for (uint64_t it = 0; it < iterations; ++it) {
+#pragma GCC unroll 32
+    for (int k = 0; k < kAcc512; ++k)
+      acc[k] = _mm512_fmadd_pd(acc[k], m, c);
+  }
+  for (int k = 1; k < kAcc512; ++k)
+    acc[0] = _mm512_add_pd(acc[0], acc[k]);
+  double lanes[8];
+  _mm512_storeu_pd(lanes, acc[0]);
+  return laneSum(lanes);
+}
+
+__attribute__((target("avx2,fma"))) static double fp64Avx2(uint64_t iterations) {
+  __m256d acc[kAcc256];
+  const __m256d m = _mm256_set1_pd(kMul), c = _mm256_set1_pd(kAdd);
+  for (int k = 0; k < kAcc256; ++k)
+    acc[k] = _mm256_set1_pd(1.0 + k * 0.01);
+  for (uint64_t it = 0; it < iterations; ++it) {
+#pragma GCC unroll 32
+    for (int k = 0; k < kAcc256; ++k)
+      acc[k] = _mm256_fmadd_pd(acc[k], m, c);
+  }
+  for (int k = 1; k < kAcc256; ++k)
+    acc[0] = _mm256_add_pd(acc[0], acc[k]);
+  double lanes[4];
+  _mm256_storeu_pd(lanes, acc[0]);
+  return laneSum(lanes);
+}
+
+__attribute__((target("avx512f"))) static double fp32Avx512(uint64_t iterations) {
+  __m512 acc[kAcc512];
+  const __m512 m = _mm512_set1_ps(kMul), c = _mm512_set1_ps(kAdd);
+  for (int k = 0; k < kAcc512; ++k)
+    acc[k] = _mm512_set1_ps(1.0f + k * 0.01f);
+  for (uint64_t it = 0; it < iterations; ++it) {
+#pragma GCC unroll 32
+    for (int k = 0; k < kAcc512; ++k)
+      acc[k] = _mm512_fmadd_ps(acc[k], m, c);
+  }
+  for (int k = 1; k < kAcc512; ++k)
+    acc[0] = _mm512_add_ps(acc[0], acc[k]);
+  float lanes[16];
+  _mm512_storeu_ps(lanes, acc[0]);
+  return laneSum(lanes);
+}
+
+__attribute__((target("avx2,fma"))) static double fp32Avx2(uint64_t iterations) {
+  __m256 acc[kAcc256];
+  const __m256 m = _mm256_set1_ps(kMul), c = _mm256_set1_ps(kAdd);
+  for (int k = 0; k < kAcc256; ++k)
+    acc[k] = _mm256_set1_ps(1.0f + k * 0.01f);
+  for (uint64_t it = 0; it < iterations; ++it) {
+#pragma GCC unroll 32
+    for (int k = 0; k < kAcc256; ++k)
+      acc[k] = _mm256_fmadd_ps(acc[k], m, c);
+  }
+  for (int k = 1; k < kAcc256; ++k)
+    acc[0] = _mm256_add_ps(acc[0], acc[k]);
+  float lanes[8];
+  _mm256_storeu_ps(lanes, acc[0]);
+  return laneSum(lanes);
+}
+
+#if HAVE_CPU_FP16
+__attribute__((target("avx512fp16"))) static double fp16Avx512(uint64_t iterations) {
+  __m512h acc[kAcc512];
+  const __m512h m = _mm512_set1_ph((_Float16)kMul);
+  const __m512h c = _mm512_set1_ph((_Float16)kAdd);
+  for (int k = 0; k < kAcc512; ++k)
+    acc[k] = _mm512_set1_ph((_Float16)(1.0f + k * 0.01f));
+  for (uint64_t it = 0; it < iterations; ++it) {
+#pragma GCC unroll 32
+    for (int k = 0; k < kAcc512; ++k)
+      acc[k] = _mm512_fmadd_ph(acc[k], m, c);
+  }
+  for (int k = 1; k < kAcc512; ++k)
+    acc[0] = _mm512_add_ph(acc[0], acc[k]);
+  _Float16 lanes[32];
+  _mm512_storeu_ph(lanes, acc[0]);
+  return laneSum(lanes);
+}
+#endif
+
+#if HAVE_CPU_BF16
+// Each dpbf16 multiplies 2 BF16 pairs per FP32 lane and adds both products
+// into the lane. b holds 1, -1 in every lane, so the two products cancel
+// and the accumulators keep their value.
+__attribute__((target("avx512f,avx512bf16"))) static double
+bf16Avx512(uint64_t iterations) {
+  __m512 acc[kAcc512];
+  const __m512bh a = _mm512_cvtne2ps_pbh(_mm512_set1_ps(kAdd),
+                                         _mm512_set1_ps(kAdd));
+  // BF16 bit patterns of 1.0 (low half) and -1.0 (high half)
+  const __m512bh b = (__m512bh)_mm512_set1_epi32(0xBF803F80);
+  for (int k = 0; k < kAcc512; ++k)
+    acc[k] = _mm512_set1_ps(1.0f + k * 0.01f);
+  for (uint64_t it = 0; it < iterations; ++it) {
+#pragma GCC unroll 32
+    for (int k = 0; k < kAcc512; ++k)
+      acc[k] = _mm512_dpbf16_ps(acc[k], a, b);
+  }
+  for (int k = 1; k < kAcc512; ++k)
+    acc[0] = _mm512_add_ps(acc[0], acc[k]);
+  float lanes[16];
+  _mm512_storeu_ps(lanes, acc[0]);
+  return laneSum(lanes);
+}
+#endif
+
+// Each dpbusd multiplies 4 u8 x s8 pairs per 32-bit lane and adds them into
+// the lane. The products of the constant operands cancel, so the
+// accumulators never overflow.
+__attribute__((target("avx512f,avx512vnni"))) static double
+int8Avx512Vnni(uint64_t iterations) {
+  __m512i acc[kAcc512];
+  const __m512i a = _mm512_set1_epi8(3);
+  const __m512i b = _mm512_set1_epi32(0x01FF01FF); // 1, -1, 1, -1
+  for (int k = 0; k < kAcc512; ++k)
+    acc[k] = _mm512_set1_epi32(k);
+  for (uint64_t it = 0; it < iterations; ++it) {
+#pragma GCC unroll 32
+    for (int k = 0; k < kAcc512; ++k)
+      acc[k] = _mm512_dpbusd_epi32(acc[k], a, b);
+  }
+  for (int k = 1; k < kAcc512; ++k)
+    acc[0] = _mm512_add_epi32(acc[0], acc[k]);
+  int32_t lanes[16];
+  _mm512_storeu_si512(lanes, acc[0]);
+  return laneSum(lanes);
+}
+
+#if HAVE_CPU_AVXVNNI
+__attribute__((target("avx2,avxvnni"))) static double
+int8AvxVnni(uint64_t iterations) {
+  __m256i acc[kAcc256];
+  const __m256i a = _mm256_set1_epi8(3);
+  const __m256i b = _mm256_set1_epi32(0x01FF01FF);
+  for (int k = 0; k < kAcc256; ++k)
+    acc[k] = _mm256_set1_epi32(k);
+  for (uint64_t it = 0; it < iterations; ++it) {
+#pragma GCC unroll 32
+    for (int k = 0; k < kAcc256; ++k)
+      acc[k] = _mm256_dpbusd_avx_epi32(acc[k], a, b);
+  }
+  for (int k = 1; k < kAcc256; ++k)
+    acc[0] = _mm256_add_epi32(acc[0], acc[k]);
+  int32_t lanes[8];
+  _mm256_storeu_si256(reinterpret_cast<__m256i *>(lanes), acc[0]);
+  return laneSum(lanes);
+}
+#endif
+
+static bool cpuSupports512() {
+  return __builtin_cpu_supports("avx512f");
+}
+static bool cpuSupportsFma256() {
+  return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+}
+#endif
+
+CpuComputeBench::CpuComputeBench() {
+  // ops per iteration = accumulators * lanes * 2 (multiply and add)
+#ifdef CPU_COMPUTE_X86
+  if (cpuSupports512()) {
+    configs.push_back({"FP64 (AVX-512)", "FP64", "TFLOPS",
+                       kAcc512 * 8 * 2, fp64Avx512});
+    configs.push_back({"FP32 (AVX-512)", "FP32", "TFLOPS",
+                       kAcc512 * 16 * 2, fp32Avx512});
+  } else if (cpuSupportsFma256()) {
+    configs.push_back({"FP64 (AVX2)", "FP64", "TFLOPS", kAcc256 * 4 * 2,
+                       fp64Avx2});
+    configs.push_back({"FP32 (AVX2)", "FP32", "TFLOPS", kAcc256 * 8 * 2,
+                       fp32Avx2});
+  } else
+#endif
+  {
+    configs.push_back({"FP64", "FP64", "TFLOPS", 32 * 2, portableFma<double>});
+    configs.push_back({"FP32", "FP32", "TFLOPS", 32 * 2, portableFma<float>});
+  }
+
+#ifdef CPU_COMPUTE_X86
+#if HAVE_CPU_FP16
+  if (__builtin_cpu_supports("avx512fp16")) {
+    configs.push_back({"FP16 (AVX512-FP16)", "FP16", "TFLOPS",
+                       kAcc512 * 32 * 2, fp16Avx512});
+  }
+#endif
+#if HAVE_CPU_BF16
+  if (__builtin_cpu_supports("avx512bf16")) {
+    configs.push_back({"BF16 (AVX512-BF16)", "BF16", "TFLOPS",
+                       kAcc512 * 32 * 2, bf16Avx512});
+  }
+#endif
+  if (__builtin_cpu_supports("avx512vnni")) {
+    configs.push_back({"INT8 (AVX512-VNNI)", "INT8", "TOPS", kAcc512 * 64 * 2,
+                       int8Avx512Vnni});
+  }
+#if HAVE_CPU_AVXVNNI
+  else if (__builtin_cpu_supports("avxvnni")) {
+    configs.push_back({"INT8 (AVX-VNNI)", "INT8", "TOPS", kAcc256 * 32 * 2,
+                       int8AvxVnni});
+  }
+#endif
+#endif
+}
+
+const char *CpuComputeBench::GetMetric(uint32_t config_idx) const {
+  return config_idx < configs.size() ? configs[config_idx].metric : "TFLOPS";
+}
+
+const char *CpuComputeBench::GetSubCategory(uint32_t config_idx) const {
+  return config_idx < configs.size() ? configs[config_idx].subCategory : "";
+}
+
+std::string CpuComputeBench::GetConfigName(uint32_t config_idx) const {
+  return config_idx < configs.size() ? configs[config_idx].name : "Unknown";
+}
+
+void CpuComputeBench::Setup(IComputeContext &context,
+                            const std::string &kernel_dir) {
+  // Workers persist across Run() calls, so thread creation is never timed
+  pool = std::make_unique<utils::PinnedThreadPool>();
+}
+
+void CpuComputeBench::Run(uint32_t config_idx) {
+  if (config_idx >= configs.size() || !pool)
+    return;
+  const CpuComputeConfig &config = configs[config_idx];
+
+  unsigned numThreads = pool->size();
+  using Clock = std::chrono::steady_clock;
+  std::vector<Clock::time_point> starts(numThreads), ends(numThreads);
+  std::vector<double> sinks(numThreads, 0.0);
+
+  pool->run(numThreads, [&](unsigned tid) {
+    starts[tid] = Clock::now();
+    sinks[tid] = config.kernel(kIterations);
+    ends[tid] = Clock::now();
+  });
+
+  // Aggregate throughput over the window in which any thread was computing
+  Clock::time_point first = *std::min_element(starts.begin(), starts.end());
+  Clock::time_point last = *std::max_element(ends.begin(), ends.end());
+  lastRunTimeMs =
+      std::chrono::duration<double, std::milli>(last - first).count();
+  lastRunOps = kIterations * config.opsPerIteration * numThreads;
+
+  double total = 0.0;
+  for (double s : sinks)
+    total += s;
+  sink = total;
+}
+
+void CpuComputeBench::Teardown() { pool.reset(); }
+
+BenchmarkResult CpuComputeBench::GetResult(uint32_t config_idx) const {
+  return {lastRunOps, lastRunTimeMs};
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "benchmarks/IBenchmark.h"
+#include "utils/PinnedThreadPool.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+// Per-thread work of one CpuComputeBench config
+struct CpuComputeConfig {
+  std::string name;
+  const char *subCategory;
+  const char *metric;
+  uint64_t opsPerIteration;
+  double (*kernel)(uint64_t iterations); // Returns a sink value
+};
+
+// Peak arithmetic throughput of the host CPU, the counterpart of the GPU
+// precision benchmarks: every hardware thread runs independent FMA (or dot
+// product) chains in as many accumulators as the ISA has registers for.
+// Each config uses the widest instruction set the CPU reports; FP16, BF16
+// and INT8 configs only exist where the CPU has AVX512-FP16, AVX512-BF16 or
+// AVX-VNNI / AVX512-VNNI.
+class CpuComputeBench : public IBenchmark {
+public:
+  CpuComputeBench();
+
+  const char *GetName() const override { return "CPU Compute"; }
+  std::vector<std::string> GetAliases() const override {
+    return {"cpu", "cpu_compute"};
+  }
+  const char *GetMetric() const override { return "TFLOPS"; }
+  const char *GetMetric(uint32_t config_idx) const override;
+  bool IsSupported(const DeviceInfo &info,
+                   IComputeContext *context = nullptr) const override {
+    return true;
+  }
+
+  void Setup(IComputeContext &context, const std::string &kernel_dir) override;
+  void Run(uint32_t config_idx = 0) override;
+  void Teardown() override;
+  BenchmarkResult GetResult(uint32_t config_idx = 0) const override;
+  // Run() times only the kernels, from the first thread's start to the last
+  // thread's end
+  double GetDeviceTimeMs(uint32_t config_idx) const override {
+    return lastRunTimeMs;
+  }
+  const char *GetComponent(uint32_t config_idx = 0) const override {
+    return "Compute";
+  }
+  const char *GetSubCategory(uint32_t config_idx = 0) const override;
+  int GetSortWeight() const override { return 350; }
+  uint32_t GetNumConfigs() const override {
+    return static_cast<uint32_t>(configs.size());
+  }
+  std::string GetConfigName(uint32_t config_idx) const override;
+
+  // System benchmark is not tied to a specific GPU
+  bool IsDeviceDependent() const override { return false; }
+
+private:
+  std::vector<CpuComputeConfig> configs;
+  // One pinned worker per hardware thread
+  std::unique_ptr<utils::PinnedThreadPool> pool;
+
+  double lastRunTimeMs = 0.0;
+  uint64_t lastRunOps = 0;
+  volatile double sink = 0.0;
+};
@@ -7,8 +7,42 @@ bool Fp16Bench::IsSupported(const DeviceInfo &info,
   return info.fp16Support;
 }
 
+KernelSource Fp16Bench::kernelSource(bool matrix, ComputeBackend backend,
+                                     const DeviceInfo &info,
+                                     const std::string &kernel_dir) const {
+  std::filesystem::path kdir(kernel_dir);
+  if (backend == ComputeBackend::ROCm) {
+    if (!matrix)
+      return {(kdir / "rocm" / "fp16.hip").string(), "run_benchmark", 1};
+    // Matrix WMMA is disabled on ROCm due to 7.1.1 backend crash for RDNA4.
+    // RDNA3 (gfx11) is fine.
+    if (info.name.find("gfx11") != std::string::npos)
+      return {(kdir / "rocm" / "fp16_matrix.hip").string(), "run_benchmark",
+              1};
+    return {};
+  }
+  if (backend == ComputeBackend::OpenCL) {
+    if (!matrix)
+      return {(kdir / "opencl" / "fp16.cl").string(), "run_benchmark", 1};
+    return {};
+  }
+  if (!matrix)
+    return {(kdir / "vulkan" / "fp16.comp").string(), "main", 1};
+  if (info.cooperativeMatrixSupport)
+    return {(kdir / "vulkan" / "coop_matrix_fp16.comp").string(), "main", 1};
+  return {};
+}
+
 void Fp16Bench::Setup(IComputeContext &context, const std::string &kernel_dir) {
   this->context = &context;
+  const DeviceInfo &info = context.getCurrentDeviceInfo();
+
+  // Skip the kernels of configs the filter excludes, and the buffer too if
+  // nothing is selected
+  bool wantVector = configFilter.matches(0, GetConfigName(0));
+  bool wantMatrix = configFilter.matches(1, GetConfigName(1));
+  if (!wantVector && !wantMatrix)
+    return;
 
   // Create storage buffer
   size_t bufferSize =
@@ -16,44 +50,24 @@ void Fp16Bench::Setup(IComputeContext &context, const std::string &kernel_dir) {
   buffer = context.createBuffer(bufferSize);
 
   // Initialize buffer
-  std::vector<uint32_t> initData(bufferSize / sizeof(uint32_t), 0);
-  context.writeBuffer(buffer, 0, bufferSize, initData.data());
+  context.fillBuffer(buffer, 0, bufferSize, 0);
 
   // Load Vector Kernel
-  std::filesystem::path kdir(kernel_dir);
-  std::filesystem::path vector_file;
-  std::filesystem::path matrix_file;
-
-  if (context.getBackend() == ComputeBackend::ROCm) {
-    vector_file = kdir / "rocm" / "fp16.hip";
-    matrix_file = kdir / "rocm" / "fp16_matrix.hip";
-  } else if (context.getBackend() == ComputeBackend::OpenCL) {
-    vector_file = kdir / "opencl" / "fp16.cl";
-  } else {
-    vector_file = kdir / "vulkan" / "fp16.comp";
-    matrix_file = kdir / "vulkan" / "coop_matrix_fp16.comp";
+  if (wantVector) {
+    KernelSource vector =
+        kernelSource(false, context.getBackend(), info, kernel_dir);
+    vectorKernel =
+        context.createKernel(vector.file, vector.name, vector.numArgs);
+    context.setKernelArg(vectorKernel, 0, buffer);
   }
 
-  std::string vector_kernel_name = (context.getBackend() == ComputeBackend::Vulkan) ? "main" : "run_benchmark";
-  vectorKernel = context.createKernel(vector_file.string(), vector_kernel_name, 1);
-  context.setKernelArg(vectorKernel, 0, buffer);
-
   // Optionally load Matrix Kernel if supported
-  bool try_load_matrix = false;
-  if (context.getBackend() == ComputeBackend::Vulkan && context.getCurrentDeviceInfo().cooperativeMatrixSupport) {
-      try_load_matrix = true;
-  } else if (context.getBackend() == ComputeBackend::ROCm) {
-      // Matrix WMMA is disabled on ROCm due to 7.1.1 backend crash for RDNA4.
-      // If we are on RDNA3 (gfx1100), we could enable it, but for now we skip.
-      if (context.getCurrentDeviceInfo().name.find("gfx11") != std::string::npos) {
-          try_load_matrix = true;
-      }
-  }
-
-  if (try_load_matrix) {
+  KernelSource matrix =
+      kernelSource(true, context.getBackend(), info, kernel_dir);
+  if (wantMatrix && !matrix.file.empty()) {
     try {
-      std::string func_name = (context.getBackend() == ComputeBackend::ROCm) ? "run_benchmark" : "main";
-      matrixKernel = context.createKernel(matrix_file.string(), func_name, 1);
+      matrixKernel =
+          context.createKernel(matrix.file, matrix.name, matrix.numArgs);
       if (matrixKernel) {
           context.setKernelArg(matrixKernel, 0, buffer);
       }
@@ -63,12 +77,33 @@ void Fp16Bench::Setup(IComputeContext &context, const std::string &kernel_dir) {
   }
 }
 
+std::vector<KernelSource>
+Fp16Bench::GetKernelSources(ComputeBackend backend, const DeviceInfo &info,
+                            const std::string &kernel_dir) const {
+  std::vector<KernelSource> sources;
+  for (bool matrix : {false, true}) {
+    KernelSource source = kernelSource(matrix, backend, info, kernel_dir);
+    if (!source.file.empty() &&
+        configFilter.matches(matrix ? 1 : 0, GetConfigName(matrix ? 1 : 0)))
+      sources.push_back(source);
+  }
+  return sources;
+}
+
+uint32_t
+Fp16Bench::GetExpectedKernelCount(ComputeBackend backend,
+                                  const DeviceInfo &info,
+                                  const std::string &kernel_dir) const {
+  return (configFilter.matches(0, GetConfigName(0)) ? 1 : 0) +
+         (configFilter.matches(1, GetConfigName(1)) ? 1 : 0);
+}
+
 void Fp16Bench::Run(uint32_t config_idx) {
   if (config_idx == 0) {
-    context->dispatch(vectorKernel, 8192, 1, 1, 64, 1, 1);
+    submitDispatch(context, vectorKernel, 8192, 1, 1, 64, 1, 1);
   } else if (matrixKernel) {
     // 65536 WGs of 32 threads each — double dispatch to saturate tensor units
-    context->dispatch(matrixKernel, 65536, 1, 1, 32, 1, 1);
+    submitDispatch(context, matrixKernel, 65536, 1, 1, 32, 1, 1);
   }
 }
 
@@ -13,6 +13,9 @@ public:
   bool IsSupported(const DeviceInfo &info,
                    IComputeContext *context = nullptr) const override;
   void Setup(IComputeContext &context, const std::string &kernel_dir) override;
+  std::vector<KernelSource>
+  GetKernelSources(ComputeBackend backend, const DeviceInfo &info,
+                   const std::string &kernel_dir) const override;
   void Run(uint32_t config_idx = 0) override;
   void Teardown() override;
   BenchmarkResult GetResult(uint32_t config_idx = 0) const override;
@@ -23,8 +26,11 @@ public:
     return "FP16";
   }
   int GetSortWeight() const override { return 30; }
+  bool SupportsBatching() const override { return true; }
   uint32_t GetNumConfigs() const override;
-  virtual uint32_t GetExpectedKernelCount() const override { return 2; }
+  uint32_t GetExpectedKernelCount(ComputeBackend backend,
+                                  const DeviceInfo &info,
+                                  const std::string &kernel_dir) const override;
   std::string GetConfigName(uint32_t config_idx) const override;
 
 private:
@@ -32,4 +38,10 @@ private:
   ComputeKernel vectorKernel = nullptr;
   ComputeKernel matrixKernel = nullptr;
   ComputeBuffer buffer = nullptr;
+
+  // The vector or matrix kernel for this backend and device, with an empty
+  // file if there is none. Setup() creates these, GetKernelSources() lists them.
+  KernelSource kernelSource(bool matrix, ComputeBackend backend,
+                            const DeviceInfo &info,
+                            const std::string &kernel_dir) const;
 };
@@ -1,4 +1,5 @@
 #include "benchmarks/Fp32Bench.h"
+#include "core/HostContext.h"
 #include <filesystem>
 #include <iostream>
 #include <stdexcept>
@@ -9,6 +10,16 @@ bool Fp32Bench::IsSupported(const DeviceInfo &info,
   return true;
 }
 
+KernelSource Fp32Bench::kernelSource(ComputeBackend backend,
+                                     const std::string &kernel_dir) const {
+  std::filesystem::path kdir(kernel_dir);
+  if (backend == ComputeBackend::ROCm)
+    return {(kdir / "rocm" / "fp32.hip").string(), "run_benchmark", 1};
+  if (backend == ComputeBackend::OpenCL)
+    return {(kdir / "opencl" / "fp32.cl").string(), "run_benchmark", 1};
+  return {(kdir / "vulkan" / "fp32.comp").string(), "main", 1};
+}
+
 void Fp32Bench::Setup(IComputeContext &context, const std::string &kernel_dir) {
   this->context = &context;
 
@@ -17,29 +28,17 @@ void Fp32Bench::Setup(IComputeContext &context, const std::string &kernel_dir) {
   size_t bufferSize = numElements * sizeof(float);
   buffer = context.createBuffer(bufferSize);
 
-  // Create kernel
-  std::filesystem::path kdir(kernel_dir);
-  std::filesystem::path kernel_file;
-
-  if (context.getBackend() == ComputeBackend::ROCm) {
-    kernel_file = kdir / "rocm" / "fp32.hip";
-  } else if (context.getBackend() == ComputeBackend::OpenCL) {
-    kernel_file = kdir / "opencl" / "fp32.cl";
-  } else { // Vulkan
-    kernel_file = kdir / "vulkan" / "fp32.comp";
-  }
-
-  std::string kernel_name;
-  if (context.getBackend() == ComputeBackend::Vulkan) {
-    kernel_name = "main";
-  } else if (context.getBackend() == ComputeBackend::ROCm ||
-             context.getBackend() == ComputeBackend::OpenCL) {
-    kernel_name = "run_benchmark";
-  }
-  kernel = context.createKernel(kernel_file.string(), kernel_name, 1);
+  KernelSource source = kernelSource(context.getBackend(), kernel_dir);
+  kernel = context.createKernel(source.file, source.name, source.numArgs);
   context.setKernelArg(kernel, 0, buffer);
 }
 
+std::vector<KernelSource>
+Fp32Bench::GetKernelSources(ComputeBackend backend, const DeviceInfo &info,
+                            const std::string &kernel_dir) const {
+  return {kernelSource(backend, kernel_dir)};
+}
+
 void Fp32Bench::Run(uint32_t config_idx) {
   // Pass multiplier as push constant / arg 1
   float multiplier = 1.0001f;
@@ -49,7 +48,7 @@ void Fp32Bench::Run(uint32_t config_idx) {
   context->setKernelArg(kernel, 2, sizeof(uint32_t), &numElements);
 
   // Increase to 8192 workgroups for better GPU saturation
-  context->dispatch(kernel, 8192, 1, 1, 64, 1, 1);
+  submitDispatch(context, kernel, 8192, 1, 1, 64, 1, 1);
 }
 
 void Fp32Bench::Teardown() {
@@ -65,11 +64,14 @@ void Fp32Bench::Teardown() {
 
 BenchmarkResult Fp32Bench::GetResult(uint32_t config_idx) const {
   // 32 vec4 FMAs per iteration = 32 * 4 * 2 = 256 FP32 operations per iteration
-  // Vulkan: 16384 iters. OpenCL: 16384 iters. ROCm: 512 iters.
+  // Vulkan: 16384 iters. OpenCL: 16384 iters. ROCm: 512 iters. Host: see
+  // HostContext::kFp32Iterations.
   uint64_t iters = 16384; // Vulkan/OpenCL default
   if (context) {
     if (context->getBackend() == ComputeBackend::ROCm) {
       iters = 512;
+    } else if (context->getBackend() == ComputeBackend::Host) {
+      iters = HostContext::kFp32Iterations;
     }
   }
   uint64_t num_ops = iters * 256 * 8192 * 64;
@@ -13,6 +13,9 @@ public:
   bool IsSupported(const DeviceInfo &info,
                    IComputeContext *context = nullptr) const override;
   void Setup(IComputeContext &context, const std::string &kernel_dir) override;
+  std::vector<KernelSource>
+  GetKernelSources(ComputeBackend backend, const DeviceInfo &info,
+                   const std::string &kernel_dir) const override;
   void Run(uint32_t config_idx = 0) override;
   void Teardown() override;
   BenchmarkResult GetResult(uint32_t config_idx = 0) const override;
@@ -23,10 +26,14 @@ public:
     return "FP32";
   }
   int GetSortWeight() const override { return 20; }
+  bool SupportsBatching() const override { return true; }
 
 private:
   IComputeContext *context = nullptr;
   ComputeKernel kernel = nullptr;
   ComputeBuffer buffer = nullptr;
   uint32_t numElements = 0;
+
+  KernelSource kernelSource(ComputeBackend backend,
+                            const std::string &kernel_dir) const;
 };
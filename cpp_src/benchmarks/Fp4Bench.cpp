@@ -18,7 +18,7 @@ void Fp4Bench::Setup(IComputeContext &context, const std::string &kernel_dir) {
 
 void Fp4Bench::Run(uint32_t config_idx) {
   if (kernel) {
-    context->dispatch(kernel, 8192, 1, 1, 64, 1, 1);
+    submitDispatch(context, kernel, 8192, 1, 1, 64, 1, 1);
   }
 }
 
@@ -1,4 +1,5 @@
 #include "benchmarks/Fp64Bench.h"
+#include "core/HostContext.h"
 #include <filesystem>
 #include <iostream>
 #include <stdexcept>
@@ -9,6 +10,16 @@ bool Fp64Bench::IsSupported(const DeviceInfo &info,
   return info.fp64Support;
 }
 
+KernelSource Fp64Bench::kernelSource(ComputeBackend backend,
+                                     const std::string &kernel_dir) const {
+  std::filesystem::path kdir(kernel_dir);
+  if (backend == ComputeBackend::ROCm)
+    return {(kdir / "rocm" / "fp64.hip").string(), "run_benchmark", 1};
+  if (backend == ComputeBackend::OpenCL)
+    return {(kdir / "opencl" / "fp64.cl").string(), "run_benchmark", 1};
+  return {(kdir / "vulkan" / "fp64.comp").string(), "main", 1};
+}
+
 void Fp64Bench::Setup(IComputeContext &context, const std::string &kernel_dir) {
   this->context = &context;
 
@@ -18,30 +29,21 @@ void Fp64Bench::Setup(IComputeContext &context, const std::string &kernel_dir) {
   buffer = context.createBuffer(bufferSize);
 
   // Initialize buffer
-  std::vector<double> initData(bufferSize / sizeof(double), 0.0);
-  context.writeBuffer(buffer, 0, bufferSize, initData.data());
-
-  // Create kernel
-  std::filesystem::path kdir(kernel_dir);
-  std::filesystem::path kernel_file_path;
-  std::string kernel_name;
+  context.fillBuffer(buffer, 0, bufferSize, 0);
 
-  if (context.getBackend() == ComputeBackend::ROCm) {
-    kernel_file_path = kdir / "rocm" / "fp64.hip";
-    kernel_name = "run_benchmark";
-  } else if (context.getBackend() == ComputeBackend::OpenCL) {
-    kernel_file_path = kdir / "opencl" / "fp64.cl";
-    kernel_name = "run_benchmark";
-  } else { // Default to Vulkan
-    kernel_file_path = kdir / "vulkan" / "fp64.comp";
-    kernel_name = "main";
-  }
-  kernel = context.createKernel(kernel_file_path.string(), kernel_name, 1);
+  KernelSource source = kernelSource(context.getBackend(), kernel_dir);
+  kernel = context.createKernel(source.file, source.name, source.numArgs);
   context.setKernelArg(kernel, 0, buffer);
 }
 
+std::vector<KernelSource>
+Fp64Bench::GetKernelSources(ComputeBackend backend, const DeviceInfo &info,
+                            const std::string &kernel_dir) const {
+  return {kernelSource(backend, kernel_dir)};
+}
+
 void Fp64Bench::Run(uint32_t config_idx) {
-  context->dispatch(kernel, 4096, 1, 1, 64, 1, 1);
+  submitDispatch(context, kernel, 4096, 1, 1, 64, 1, 1);
 }
 
 void Fp64Bench::Teardown() {
@@ -58,10 +60,13 @@ void Fp64Bench::Teardown() {
 BenchmarkResult Fp64Bench::GetResult(uint32_t config_idx) const {
   // 2 operations per loop iteration (FMA).
   // ROCm kernel loop reduced from 65536 → 2048 to avoid TDR timeout;
-  // Vulkan and OpenCL kernels still use 65536 iterations.
+  // Vulkan and OpenCL kernels still use 65536 iterations; the Host kernel
+  // runs HostContext::kFp64Iterations.
   uint64_t iters = 65536;
   if (context && context->getBackend() == ComputeBackend::ROCm) {
     iters = 2048;
+  } else if (context && context->getBackend() == ComputeBackend::Host) {
+    iters = HostContext::kFp64Iterations;
   }
   uint64_t num_threads = 4096 * 64;
   uint64_t num_ops = iters * 2 * num_threads;
@@ -13,6 +13,9 @@ public:
   bool IsSupported(const DeviceInfo &info,
                    IComputeContext *context = nullptr) const override;
   void Setup(IComputeContext &context, const std::string &kernel_dir) override;
+  std::vector<KernelSource>
+  GetKernelSources(ComputeBackend backend, const DeviceInfo &info,
+                   const std::string &kernel_dir) const override;
   void Run(uint32_t config_idx = 0) override;
   void Teardown() override;
   BenchmarkResult GetResult(uint32_t config_idx = 0) const override;
@@ -23,9 +26,13 @@ public:
     return "FP64";
   }
   int GetSortWeight() const override { return 10; }
+  bool SupportsBatching() const override { return true; }
 
 private:
   IComputeContext *context = nullptr;
   ComputeKernel kernel = nullptr;
   ComputeBuffer buffer = nullptr;
+
+  KernelSource kernelSource(ComputeBackend backend,
+                            const std::string &kernel_dir) const;
 };
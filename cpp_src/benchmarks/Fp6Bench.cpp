@@ -9,7 +9,7 @@ bool Fp6Bench::IsSupported(const DeviceInfo &info,
 void Fp6Bench::Setup(IComputeContext &context, const std::string &build_dir) {
   this->context = &context;
 
-  DeviceInfo info = context.getCurrentDeviceInfo();
+  const DeviceInfo &info = context.getCurrentDeviceInfo();
   // The logic for emulation based on device name is removed as per the
   // instruction's implied change.
 
@@ -6,28 +6,34 @@
 
 bool Fp8Bench::IsSupported(const DeviceInfo &info,
                            IComputeContext *context) const {
+  // The Host backend has no FP8 kernels
+  if (context && context->getBackend() == ComputeBackend::Host)
+    return false;
   return true; // Supported on all backends via emulated vector paths if native is absent.
 }
 
+KernelSource Fp8Bench::kernelSource(bool matrix, ComputeBackend backend,
+                                    const DeviceInfo &info,
+                                    const std::string &kernel_dir) const {
+  // ROCm and OpenCL FP8 are completely emulated, so only Vulkan has kernels,
+  // and only for the native paths
+  if (backend != ComputeBackend::Vulkan)
+    return {};
+  std::filesystem::path kdir(kernel_dir);
+  if (!matrix) {
+    if (info.fp8Support) // VK_EXT_shader_float8
+      return {(kdir / "vulkan" / "fp8_emulated.comp").string(), "main", 1};
+    return {};
+  }
+  if (info.cooperativeMatrixSupport)
+    return {(kdir / "vulkan" / "coop_matrix_fp8.comp").string(), "main", 1};
+  return {};
+}
+
 void Fp8Bench::Setup(IComputeContext &context, const std::string &kernel_dir) {
   this->context = &context;
 
-  DeviceInfo info = context.getCurrentDeviceInfo();
-
-  // Detect hardware with native FP8 support:
-  // - MI300 (gfx942) and RDNA4 (gfx12) have native FP8 vector/matrix
-  // - RDNA3 (gfx11) does NOT have native FP8
-  // For Vulkan, the VK_EXT_shader_float8 extension indicates native support.
-  bool has_native_fp8 = info.fp8Support; // This checks VK_EXT_shader_float8
-
-  // Create storage buffer
-  size_t bufferSize =
-      8192 * 64 * 4; // 8192 workgroups * 64 threads * 4 bytes (u8vec4)
-  if (context.getBackend() == ComputeBackend::OpenCL) {
-    // The OpenCL kernel uses half4, which is 8 bytes per thread
-    bufferSize = 8192 * 64 * 8;
-  }
-  buffer = context.createBuffer(bufferSize);
+  const DeviceInfo &info = context.getCurrentDeviceInfo();
 
   // Helper to check if file exists
   auto file_exists = [](const std::string &path) {
@@ -35,8 +41,6 @@ void Fp8Bench::Setup(IComputeContext &context, const std::string &kernel_dir) {
     return f.good();
   };
 
-  std::filesystem::path kdir(kernel_dir);
-
   if (context.getBackend() == ComputeBackend::ROCm) {
     // ROCm FP8 is completely emulated on the current compiler stack.
     // Skip to prevent inaccurate benchmark results.
@@ -53,64 +57,89 @@ void Fp8Bench::Setup(IComputeContext &context, const std::string &kernel_dir) {
     return;
   }
 
-  if (context.getBackend() == ComputeBackend::OpenCL) {
-    std::filesystem::path kernel_file = kdir / "opencl" / "fp8.cl";
-    vectorKernel = context.createKernel(kernel_file.string(), "run_benchmark", 1);
-    context.setKernelArg(vectorKernel, 0, buffer);
-    is_native_vector = true;
-    is_emulated_vector = false;
-    is_native_matrix = false;
-    return;
-  }
-
   // Vulkan Path
-  std::filesystem::path vector_file = kdir / "vulkan" / "fp8_emulated.comp";
-
+  // Detect hardware with native FP8 support:
+  // - MI300 (gfx942) and RDNA4 (gfx12) have native FP8 vector/matrix
+  // - RDNA3 (gfx11) does NOT have native FP8
   // Only load the kernel if the hardware supports it natively.
   // We completely bypass emulation fallbacks.
-  if (has_native_fp8) {
-    is_native_vector = true;
-    is_emulated_vector = false;
+  KernelSource vector =
+      kernelSource(false, context.getBackend(), info, kernel_dir);
+  KernelSource matrix =
+      kernelSource(true, context.getBackend(), info, kernel_dir);
+  is_native_vector = !vector.file.empty();
+  is_emulated_vector = false;
+  is_native_matrix = false;
+
+  // The vector config keeps index 0 when the filter excludes it, so matrix
+  // indices don't depend on the filter. Skip the kernels of excluded configs,
+  // and the buffer too if nothing is selected.
+  hasVector = is_native_vector && file_exists(vector.file);
+  bool wantVector = hasVector && configFilter.matches(0, GetConfigName(0));
+  bool wantMatrix = !matrix.file.empty() && file_exists(matrix.file) &&
+                    configFilter.matches(hasVector ? 1 : 0, "Matrix");
+  if (!wantVector && !wantMatrix)
+    return;
+
+  // Create storage buffer
+  size_t bufferSize =
+      8192 * 64 * 4; // 8192 workgroups * 64 threads * 4 bytes (u8vec4)
+  buffer = context.createBuffer(bufferSize);
 
-    if (file_exists(vector_file.string())) {
-      try {
-        vectorKernel = context.createKernel(vector_file.string(), "main", 1);
-        context.setKernelArg(vectorKernel, 0, buffer);
-      } catch (const std::exception &e) {
-        std::cerr << "Native FP8 vector shader compilation failed: " << e.what() << std::endl;
-        vectorKernel = nullptr;
-        is_native_vector = false;
-      }
+  if (wantVector) {
+    try {
+      vectorKernel =
+          context.createKernel(vector.file, vector.name, vector.numArgs);
+      context.setKernelArg(vectorKernel, 0, buffer);
+    } catch (const std::exception &e) {
+      std::cerr << "Native FP8 vector shader compilation failed: " << e.what() << std::endl;
+      vectorKernel = nullptr;
+      is_native_vector = false;
+      hasVector = false;
     }
-  } else {
-    is_native_vector = false;
-    is_emulated_vector = false;
   }
 
   // Load Matrix Kernel (cooperative matrix) if supported
-  is_native_matrix = false;
-  if (info.cooperativeMatrixSupport &&
-      context.getBackend() == ComputeBackend::Vulkan) {
-    std::filesystem::path matrix_file =
-        kdir / "vulkan" / "coop_matrix_fp8.comp";
-    if (file_exists(matrix_file.string())) {
-      try {
-        matrixKernel = context.createKernel(matrix_file.string(), "main", 1);
-        context.setKernelArg(matrixKernel, 0, buffer);
-        is_native_matrix = true;
-      } catch (...) {
-        // Ignore failure, just don't enable matrix mode
-        is_native_matrix = false;
-      }
+  if (wantMatrix) {
+    try {
+      matrixKernel =
+          context.createKernel(matrix.file, matrix.name, matrix.numArgs);
+      context.setKernelArg(matrixKernel, 0, buffer);
+      is_native_matrix = true;
+    } catch (...) {
+      // Ignore failure, just don't enable matrix mode
+      is_native_matrix = false;
     }
   }
 }
 
+std::vector<KernelSource>
+Fp8Bench::GetKernelSources(ComputeBackend backend, const DeviceInfo &info,
+                           const std::string &kernel_dir) const {
+  std::vector<KernelSource> sources;
+  uint32_t config_idx = 0;
+  for (bool matrix : {false, true}) {
+    KernelSource source = kernelSource(matrix, backend, info, kernel_dir);
+    if (source.file.empty())
+      continue;
+    if (configFilter.matches(config_idx++, matrix ? "Matrix" : "Vector"))
+      sources.push_back(source);
+  }
+  return sources;
+}
+
+uint32_t
+Fp8Bench::GetExpectedKernelCount(ComputeBackend backend, const DeviceInfo &info,
+                                 const std::string &kernel_dir) const {
+  return static_cast<uint32_t>(
+      GetKernelSources(backend, info, kernel_dir).size());
+}
+
 void Fp8Bench::Run(uint32_t config_idx) {
-  if (config_idx == 0 && vectorKernel != nullptr) {
-    context->dispatch(vectorKernel, 8192, 1, 1, 64, 1, 1);
+  if (config_idx == 0 && hasVector) {
+    submitDispatch(context, vectorKernel, 8192, 1, 1, 64, 1, 1);
   } else if (matrixKernel) {
-    context->dispatch(matrixKernel, 32768, 1, 1, 32, 1, 1);
+    submitDispatch(context, matrixKernel, 32768, 1, 1, 32, 1, 1);
   }
 }
 
@@ -124,10 +153,11 @@ void Fp8Bench::Teardown() {
   vectorKernel = nullptr;
   matrixKernel = nullptr;
   buffer = nullptr;
+  hasVector = false;
 }
 
 BenchmarkResult Fp8Bench::GetResult(uint32_t config_idx) const {
-  if (config_idx == 0 && vectorKernel != nullptr) { // Vector
+  if (config_idx == 0 && hasVector) { // Vector
     // 8 fma operations per iteration, each is 2 ops (multiply, add)
     // 8 * 2 * 4 = 64 FP8-equivalent operations per iteration.
     // ROCm kernel loop reduced from 16384 → 512 to avoid TDR timeout;
@@ -152,12 +182,12 @@ BenchmarkResult Fp8Bench::GetResult(uint32_t config_idx) const {
 
 uint32_t Fp8Bench::GetNumConfigs() const {
   int configs = 0;
-  if (vectorKernel != nullptr) configs++;
+  if (hasVector) configs++;
   if (matrixKernel != nullptr) configs++;
   return configs;
 }
 
 std::string Fp8Bench::GetConfigName(uint32_t config_idx) const {
-  if (config_idx == 0 && vectorKernel != nullptr) return "Vector";
+  if (config_idx == 0 && hasVector) return "Vector";
   return "Matrix";
 }
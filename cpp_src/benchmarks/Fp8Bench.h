@@ -12,6 +12,9 @@ public:
   bool IsSupported(const DeviceInfo &info,
                    IComputeContext *context = nullptr) const override;
   void Setup(IComputeContext &context, const std::string &kernel_dir) override;
+  std::vector<KernelSource>
+  GetKernelSources(ComputeBackend backend, const DeviceInfo &info,
+                   const std::string &kernel_dir) const override;
   void Run(uint32_t config_idx = 0) override;
   void Teardown() override;
   BenchmarkResult GetResult(uint32_t config_idx = 0) const override;
@@ -22,9 +25,12 @@ public:
     return "FP8";
   }
   int GetSortWeight() const override { return 40; }
+  bool SupportsBatching() const override { return true; }
 
   uint32_t GetNumConfigs() const override;
-  virtual uint32_t GetExpectedKernelCount() const override { return 2; }
+  uint32_t GetExpectedKernelCount(ComputeBackend backend,
+                                  const DeviceInfo &info,
+                                  const std::string &kernel_dir) const override;
   std::string GetConfigName(uint32_t config_idx) const override;
   const char *GetMetric() const override { return "TFLOPS"; }
 
@@ -38,8 +44,16 @@ private:
   ComputeKernel vectorKernel = nullptr;
   ComputeKernel matrixKernel = nullptr;
   ComputeBuffer buffer = nullptr;
+  // Config 0 is Vector when set, even if the config filter skipped its kernel
+  bool hasVector = false;
   bool is_emulated_vector = false;
   bool is_native_vector = false;
   bool is_native_matrix = false;
   mutable std::string name = "FP8";
+
+  // The vector or matrix kernel for this backend and device, with an empty
+  // file if there is none. Setup() creates these, GetKernelSources() lists them.
+  KernelSource kernelSource(bool matrix, ComputeBackend backend,
+                            const DeviceInfo &info,
+                            const std::string &kernel_dir) const;
 };
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "benchmarks/ConfigFilter.h"
 #include "core/IComputeContext.h"
 #include <cstdint>
 #include <string>
@@ -27,12 +28,34 @@ public:
   virtual bool IsEmulated(uint32_t config_idx = 0) const { return false; }
   virtual uint32_t GetNumConfigs() const { return 1; }
   virtual std::string GetConfigName(uint32_t config_idx) const { return ""; }
-  virtual uint32_t GetExpectedKernelCount() const { return 1; }
+
+  // The createKernel() calls Setup() will make on this backend and device,
+  // so the runner can compile them ahead of Setup(), in parallel across
+  // benchmarks. Called after SetConfigFilter(). A listed kernel Setup() ends
+  // up skipping only costs compile time; an unlisted one compiles in Setup().
+  virtual std::vector<KernelSource>
+  GetKernelSources(ComputeBackend backend, const DeviceInfo &info,
+                   const std::string &kernel_dir) const {
+    return {};
+  }
+
+  // The number of kernels Setup() will create on this backend and device,
+  // for the compile progress bar.
+  virtual uint32_t GetExpectedKernelCount(ComputeBackend backend,
+                                          const DeviceInfo &info,
+                                          const std::string &kernel_dir) const {
+    return 1;
+  }
 
   // Returns true if this benchmark depends on the selected GPU device context.
   // Returns false if it is a system-wide or host-only benchmark (runs once).
   virtual bool IsDeviceDependent() const { return true; }
 
+  // Returns true if the result depends on shared host resources (CPU
+  // submission, system memory, PCIe) and would be skewed by the same
+  // benchmark running concurrently on another device.
+  virtual bool IsHostContended() const { return false; }
+
   virtual const char *GetComponent(uint32_t config_idx = 0) const {
     return "Other";
   }
@@ -41,7 +64,60 @@ public:
   }
   virtual int GetSortWeight() const { return 999; }
 
+  // Device time in ms of the work accounted for by GetResult().operations
+  // during the last Run(), for benchmarks that time their own submissions
+  // (or, for host benchmarks, their own measured loops). A negative value
+  // means the runner's own timing is used.
+  virtual double GetDeviceTimeMs(uint32_t config_idx) const { return -1.0; }
+
+  // Restricts the run to the configs selected on the command line. Called
+  // before Setup(), so benchmarks can skip kernels and buffers only needed by
+  // unselected configs; the runner skips those configs either way.
+  void SetConfigFilter(const ConfigFilter &filter) { configFilter = filter; }
+  const ConfigFilter &GetConfigFilter() const { return configFilter; }
+
+  // Benchmarks whose Run() is a single dispatch can issue it as a batch of
+  // dispatchBatch() calls. GetResult() still describes one dispatch; the
+  // runner divides the measured time by the batch size.
+  virtual bool SupportsBatching() const { return false; }
+  void SetBatchSize(uint32_t size) { batchSize = size ? size : 1; }
+  uint32_t GetBatchSize() const { return batchSize; }
+
+  // Runs config_idx without waiting for the device, for SupportsBatching()
+  // benchmarks. Returns the handle to pass to IComputeContext::wait().
+  DispatchHandle RunAsync(uint32_t config_idx) {
+    asyncSubmit = true;
+    lastSubmit = 0;
+    try {
+      Run(config_idx);
+    } catch (...) {
+      asyncSubmit = false;
+      throw;
+    }
+    asyncSubmit = false;
+    return lastSubmit;
+  }
+
   // Exports the scene geometry to an external file (e.g. OBJ) for
   // visualization.
   virtual void DumpGeometry() const {}
+
+protected:
+  // The single dispatch of a SupportsBatching() benchmark's Run()
+  void submitDispatch(IComputeContext *context, ComputeKernel kernel,
+                      uint32_t grid_x, uint32_t grid_y, uint32_t grid_z,
+                      uint32_t block_x, uint32_t block_y, uint32_t block_z) {
+    if (asyncSubmit) {
+      lastSubmit = context->dispatchAsync(kernel, grid_x, grid_y, grid_z,
+                                          block_x, block_y, block_z, batchSize);
+    } else {
+      context->dispatchBatch(kernel, grid_x, grid_y, grid_z, block_x, block_y,
+                             block_z, batchSize);
+    }
+  }
+
+  ConfigFilter configFilter;
+  uint32_t batchSize = 1;
+  bool asyncSubmit = false;
+  DispatchHandle lastSubmit = 0;
 };
@@ -9,21 +9,34 @@ bool Int4Bench::IsSupported(const DeviceInfo &info,
   return info.int4Support;
 }
 
+static bool isRdna4(const DeviceInfo &info) {
+  return info.name.find("gfx12") != std::string::npos ||
+         info.name.find("GFX12") != std::string::npos ||
+         info.name.find("rx 9070") != std::string::npos ||
+         info.name.find("R9700") != std::string::npos ||
+         info.name.find("Radeon AI") != std::string::npos;
+}
+
+KernelSource Int4Bench::kernelSource(ComputeBackend backend,
+                                     const DeviceInfo &info,
+                                     const std::string &kernel_dir) const {
+  // Cooperative Matrix path: on RDNA4, the matrix cores handle INT4 natively
+  // via the cooperative matrix interface with int8_t types (HW packs/unpacks).
+  if (backend != ComputeBackend::Vulkan || !info.cooperativeMatrixSupport ||
+      !isRdna4(info))
+    return {};
+  std::filesystem::path kdir(kernel_dir);
+  return {(kdir / "vulkan" / "coop_matrix_int4.comp").string(), "main", 1};
+}
+
 void Int4Bench::Setup(IComputeContext &context, const std::string &kernel_dir) {
   this->context = &context;
 
-  // Create storage buffer
-  size_t bufferSize =
-      8192 * 64 * 4; // 8192 workgroups * 64 threads * 4 bytes (i8vec4)
-  buffer = context.createBuffer(bufferSize);
-
   auto file_exists = [](const std::string &path) {
     std::ifstream f(path.c_str());
     return f.good();
   };
 
-  std::filesystem::path kdir(kernel_dir);
-
   if (context.getBackend() == ComputeBackend::ROCm) {
     // HIP INT4 is currently completely emulated. Skip to prevent inaccurate results.
     is_native_vector = false;
@@ -38,16 +51,6 @@ void Int4Bench::Setup(IComputeContext &context, const std::string &kernel_dir) {
     return;
   }
 
-  if (context.getBackend() == ComputeBackend::OpenCL) {
-    std::filesystem::path kernel_file = kdir / "opencl" / "int4.cl";
-    vectorKernel = context.createKernel(kernel_file.string(), "run_benchmark", 1);
-    context.setKernelArg(vectorKernel, 0, buffer);
-    is_native_vector = true;
-    is_emulated_vector = false;
-    is_native_matrix = false;
-    return;
-  }
-
   // Vulkan Path
   // INT4 vector shader uses i8vec4 with masking — this is emulated regardless
   // of hardware since there is no native INT4 vector ISA in Vulkan/SPIR-V.
@@ -56,39 +59,51 @@ void Int4Bench::Setup(IComputeContext &context, const std::string &kernel_dir) {
   is_emulated_vector = false;
   vectorKernel = nullptr;
 
-  DeviceInfo info = context.getCurrentDeviceInfo();
+  const DeviceInfo &info = context.getCurrentDeviceInfo();
 
-  // Cooperative Matrix path: on RDNA4, the matrix cores handle INT4 natively
-  // via the cooperative matrix interface with int8_t types (HW packs/unpacks).
-  bool is_rdna4 =
-      info.name.find("gfx12") != std::string::npos ||
-      info.name.find("GFX12") != std::string::npos ||
-      info.name.find("rx 9070") != std::string::npos ||
-      info.name.find("R9700") != std::string::npos ||
-      info.name.find("Radeon AI") != std::string::npos;
-      
   is_native_matrix = false;
-  if (info.cooperativeMatrixSupport &&
-      context.getBackend() == ComputeBackend::Vulkan && is_rdna4) {
-    std::filesystem::path matrix_file =
-        kdir / "vulkan" / "coop_matrix_int4.comp";
-    if (file_exists(matrix_file.string())) {
-      try {
-        matrixKernel = context.createKernel(matrix_file.string(), "main", 1);
-        context.setKernelArg(matrixKernel, 0, buffer);
-        is_native_matrix = true;
-      } catch (...) {
-        is_native_matrix = false;
-      }
+  KernelSource matrix = kernelSource(context.getBackend(), info, kernel_dir);
+  // Matrix is config 0, as there is no vector config. Skip the buffer too if
+  // the config filter excludes it.
+  if (!matrix.file.empty() && file_exists(matrix.file) &&
+      configFilter.matches(0, GetConfigName(0))) {
+    // Create storage buffer
+    size_t bufferSize =
+        8192 * 64 * 4; // 8192 workgroups * 64 threads * 4 bytes (i8vec4)
+    buffer = context.createBuffer(bufferSize);
+
+    try {
+      matrixKernel =
+          context.createKernel(matrix.file, matrix.name, matrix.numArgs);
+      context.setKernelArg(matrixKernel, 0, buffer);
+      is_native_matrix = true;
+    } catch (...) {
+      is_native_matrix = false;
     }
   }
 }
 
+std::vector<KernelSource>
+Int4Bench::GetKernelSources(ComputeBackend backend, const DeviceInfo &info,
+                            const std::string &kernel_dir) const {
+  KernelSource source = kernelSource(backend, info, kernel_dir);
+  if (source.file.empty() || !configFilter.matches(0, GetConfigName(0)))
+    return {};
+  return {source};
+}
+
+uint32_t
+Int4Bench::GetExpectedKernelCount(ComputeBackend backend,
+                                  const DeviceInfo &info,
+                                  const std::string &kernel_dir) const {
+  return configFilter.matches(0, GetConfigName(0)) ? 1 : 0;
+}
+
 void Int4Bench::Run(uint32_t config_idx) {
   if (config_idx == 0 && vectorKernel != nullptr) {
-    context->dispatch(vectorKernel, 8192, 1, 1, 64, 1, 1);
+    submitDispatch(context, vectorKernel, 8192, 1, 1, 64, 1, 1);
   } else if (matrixKernel) {
-    context->dispatch(matrixKernel, 32768, 1, 1, 32, 1, 1);
+    submitDispatch(context, matrixKernel, 32768, 1, 1, 32, 1, 1);
   }
 }
 
@@ -11,52 +11,92 @@ bool Int8Bench::IsSupported(const DeviceInfo &info,
   return info.int8Support;
 }
 
+KernelSource Int8Bench::kernelSource(bool matrix, ComputeBackend backend,
+                                     const DeviceInfo &info,
+                                     const std::string &kernel_dir) const {
+  std::filesystem::path kdir(kernel_dir);
+  if (backend == ComputeBackend::ROCm) {
+    if (!matrix)
+      return {(kdir / "rocm" / "int8.hip").string(), "run_benchmark", 1};
+    return {};
+  }
+  if (backend == ComputeBackend::OpenCL) {
+    if (!matrix)
+      return {(kdir / "opencl" / "int8.cl").string(), "run_benchmark", 1};
+    return {};
+  }
+  if (!matrix)
+    return {(kdir / "vulkan" / "int8.comp").string(), "main", 1};
+  if (info.cooperativeMatrixSupport)
+    return {(kdir / "vulkan" / "coop_matrix_int8.comp").string(), "main", 2};
+  return {};
+}
+
 void Int8Bench::Setup(IComputeContext &context, const std::string &kernel_dir) {
   this->context = &context;
+  const DeviceInfo &info = context.getCurrentDeviceInfo();
+
+  // Skip the kernels of configs the filter excludes, and the buffer too if
+  // nothing is selected
+  bool wantVector = configFilter.matches(0, GetConfigName(0));
+  bool wantMatrix = configFilter.matches(1, GetConfigName(1));
+  if (!wantVector && !wantMatrix)
+    return;
 
   // Create storage buffer
   size_t bufferSize =
       8192 * 64 * 4; // 8192 workgroups * 64 threads * 4 bytes (i8vec4)
   buffer = context.createBuffer(bufferSize);
-  std::vector<int8_t> initData(bufferSize, 1);
-  context.writeBuffer(buffer, 0, bufferSize, initData.data());
+  // Every int8 lane set to 1
+  context.fillBuffer(buffer, 0, bufferSize, 0x01010101);
 
   // Load Vector Kernel
-  std::filesystem::path kdir(kernel_dir);
-  std::filesystem::path vector_file_path;
-
-  if (context.getBackend() == ComputeBackend::ROCm) {
-    vector_file_path = kdir / "rocm" / "int8.hip";
-  } else if (context.getBackend() == ComputeBackend::Vulkan) {
-    vector_file_path = kdir / "vulkan" / "int8.comp";
-  } else {
-    vector_file_path = kdir / "opencl" / "int8.cl";
+  if (wantVector) {
+    KernelSource vector =
+        kernelSource(false, context.getBackend(), info, kernel_dir);
+    vectorKernel =
+        context.createKernel(vector.file, vector.name, vector.numArgs);
+    context.setKernelArg(vectorKernel, 0, buffer);
   }
 
-  std::string kernel_name = (context.getBackend() == ComputeBackend::Vulkan)
-                                ? "main"
-                                : "run_benchmark";
-  vectorKernel =
-      context.createKernel(vector_file_path.string(), kernel_name, 1);
-  context.setKernelArg(vectorKernel, 0, buffer);
-
   // Optionally load Matrix Kernel
-  if (context.getCurrentDeviceInfo().cooperativeMatrixSupport &&
-      context.getBackend() == ComputeBackend::Vulkan) {
-    std::filesystem::path matrix_file_path =
-        kdir / "vulkan" / "coop_matrix_int8.comp";
-    matrixKernel = context.createKernel(matrix_file_path.string(), "main", 2);
+  KernelSource matrix =
+      kernelSource(true, context.getBackend(), info, kernel_dir);
+  if (wantMatrix && !matrix.file.empty()) {
+    matrixKernel =
+        context.createKernel(matrix.file, matrix.name, matrix.numArgs);
     context.setKernelArg(matrixKernel, 0, buffer); // Binding 0: int8 (A/B)
     context.setKernelArg(matrixKernel, 1, buffer); // Binding 1: int32 (C)
   }
 }
 
+std::vector<KernelSource>
+Int8Bench::GetKernelSources(ComputeBackend backend, const DeviceInfo &info,
+                            const std::string &kernel_dir) const {
+  std::vector<KernelSource> sources;
+  for (bool matrix : {false, true}) {
+    KernelSource source = kernelSource(matrix, backend, info, kernel_dir);
+    if (!source.file.empty() &&
+        configFilter.matches(matrix ? 1 : 0, GetConfigName(matrix ? 1 : 0)))
+      sources.push_back(source);
+  }
+  return sources;
+}
+
+uint32_t
+Int8Bench::GetExpectedKernelCount(ComputeBackend backend,
+                                  const DeviceInfo &info,
+                                  const std::string &kernel_dir) const {
+  return (configFilter.matches(0, GetConfigName(0)) ? 1 : 0) +
+         (configFilter.matches(1, GetConfigName(1)) ? 1 : 0);
+}
+
 void Int8Bench::Run(uint32_t config_idx) {
   if (config_idx == 0) {
-    context->dispatch(vectorKernel, 8192, 1, 1, 64, 1, 1);
+    submitDispatch(context, vectorKernel, 8192, 1, 1, 64, 1, 1);
   } else if (matrixKernel) {
     // 65536 WGs of 32 threads each — double dispatch to saturate tensor units
-    context->dispatch(matrixKernel, 65536, 1, 1, 32, 1, 1);
+    submitDispatch(context, matrixKernel, 65536, 1, 1, 32, 1, 1);
   }
 }
 
@@ -3,35 +3,35 @@
 #include <iostream>
 #include <stdexcept>
 
+// Read/Write/RW for 128, 256, and 1024 threads, in Setup() order
+static const char *const kModeNames[] = {"Read", "Write", "R/W"};
+static const uint32_t kGroupSizes[] = {128, 256, 1024};
+static constexpr uint32_t kMaxConfigs = 9;
+
 bool MemBandwidthBench::IsSupported(const DeviceInfo &info,
                                     IComputeContext *context) const {
   return true;
 }
 
+static KernelSource kernelSource(ComputeBackend backend,
+                                 const std::string &kernel_dir,
+                                 const std::string &kernel_file) {
+  std::filesystem::path kdir(kernel_dir);
+  if (backend == ComputeBackend::ROCm)
+    return {(kdir / "rocm" / (kernel_file + ".hip")).string(),
+            "run_benchmark", 2};
+  if (backend == ComputeBackend::OpenCL)
+    return {(kdir / "opencl" / (kernel_file + ".cl")).string(),
+            "run_benchmark", 2};
+  return {(kdir / "vulkan" / (kernel_file + ".comp")).string(), "main", 2};
+}
+
 void MemBandwidthBench::createKernel(BandwidthConfig &config,
                                      const std::string &kernel_dir) {
-  std::filesystem::path kdir(kernel_dir);
-  std::filesystem::path
-      kernel_file_path; // Renamed to avoid conflict with string kernel_file
-
-  // The order of backend checks in the edit is different from original,
-  // following the edit's logic for path construction.
-  if (this->context->getBackend() == ComputeBackend::ROCm) {
-    kernel_file_path = kdir / "rocm" / (config.kernelFile + ".hip");
-  } else if (this->context->getBackend() == ComputeBackend::OpenCL) {
-    kernel_file_path = kdir / "opencl" / (config.kernelFile + ".cl");
-  } else { // Default to Vulkan if not ROCm or OpenCL
-    kernel_file_path = kdir / "vulkan" / (config.kernelFile + ".comp");
-  }
-
-  std::string kernel_name;
-  if (this->context->getBackend() == ComputeBackend::Vulkan) {
-    kernel_name = "main";
-  } else {
-    kernel_name = "run_benchmark";
-  }
-  config.kernel =
-      this->context->createKernel(kernel_file_path.string(), kernel_name, 2);
+  KernelSource source = kernelSource(this->context->getBackend(), kernel_dir,
+                                     config.kernelFile);
+  config.kernel = this->context->createKernel(source.file, source.name,
+                                              source.numArgs);
   this->context->setKernelArg(config.kernel, 0, inputBuffer);
   this->context->setKernelArg(config.kernel, 1, outputBuffer);
   uint32_t mode = static_cast<uint32_t>(config.mode);
@@ -55,7 +55,7 @@ void MemBandwidthBench::Setup(IComputeContext &context,
   this->context = &context;
 
   // Get device info first
-  DeviceInfo deviceInfo = context.getCurrentDeviceInfo();
+  const DeviceInfo &deviceInfo = context.getCurrentDeviceInfo();
 
   // Calculate buffer size based on available VRAM and workload requirements
   uint64_t availableVRAM = deviceInfo.memorySize;
@@ -101,14 +101,15 @@ void MemBandwidthBench::Setup(IComputeContext &context,
   inputBuffer = this->context->createBuffer(bufferSize);
   outputBuffer = this->context->createBuffer(bufferSize);
 
-  // Initialize input buffer with test data to prevent reading uninitialized
-  // memory
-  std::vector<float> testData(bufferSize / sizeof(float), 1.0f);
-  this->context->writeBuffer(inputBuffer, 0, bufferSize, testData.data());
+  // Initialize input buffer with test data (1.0f) to prevent reading
+  // uninitialized memory. Filled on the device: a host copy of a 2 GB
+  // buffer is what runs small-RAM machines out of memory.
+  const uint32_t kOneFloatBits = 0x3F800000;
+  this->context->fillBuffer(inputBuffer, 0, bufferSize, kOneFloatBits);
 
   // Initialize output buffer as well to ensure pages are mapped/resident
   // (prevents page faults on unified memory)
-  this->context->writeBuffer(outputBuffer, 0, bufferSize, testData.data());
+  this->context->fillBuffer(outputBuffer, 0, bufferSize, kOneFloatBits);
 
   this->context->waitIdle();
 
@@ -122,34 +123,29 @@ void MemBandwidthBench::Setup(IComputeContext &context,
 
   // Create configurations based on device capabilities
   // We scale workgroups based on maxTotalThreads, with higher caps for modern
-  // GPUs
+  // GPUs. Names come from GetConfigName(), which the config filter also uses
+  // before Setup().
+  auto addConfigs = [&](const char *kernelFile, uint32_t workgroupSize,
+                        uint32_t numWorkgroups) {
+    for (TestMode mode :
+         {TestMode::Read, TestMode::Write, TestMode::ReadWrite}) {
+      configs.push_back({GetConfigName(configs.size()), kernelFile,
+                         workgroupSize, numWorkgroups, mode, nullptr});
+    }
+  };
+
   uint32_t numWorkgroups128 = std::min(16384u, maxTotalThreads / 128);
-  configs.push_back({"Read 128 threads/group", "membw_128", 128,
-                     numWorkgroups128, TestMode::Read, nullptr});
-  configs.push_back({"Write 128 threads/group", "membw_128", 128,
-                     numWorkgroups128, TestMode::Write, nullptr});
-  configs.push_back({"R/W 128 threads/group", "membw_128", 128,
-                     numWorkgroups128, TestMode::ReadWrite, nullptr});
+  addConfigs("membw_128", 128, numWorkgroups128);
 
   uint32_t workgroupSize256 = std::min(256u, maxWorkgroupSize);
   uint32_t numWorkgroups256 =
       std::min(8192u, maxTotalThreads / workgroupSize256);
-  configs.push_back({"Read 256 threads/group", "membw_256", workgroupSize256,
-                     numWorkgroups256, TestMode::Read, nullptr});
-  configs.push_back({"Write 256 threads/group", "membw_256", workgroupSize256,
-                     numWorkgroups256, TestMode::Write, nullptr});
-  configs.push_back({"R/W 256 threads/group", "membw_256", workgroupSize256,
-                     numWorkgroups256, TestMode::ReadWrite, nullptr});
+  addConfigs("membw_256", workgroupSize256, numWorkgroups256);
 
   // Only add 1024 config if device supports it
   if (maxWorkgroupSize >= 1024) {
     uint32_t numWorkgroups1024 = std::min(2048u, maxTotalThreads / 1024);
-    configs.push_back({"Read 1024 threads/group", "membw_1024", 1024,
-                       numWorkgroups1024, TestMode::Read, nullptr});
-    configs.push_back({"Write 1024 threads/group", "membw_1024", 1024,
-                       numWorkgroups1024, TestMode::Write, nullptr});
-    configs.push_back({"R/W 1024 threads/group", "membw_1024", 1024,
-                       numWorkgroups1024, TestMode::ReadWrite, nullptr});
+    addConfigs("membw_1024", 1024, numWorkgroups1024);
   }
 
   if (debug) {
@@ -159,8 +155,11 @@ void MemBandwidthBench::Setup(IComputeContext &context,
               << " wg, 256tpg: " << numWorkgroups256 << " wg)" << std::endl;
   }
 
-  for (auto &config : configs) {
-    createKernel(config, kernel_dir);
+  // Kernels of configs excluded by the config filter are never compiled
+  for (uint32_t i = 0; i < configs.size(); ++i) {
+    if (configFilter.matches(i, configs[i].name)) {
+      createKernel(configs[i], kernel_dir);
+    }
   }
 }
 
@@ -170,8 +169,12 @@ void MemBandwidthBench::Run(uint32_t config_idx) {
   }
 
   auto &config = configs[config_idx];
-  context->dispatch(config.kernel, config.numWorkgroups, 1, 1,
-                    config.workgroupSize, 1, 1);
+  if (!config.kernel) {
+    throw std::runtime_error("MemBandwidthBench config '" + config.name +
+                             "' was not selected");
+  }
+  submitDispatch(context, config.kernel, config.numWorkgroups, 1, 1,
+                 config.workgroupSize, 1, 1);
 }
 
 void MemBandwidthBench::Teardown() {
@@ -207,9 +210,43 @@ BenchmarkResult MemBandwidthBench::GetResult(uint32_t config_idx) const {
 
 uint32_t MemBandwidthBench::GetNumConfigs() const { return configs.size(); }
 
+uint32_t
+MemBandwidthBench::GetExpectedKernelCount(ComputeBackend backend,
+                                          const DeviceInfo &info,
+                                          const std::string &kernel_dir) const {
+  uint32_t count = 0;
+  for (uint32_t i = 0; i < kMaxConfigs; ++i) {
+    if (configFilter.matches(i, GetConfigName(i)))
+      count++;
+  }
+  return count;
+}
+
+std::vector<KernelSource>
+MemBandwidthBench::GetKernelSources(ComputeBackend backend,
+                                    const DeviceInfo &info,
+                                    const std::string &kernel_dir) const {
+  // Read/Write/RW share one kernel per group size, in Setup() order
+  static const char *const kKernelFiles[] = {"membw_128", "membw_256",
+                                             "membw_1024"};
+  std::vector<KernelSource> sources;
+  for (uint32_t k = 0; k < 3; ++k) {
+    if (k == 2 && info.maxWorkGroupSize < 1024)
+      break;
+    for (uint32_t i = k * 3; i < k * 3 + 3; ++i) {
+      if (configFilter.matches(i, GetConfigName(i))) {
+        sources.push_back(kernelSource(backend, kernel_dir, kKernelFiles[k]));
+        break;
+      }
+    }
+  }
+  return sources;
+}
+
 std::string MemBandwidthBench::GetConfigName(uint32_t config_idx) const {
-  if (config_idx >= configs.size()) {
+  if (config_idx >= kMaxConfigs) {
     return "Invalid Config";
   }
-  return configs[config_idx].name;
+  return std::string(kModeNames[config_idx % 3]) + " " +
+         std::to_string(kGroupSizes[config_idx / 3]) + " threads/group";
 }
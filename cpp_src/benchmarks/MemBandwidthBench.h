@@ -35,11 +35,17 @@ public:
     return "Bandwidth";
   }
   int GetSortWeight() const override { return 300; }
+  bool SupportsBatching() const override { return true; }
+  // Setup stages up to 2 GB of test data through host memory
+  bool IsHostContended() const override { return true; }
   uint32_t GetNumConfigs() const override;
   std::string GetConfigName(uint32_t config_idx) const override;
-  virtual uint32_t GetExpectedKernelCount() const override {
-    return 9; // Read/Write/RW for 128, 256, and 1024 threads
-  }
+  virtual uint32_t
+  GetExpectedKernelCount(ComputeBackend backend, const DeviceInfo &info,
+                         const std::string &kernel_dir) const override;
+  std::vector<KernelSource>
+  GetKernelSources(ComputeBackend backend, const DeviceInfo &info,
+                   const std::string &kernel_dir) const override;
 
   void setDebug(bool debug) { this->debug = debug; }
 
@@ -216,7 +216,9 @@ void RayASBuildBench::Run(uint32_t config_idx) {
   }
 
   const VkAccelerationStructureBuildRangeInfoKHR *pRange = &range;
+  vContext->cmdTimestampBegin(cmd);
   vkCmdBuildAccelerationStructuresKHR_ptr(cmd, 1, &buildInfo, &pRange);
+  vContext->cmdTimestampEnd(cmd);
 
   vkEndCommandBuffer(cmd);
 
@@ -224,18 +226,22 @@ void RayASBuildBench::Run(uint32_t config_idx) {
   
   // We launch 10 submits to measure a stable time without too much CPU overhead
   uint32_t iters = 10;
+  double deviceMs = 0.0;
   for (uint32_t i = 0; i < iters; ++i) {
     VkSubmitInfo submit{VK_STRUCTURE_TYPE_SUBMIT_INFO};
     submit.commandBufferCount = 1;
     submit.pCommandBuffers = &cmd;
     vkQueueSubmit(queue, 1, &submit, VK_NULL_HANDLE);
     vkQueueWaitIdle(queue);
+    deviceMs += vContext->readTimestamps();
   }
 
   auto end = std::chrono::high_resolution_clock::now();
   std::chrono::duration<double> diff = end - start;
 
   buildTimes[config_idx] = (diff.count() / iters) * 1000.0; // Time in milliseconds
+  deviceBuildTimes[config_idx] =
+      vContext->hasDeviceTimer() ? deviceMs / iters : buildTimes[config_idx];
   iterations = iters;
 
   vkDestroyCommandPool(device, tmpPool, nullptr);
@@ -261,6 +267,13 @@ BenchmarkResult RayASBuildBench::GetResult(uint32_t config_idx) const {
   return {ops, buildTimes.at(config_idx)};
 }
 
+double RayASBuildBench::GetDeviceTimeMs(uint32_t config_idx) const {
+  // Run() performs several builds; report the time of a single one so it
+  // matches the operation count from GetResult()
+  auto it = deviceBuildTimes.find(config_idx);
+  return it != deviceBuildTimes.end() ? it->second : -1.0;
+}
+
 const char *RayASBuildBench::GetName() const { return "RayASBuild"; }
 const char *RayASBuildBench::GetComponent(uint32_t config_idx) const {
   return "Ray Tracing";
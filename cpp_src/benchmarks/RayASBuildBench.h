@@ -17,6 +17,7 @@ public:
   void Teardown() override;
 
   BenchmarkResult GetResult(uint32_t config_idx) const override;
+  double GetDeviceTimeMs(uint32_t config_idx) const override;
   const char *GetName() const override;
   const char *GetComponent(uint32_t config_idx) const override;
   const char *GetMetric(uint32_t config_idx) const override;
@@ -24,6 +25,8 @@ public:
   std::string GetConfigName(uint32_t config_idx) const override;
 
   uint32_t GetNumConfigs() const override { return 3; } // BLAS Build, TLAS Build, BLAS Update
+  // Host-driven submit/wait loop per build
+  bool IsHostContended() const override { return true; }
 
 private:
   void loadRTProcs(VkDevice device);
@@ -44,6 +47,7 @@ private:
   uint32_t numPrimitives = 0;
   uint32_t numInstances = 0;
   std::map<uint32_t, double> buildTimes;
+  std::map<uint32_t, double> deviceBuildTimes;
   uint32_t iterations = 0;
 
   VkAccelerationStructureBuildSizesInfoKHR blasSizes{};
@@ -42,8 +42,7 @@ void RayDivergenceBench::Setup(IComputeContext &context,
   // Target a substantial workload to saturate RTUs
   rayCount = 4000000;
   resultBuffer = context.createBuffer(sizeof(uint32_t));
-  uint32_t zero = 0;
-  context.writeBuffer(resultBuffer, 0, 4, &zero);
+  context.fillBuffer(resultBuffer, 0, sizeof(uint32_t), 0);
 
   // Setup a high-resolution flat floor plane (Z=0) and ceiling plane (Z=-20)
   uint32_t gridSize = 256;
@@ -41,8 +41,7 @@ void RayIncoherentBench::Setup(IComputeContext &context,
 
   rayCount = 4000000;
   resultBuffer = context.createBuffer(sizeof(uint32_t));
-  uint32_t zero = 0;
-  context.writeBuffer(resultBuffer, 0, 4, &zero);
+  context.fillBuffer(resultBuffer, 0, sizeof(uint32_t), 0);
 
   // Generate a bunch of random triangles in a volume (bounding box -100 to 100)
   numPrimitives = 200000; 
@@ -41,8 +41,7 @@ void RayPayloadBench::Setup(IComputeContext &context,
 
   rayCount = 4000000;
   resultBuffer = context.createBuffer(sizeof(uint32_t));
-  uint32_t zero = 0;
-  context.writeBuffer(resultBuffer, 0, 4, &zero);
+  context.fillBuffer(resultBuffer, 0, sizeof(uint32_t), 0);
 
   numPrimitives = 200000; 
   std::vector<float> vertices;
@@ -75,17 +74,22 @@ void RayPayloadBench::Setup(IComputeContext &context,
 
   std::filesystem::path kdir(kernel_dir);
   
-  if (vContext) {
+  // One pipeline per config; skip the ones the config filter excludes
+  if (vContext && configFilter.matches(0, GetConfigName(0))) {
     std::vector<std::string> hit16 = {(kdir / "vulkan" / "raypayload_16b.rchit").string()};
     kernel16 = vContext->createRTPipeline(
         (kdir / "vulkan" / "raypayload_16b.rgen").string(),
         (kdir / "vulkan" / "raypayload_16b.rmiss").string(), hit16, {}, {}, 2);
+  }
 
+  if (vContext && configFilter.matches(1, GetConfigName(1))) {
     std::vector<std::string> hit128 = {(kdir / "vulkan" / "raypayload_128b.rchit").string()};
     kernel128 = vContext->createRTPipeline(
         (kdir / "vulkan" / "raypayload_128b.rgen").string(),
         (kdir / "vulkan" / "raypayload_128b.rmiss").string(), hit128, {}, {}, 2);
+  }
 
+  if (vContext && configFilter.matches(2, GetConfigName(2))) {
     std::vector<std::string> hit256 = {(kdir / "vulkan" / "raypayload_256b.rchit").string()};
     kernel256 = vContext->createRTPipeline(
         (kdir / "vulkan" / "raypayload_256b.rgen").string(),
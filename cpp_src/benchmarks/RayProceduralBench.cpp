@@ -41,8 +41,7 @@ void RayProceduralBench::Setup(IComputeContext &context,
 
   rayCount = 4000000;
   resultBuffer = context.createBuffer(sizeof(uint32_t));
-  uint32_t zero = 0;
-  context.writeBuffer(resultBuffer, 0, 4, &zero);
+  context.fillBuffer(resultBuffer, 0, sizeof(uint32_t), 0);
 
   numPrimitives = 200000; 
   std::vector<VkAabbPositionsKHR> aabbs;
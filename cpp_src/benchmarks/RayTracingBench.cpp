@@ -43,8 +43,7 @@ void RayTracingBench::Setup(IComputeContext &context,
   // Target a substantial workload to saturate RTUs
   rayCount = 128000000;
   resultBuffer = context.createBuffer(sizeof(uint32_t));
-  uint32_t zero = 0;
-  context.writeBuffer(resultBuffer, 0, 4, &zero);
+  context.fillBuffer(resultBuffer, 0, sizeof(uint32_t), 0);
 
   // Setup Triangle and Box data (64 layers of 16x16 grids = 16,384 primitives)
   uint32_t gridSize = 16;
@@ -333,6 +332,14 @@ void RayTracingBench::buildAS() {
   vkDestroyCommandPool(device, tmpPool, nullptr);
 }
 
+std::vector<KernelSource>
+RayTracingBench::GetKernelSources(ComputeBackend backend,
+                                  const DeviceInfo &info,
+                                  const std::string &kernel_dir) const {
+  std::filesystem::path kdir(kernel_dir);
+  return {{(kdir / "vulkan" / "rt_benchmark.comp").string(), "main", 2}};
+}
+
 void RayTracingBench::Run(uint32_t config_idx) {
   VulkanContext *vContext = static_cast<VulkanContext *>(context);
   VkAccelerationStructureKHR activeTlas =
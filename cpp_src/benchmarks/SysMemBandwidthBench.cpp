@@ -1,15 +1,15 @@
 #include "benchmarks/SysMemBandwidthBench.h"
-#include <atomic>
+#include "benchmarks/SysMemKernels.h"
+#include <algorithm>
 #include <chrono>
 #include <cstdlib>
 #include <cstring>
 #ifndef _MSC_VER
-#include <immintrin.h>  // AVX2 intrinsics (GCC/Clang only)
+#include <immintrin.h>  // AVX2/AVX-512 intrinsics (GCC/Clang only)
 #endif
 #include <iostream>
 #include <numeric>
 #include <stdexcept>
-#include <thread>
 #include <vector>
 
 #ifdef _WIN32
@@ -21,25 +21,26 @@
 #define ALIGNED_FREE(ptr) free(ptr)
 #endif
 
-// Check for AVX2 support.
+// Check for AVX2 / AVX-512 support.
 // __builtin_cpu_supports is a GCC/Clang builtin. MSVC does not support it;
-// on MSVC we always disable AVX2 and use the scalar fallback.
+// on MSVC we always disable the SIMD kernels and use the scalar fallbacks.
 #ifndef _MSC_VER
 static bool hasAVX2() { return __builtin_cpu_supports("avx2"); }
+static bool hasAVX512() { return __builtin_cpu_supports("avx512f"); }
 #else
 static bool hasAVX2() { return false; }
+static bool hasAVX512() { return false; }
+#endif
+static bool always() { return true; }
+
+// rep movsb / rep stosb: inline asm on GCC/Clang, intrinsics on MSVC
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) ||          \
+    defined(_M_IX86)
+#define HAVE_REP_MOVS 1
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
 #endif
-
-SysMemBandwidthBench::SysMemBandwidthBench() {
-  configs.push_back({"Read", SysMemTestMode::Read, 0});
-  configs.push_back({"Write", SysMemTestMode::Write, 0});
-  configs.push_back({"Copy", SysMemTestMode::ReadWrite, 0});
-
-  // Single Threaded (Scaling / Channel Bandwidth approximation)
-  configs.push_back({"Read (1 Thread)", SysMemTestMode::Read, 1});
-  configs.push_back({"Write (1 Thread)", SysMemTestMode::Write, 1});
-  configs.push_back({"Copy (1 Thread)", SysMemTestMode::ReadWrite, 1});
-}
 
 SysMemBandwidthBench::~SysMemBandwidthBench() { Teardown(); }
 
@@ -59,18 +60,31 @@ void SysMemBandwidthBench::Setup(IComputeContext &context,
   // 4GB buffer
   bufferSize = 4ULL * 1024ULL * 1024ULL * 1024ULL;
 
+  // Only the Copy configs need the destination buffer
+  bool needDest = false;
+  for (uint32_t i = 0; i < configs.size(); ++i) {
+    if (configs[i].mode == SysMemTestMode::ReadWrite &&
+        configFilter.matches(i, configs[i].name))
+      needDest = true;
+  }
+
   // Use aligned_alloc for AVX
   buffer = ALIGNED_ALLOC(64, bufferSize);
-  destBuffer = ALIGNED_ALLOC(64, bufferSize);
+  if (needDest)
+    destBuffer = ALIGNED_ALLOC(64, bufferSize);
 
-  if (!buffer || !destBuffer) {
+  if (!buffer || (needDest && !destBuffer)) {
     throw std::runtime_error("Failed to allocate system memory buffers");
   }
 
   // Initialize memory to avoid page faults during timed run (Linux lazy
   // allocation)
   std::memset(buffer, 1, bufferSize);
-  std::memset(destBuffer, 0, bufferSize); // Touch pages
+  if (destBuffer)
+    std::memset(destBuffer, 0, bufferSize); // Touch pages
+
+  // Workers persist across Run() calls, so thread creation is never timed
+  pool = std::make_unique<utils::PinnedThreadPool>();
 }
 
 #ifndef _MSC_VER
@@ -135,6 +149,158 @@ __attribute__((target("avx2"))) void run_copy_avx2(const void *src, void *dst,
   }
   _mm_sfence();
 }
+
+// Temporal stores: lines are read for ownership and written back on
+// eviction, which is what ordinary code gets
+__attribute__((target("avx2"))) void run_write_avx2_temporal(void *dst,
+                                                             size_t size) {
+  __m256i *pDst = reinterpret_cast<__m256i *>(dst);
+  size_t count = size / sizeof(__m256i);
+  __m256i val = _mm256_set1_epi32(0xAAAAAAAA);
+
+  for (size_t i = 0; i + 4 <= count; i += 4) {
+    _mm256_store_si256(pDst + i, val);
+    _mm256_store_si256(pDst + i + 1, val);
+    _mm256_store_si256(pDst + i + 2, val);
+    _mm256_store_si256(pDst + i + 3, val);
+  }
+}
+
+__attribute__((target("avx2"))) void
+run_copy_avx2_temporal(const void *src, void *dst, size_t size) {
+  const __m256i *pSrc = reinterpret_cast<const __m256i *>(src);
+  __m256i *pDst = reinterpret_cast<__m256i *>(dst);
+  size_t count = size / sizeof(__m256i);
+
+  for (size_t i = 0; i + 4 <= count; i += 4) {
+    __m256i v0 = _mm256_load_si256(pSrc + i);
+    __m256i v1 = _mm256_load_si256(pSrc + i + 1);
+    __m256i v2 = _mm256_load_si256(pSrc + i + 2);
+    __m256i v3 = _mm256_load_si256(pSrc + i + 3);
+
+    _mm256_store_si256(pDst + i, v0);
+    _mm256_store_si256(pDst + i + 1, v1);
+    _mm256_store_si256(pDst + i + 2, v2);
+    _mm256_store_si256(pDst + i + 3, v3);
+  }
+}
+
+// AVX-512 kernels: one full cache line per instruction
+__attribute__((target("avx512f"))) void run_read_avx512(const void *src,
+                                                        size_t size) {
+  const __m512i *pSrc = reinterpret_cast<const __m512i *>(src);
+  size_t count = size / sizeof(__m512i);
+
+  // Unroll 4x
+  __m512i accum = _mm512_setzero_si512();
+  for (size_t i = 0; i + 4 <= count; i += 4) {
+    __m512i v0 = _mm512_load_si512(pSrc + i);
+    __m512i v1 = _mm512_load_si512(pSrc + i + 1);
+    __m512i v2 = _mm512_load_si512(pSrc + i + 2);
+    __m512i v3 = _mm512_load_si512(pSrc + i + 3);
+
+    accum = _mm512_xor_si512(accum, v0);
+    accum = _mm512_xor_si512(accum, v1);
+    accum = _mm512_xor_si512(accum, v2);
+    accum = _mm512_xor_si512(accum, v3);
+  }
+
+  volatile __m512i sink = accum;
+  (void)sink;
+}
+
+__attribute__((target("avx512f"))) void run_write_avx512(void *dst,
+                                                         size_t size) {
+  __m512i *pDst = reinterpret_cast<__m512i *>(dst);
+  size_t count = size / sizeof(__m512i);
+  __m512i val = _mm512_set1_epi32(0xAAAAAAAA);
+
+  for (size_t i = 0; i + 4 <= count; i += 4) {
+    _mm512_stream_si512(pDst + i, val);
+    _mm512_stream_si512(pDst + i + 1, val);
+    _mm512_stream_si512(pDst + i + 2, val);
+    _mm512_stream_si512(pDst + i + 3, val);
+  }
+  _mm_sfence();
+}
+
+__attribute__((target("avx512f"))) void run_write_avx512_temporal(void *dst,
+                                                                  size_t size) {
+  __m512i *pDst = reinterpret_cast<__m512i *>(dst);
+  size_t count = size / sizeof(__m512i);
+  __m512i val = _mm512_set1_epi32(0xAAAAAAAA);
+
+  for (size_t i = 0; i + 4 <= count; i += 4) {
+    _mm512_store_si512(pDst + i, val);
+    _mm512_store_si512(pDst + i + 1, val);
+    _mm512_store_si512(pDst + i + 2, val);
+    _mm512_store_si512(pDst + i + 3, val);
+  }
+}
+
+__attribute__((target("avx512f"))) void run_copy_avx512(const void *src,
+                                                        void *dst,
+                                                        size_t size) {
+  const __m512i *pSrc = reinterpret_cast<const __m512i *>(src);
+  __m512i *pDst = reinterpret_cast<__m512i *>(dst);
+  size_t count = size / sizeof(__m512i);
+
+  for (size_t i = 0; i + 4 <= count; i += 4) {
+    __m512i v0 = _mm512_load_si512(pSrc + i);
+    __m512i v1 = _mm512_load_si512(pSrc + i + 1);
+    __m512i v2 = _mm512_load_si512(pSrc + i + 2);
+    __m512i v3 = _mm512_load_si512(pSrc + i + 3);
+
+    _mm512_stream_si512(pDst + i, v0);
+    _mm512_stream_si512(pDst + i + 1, v1);
+    _mm512_stream_si512(pDst + i + 2, v2);
+    _mm512_stream_si512(pDst + i + 3, v3);
+  }
+  _mm_sfence();
+}
+
+__attribute__((target("avx512f"))) void
+run_copy_avx512_temporal(const void *src, void *dst, size_t size) {
+  const __m512i *pSrc = reinterpret_cast<const __m512i *>(src);
+  __m512i *pDst = reinterpret_cast<__m512i *>(dst);
+  size_t count = size / sizeof(__m512i);
+
+  for (size_t i = 0; i + 4 <= count; i += 4) {
+    __m512i v0 = _mm512_load_si512(pSrc + i);
+    __m512i v1 = _mm512_load_si512(pSrc + i + 1);
+    __m512i v2 = _mm512_load_si512(pSrc + i + 2);
+    __m512i v3 = _mm512_load_si512(pSrc + i + 3);
+
+    _mm512_store_si512(pDst + i, v0);
+    _mm512_store_si512(pDst + i + 1, v1);
+    _mm512_store_si512(pDst + i + 2, v2);
+    _mm512_store_si512(pDst + i + 3, v3);
+  }
+}
+#endif
+
+#ifdef HAVE_REP_MOVS
+// Microcoded string instructions; with ERMS/FSRM the CPU picks its own store
+// policy, typically switching to non-temporal protocol for large sizes
+void run_write_stosb(void *dst, size_t size) {
+#ifdef _MSC_VER
+  __stosb(static_cast<unsigned char *>(dst), 0xAA, size);
+#else
+  asm volatile("rep stosb"
+               : "+D"(dst), "+c"(size)
+               : "a"(0xAA)
+               : "memory");
+#endif
+}
+
+void run_copy_movsb(const void *src, void *dst, size_t size) {
+#ifdef _MSC_VER
+  __movsb(static_cast<unsigned char *>(dst),
+          static_cast<const unsigned char *>(src), size);
+#else
+  asm volatile("rep movsb" : "+D"(dst), "+S"(src), "+c"(size) : : "memory");
+#endif
+}
 #endif
 
 // Fallbacks
@@ -160,19 +326,122 @@ void run_copy_fallback(const void *src, void *dst, size_t size) {
   std::memcpy(dst, src, size);
 }
 
+// Kernel dispatch table. All variants are compiled into one binary with
+// per-function target attributes; `supported` checks the running CPU. Within
+// a mode, entries are in order of preference, and the first Read, Write and
+// Copy configs (all threads, then 1 thread) use the first supported one.
+// Write kernels store to `dst`; read kernels ignore it.
+struct SysMemKernel {
+  SysMemTestMode mode;
+  const char *variant;
+  bool (*supported)();
+  void (*run)(const void *src, void *dst, size_t size);
+};
+
+static const SysMemKernel kKernels[] = {
+#ifndef _MSC_VER
+    {SysMemTestMode::Read, "AVX-512", hasAVX512,
+     [](const void *s, void *, size_t n) { run_read_avx512(s, n); }},
+    {SysMemTestMode::Read, "AVX2", hasAVX2,
+     [](const void *s, void *, size_t n) { run_read_avx2(s, n); }},
+#endif
+    {SysMemTestMode::Read, "Scalar", always,
+     [](const void *s, void *, size_t n) { run_read_fallback(s, n); }},
+
+#ifndef _MSC_VER
+    {SysMemTestMode::Write, "AVX-512 NT", hasAVX512,
+     [](const void *, void *d, size_t n) { run_write_avx512(d, n); }},
+    {SysMemTestMode::Write, "AVX2 NT", hasAVX2,
+     [](const void *, void *d, size_t n) { run_write_avx2(d, n); }},
+    {SysMemTestMode::Write, "AVX-512 Temporal", hasAVX512,
+     [](const void *, void *d, size_t n) { run_write_avx512_temporal(d, n); }},
+    {SysMemTestMode::Write, "AVX2 Temporal", hasAVX2,
+     [](const void *, void *d, size_t n) { run_write_avx2_temporal(d, n); }},
+#endif
+#ifdef HAVE_REP_MOVS
+    {SysMemTestMode::Write, "rep stosb", always,
+     [](const void *, void *d, size_t n) { run_write_stosb(d, n); }},
+#endif
+    {SysMemTestMode::Write, "Scalar", always,
+     [](const void *, void *d, size_t n) { run_write_fallback(d, n); }},
+
+#ifndef _MSC_VER
+    {SysMemTestMode::ReadWrite, "AVX-512 NT", hasAVX512, run_copy_avx512},
+    {SysMemTestMode::ReadWrite, "AVX2 NT", hasAVX2, run_copy_avx2},
+    {SysMemTestMode::ReadWrite, "AVX-512 Temporal", hasAVX512,
+     run_copy_avx512_temporal},
+    {SysMemTestMode::ReadWrite, "AVX2 Temporal", hasAVX2,
+     run_copy_avx2_temporal},
+#endif
+#ifdef HAVE_REP_MOVS
+    {SysMemTestMode::ReadWrite, "rep movsb", always, run_copy_movsb},
+#endif
+    {SysMemTestMode::ReadWrite, "memcpy", always, run_copy_fallback},
+};
+
+static constexpr uint32_t kNumKernels =
+    sizeof(kKernels) / sizeof(kKernels[0]);
+
+// First supported kernel for `mode`; the scalar entries always are
+static uint32_t bestKernel(SysMemTestMode mode) {
+  for (uint32_t i = 0; i < kNumKernels; ++i) {
+    if (kKernels[i].mode == mode && kKernels[i].supported())
+      return i;
+  }
+  return 0;
+}
+
+void run_read(const void *src, size_t size) {
+  static const uint32_t kernel = bestKernel(SysMemTestMode::Read);
+  kKernels[kernel].run(src, nullptr, size);
+}
+
+SysMemBandwidthBench::SysMemBandwidthBench() {
+  static const char *modeNames[] = {"Read", "Write", "Copy"};
+  auto name = [](uint32_t kernel, const char *suffix) {
+    const SysMemKernel &k = kKernels[kernel];
+    return std::string(modeNames[static_cast<int>(k.mode)]) + " (" +
+           k.variant + suffix + ")";
+  };
+
+  // The preferred kernel of each mode, named after its variant
+  uint32_t read = bestKernel(SysMemTestMode::Read);
+  uint32_t write = bestKernel(SysMemTestMode::Write);
+  uint32_t copy = bestKernel(SysMemTestMode::ReadWrite);
+
+  configs.push_back({name(read, ""), SysMemTestMode::Read, 0, read});
+  configs.push_back({name(write, ""), SysMemTestMode::Write, 0, write});
+  configs.push_back({name(copy, ""), SysMemTestMode::ReadWrite, 0, copy});
+
+  // Single Threaded (Scaling / Channel Bandwidth approximation)
+  configs.push_back(
+      {name(read, ", 1 Thread"), SysMemTestMode::Read, 1, read});
+  configs.push_back(
+      {name(write, ", 1 Thread"), SysMemTestMode::Write, 1, write});
+  configs.push_back(
+      {name(copy, ", 1 Thread"), SysMemTestMode::ReadWrite, 1, copy});
+
+  // Every other supported kernel on all threads, to compare ISAs and store
+  // policies
+  for (uint32_t i = 0; i < kNumKernels; ++i) {
+    const SysMemKernel &kernel = kKernels[i];
+    if (!kernel.supported() || i == read || i == write || i == copy)
+      continue;
+    configs.push_back({name(i, ""), kernel.mode, 0, i});
+  }
+}
+
 void SysMemBandwidthBench::Run(uint32_t config_idx) {
   if (config_idx >= configs.size())
     return;
 
   const auto &config = configs[config_idx];
-  bool useAVX2 = hasAVX2();
+  const SysMemKernel &kernel = kKernels[config.kernel];
 
   // Determine thread count
-  unsigned int threadCount = config.numThreads;
-  if (threadCount == 0) {
-    threadCount = std::thread::hardware_concurrency();
-    if (threadCount == 0)
-      threadCount = 4; // Fallback
+  unsigned int threadCount = pool->size();
+  if (config.numThreads != 0 && config.numThreads < threadCount) {
+    threadCount = config.numThreads;
   }
 
   // Split buffer among threads
@@ -180,60 +449,28 @@ void SysMemBandwidthBench::Run(uint32_t config_idx) {
   // Align chunk size to 256 bytes (safe for AVX unroll)
   chunkSize = (chunkSize / 256) * 256;
 
-  std::vector<std::thread> threads;
-  std::atomic<int> barrier_counter(0);
+  using Clock = std::chrono::steady_clock;
+  std::vector<Clock::time_point> starts(threadCount), ends(threadCount);
 
-  auto thread_func = [&](int tid) {
+  pool->run(threadCount, [&](unsigned tid) {
     size_t offset = tid * chunkSize;
     char *tSrc = (char *)buffer + offset;
-    char *tDst = (char *)destBuffer + offset;
-
-    // Simple barrier
-    barrier_counter++;
-    while (barrier_counter < (int)threadCount) {
-      std::this_thread::yield();
-    }
-
-#ifndef _MSC_VER
-    if (useAVX2) {
-      if (config.mode == SysMemTestMode::Read) {
-        run_read_avx2(tSrc, chunkSize);
-      } else if (config.mode == SysMemTestMode::Write) {
-        run_write_avx2(tSrc, chunkSize);
-      } else {
-        run_copy_avx2(tSrc, tDst, chunkSize);
-      }
-    } else
-#endif
-    {
-      if (config.mode == SysMemTestMode::Read) {
-        run_read_fallback(tSrc, chunkSize);
-      } else if (config.mode == SysMemTestMode::Write) {
-        run_write_fallback(tSrc, chunkSize);
-      } else {
-        run_copy_fallback(tSrc, tDst, chunkSize);
-      }
-    }
-  };
-
-  auto start = std::chrono::high_resolution_clock::now();
-
-  for (unsigned int i = 0; i < threadCount; ++i) {
-    threads.emplace_back(thread_func, i);
-  }
-
-  for (auto &t : threads) {
-    t.join();
-  }
-
-  auto end = std::chrono::high_resolution_clock::now();
-
-  double elapsedMs =
-      std::chrono::duration_cast<std::chrono::microseconds>(end - start)
-          .count() /
-      1000.0;
+    // Only allocated when a Copy config is selected
+    char *tDst = destBuffer ? (char *)destBuffer + offset : nullptr;
+
+    starts[tid] = Clock::now();
+    // Write kernels overwrite the source buffer
+    kernel.run(tSrc, config.mode == SysMemTestMode::Write ? tSrc : tDst,
+               chunkSize);
+    ends[tid] = Clock::now();
+  });
+
+  // Aggregate bandwidth over the window in which any thread was copying
+  Clock::time_point first = *std::min_element(starts.begin(), starts.end());
+  Clock::time_point last = *std::max_element(ends.begin(), ends.end());
+  lastRunTimeMs =
+      std::chrono::duration<double, std::milli>(last - first).count();
 
-  lastRunTimeMs = elapsedMs;
   // Calculate bytes transferred
   uint64_t totalBytes = chunkSize * threadCount;
   if (config.mode == SysMemTestMode::ReadWrite) {
@@ -243,6 +480,7 @@ void SysMemBandwidthBench::Run(uint32_t config_idx) {
 }
 
 void SysMemBandwidthBench::Teardown() {
+  pool.reset();
   if (buffer) {
     ALIGNED_FREE(buffer);
     buffer = nullptr;
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "benchmarks/IBenchmark.h"
+#include "utils/PinnedThreadPool.h"
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -10,6 +12,7 @@ struct SysMemConfig {
   std::string name;
   SysMemTestMode mode;
   uint32_t numThreads = 0; // 0 = Auto/Max
+  uint32_t kernel = 0;     // Index into the kernel dispatch table
 };
 
 class SysMemBandwidthBench : public IBenchmark {
@@ -29,6 +32,11 @@ public:
   void Run(uint32_t config_idx = 0) override;
   void Teardown() override;
   BenchmarkResult GetResult(uint32_t config_idx = 0) const override;
+  // Run() times only the copy loops, from the first thread's start to the
+  // last thread's end
+  double GetDeviceTimeMs(uint32_t config_idx) const override {
+    return lastRunTimeMs;
+  }
   const char *GetComponent(uint32_t config_idx = 0) const override {
     return "Memory";
   }
@@ -51,6 +59,7 @@ private:
   void *buffer = nullptr;
   void *destBuffer = nullptr; // For ReadWrite/Copy
   size_t bufferSize = 0;
+  std::unique_ptr<utils::PinnedThreadPool> pool;
 
   // Results
   double lastRunTimeMs = 0.0;
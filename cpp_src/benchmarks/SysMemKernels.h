@@ -0,0 +1,8 @@
+#pragma once
+
+#include <cstddef>
+
+// Host streaming kernels, defined in SysMemBandwidthBench.cpp. Each covers
+// [ptr, ptr + size) with size a multiple of 256 and ptr 64-byte aligned, and
+// picks the widest ISA the CPU supports.
+void run_read(const void *src, size_t size);
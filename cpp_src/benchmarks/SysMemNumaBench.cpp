@@ -0,0 +1,191 @@
+#include "benchmarks/SysMemNumaBench.h"
+#include "benchmarks/SysMemKernels.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <malloc.h>
+#define ALIGNED_ALLOC(alignment, size) _aligned_malloc(size, alignment)
+#define ALIGNED_FREE(ptr) _aligned_free(ptr)
+#else
+#define ALIGNED_ALLOC(alignment, size) aligned_alloc(alignment, size)
+#define ALIGNED_FREE(ptr) free(ptr)
+#endif
+
+// Pages are bound before they are touched, so buffers start on a huge page
+// boundary
+static constexpr size_t kBufferAlignment = 2 * 1024 * 1024;
+static constexpr size_t kLineSize = 64;
+static constexpr uint64_t kLatencyHops = 1000000;
+
+SysMemNumaBench::SysMemNumaBench() : nodes(utils::numaNodes()) {
+  for (bool latency : {false, true}) {
+    for (int c = 0; c < (int)nodes.size(); ++c) {
+      if (nodes[c].cpus.empty())
+        continue;
+      for (int m = 0; m < (int)nodes.size(); ++m) {
+        if (nodes[m].hasMemory)
+          configs.push_back({latency, c, m});
+      }
+    }
+  }
+}
+
+SysMemNumaBench::~SysMemNumaBench() { Teardown(); }
+
+const char *SysMemNumaBench::GetMetric(uint32_t config_idx) const {
+  return config_idx < configs.size() && configs[config_idx].latency ? "ns"
+                                                                    : "GB/s";
+}
+
+const char *SysMemNumaBench::GetSubCategory(uint32_t config_idx) const {
+  return config_idx < configs.size() && configs[config_idx].latency
+             ? "Latency"
+             : "Bandwidth";
+}
+
+std::string SysMemNumaBench::nodeLabel(int node) const {
+  std::string label = "N" + std::to_string(nodes[node].id);
+  auto it = gpusByNode.find(node);
+  if (it != gpusByNode.end()) {
+    label += " (GPU";
+    for (size_t i = 0; i < it->second.size(); ++i)
+      label += (i ? "," : " ") + std::to_string(it->second[i]);
+    label += ")";
+  }
+  return label;
+}
+
+std::string SysMemNumaBench::GetConfigName(uint32_t config_idx) const {
+  if (config_idx >= configs.size())
+    return "Invalid";
+  const auto &config = configs[config_idx];
+  return std::string(config.latency ? "Latency " : "Read ") +
+         nodeLabel(config.cpuNode) + " -> " + nodeLabel(config.memNode);
+}
+
+void SysMemNumaBench::Setup(IComputeContext &context,
+                            const std::string &kernel_dir) {
+  // 512MB per node to bypass CPU caches (including large L3)
+  bufferSize = 512ULL * 1024ULL * 1024ULL;
+  buffers.assign(nodes.size(), nullptr);
+
+  gpusByNode.clear();
+  const auto &devices = context.getDevices();
+  for (uint32_t i = 0; i < devices.size(); ++i) {
+    int numaNode = utils::pciNumaNode(devices[i].pciBusId);
+    for (int n = 0; n < (int)nodes.size(); ++n) {
+      if (nodes[n].id == numaNode)
+        gpusByNode[n].push_back(i);
+    }
+  }
+
+  std::vector<int> cpus;
+  workerBegin.clear();
+  for (const auto &node : nodes) {
+    workerBegin.push_back(static_cast<unsigned>(cpus.size()));
+    cpus.insert(cpus.end(), node.cpus.begin(), node.cpus.end());
+  }
+  workerBegin.push_back(static_cast<unsigned>(cpus.size()));
+  pool = std::make_unique<utils::PinnedThreadPool>(cpus);
+}
+
+char *SysMemNumaBench::nodeBuffer(int node) {
+  if (buffers[node])
+    return buffers[node];
+
+  char *buffer = static_cast<char *>(ALIGNED_ALLOC(kBufferAlignment, bufferSize));
+  if (!buffer) {
+    throw std::runtime_error("Failed to allocate system memory buffer for " +
+                             nodeLabel(node));
+  }
+  // On a single node there is nothing to bind to, and containers often
+  // forbid mbind
+  if (nodes.size() > 1 &&
+      !utils::bindMemoryToNode(buffer, bufferSize, nodes[node].id)) {
+    ALIGNED_FREE(buffer);
+    throw std::runtime_error("Failed to bind memory to NUMA node " +
+                             std::to_string(nodes[node].id));
+  }
+
+  // Pointer-chasing chain through every cache line in random order; the
+  // read kernel doesn't care about the contents
+  uint32_t numLines = (uint32_t)(bufferSize / kLineSize);
+  std::vector<uint32_t> lines(numLines);
+  std::iota(lines.begin(), lines.end(), 0);
+  std::mt19937 g(12345);
+  std::shuffle(lines.begin(), lines.end(), g);
+  for (uint32_t i = 0; i < numLines; ++i) {
+    uint32_t next = lines[(i + 1) % numLines];
+    *reinterpret_cast<uint64_t *>(buffer + (size_t)lines[i] * kLineSize) =
+        (uint64_t)next * kLineSize;
+  }
+
+  buffers[node] = buffer;
+  return buffer;
+}
+
+void SysMemNumaBench::Run(uint32_t config_idx) {
+  if (config_idx >= configs.size())
+    return;
+  const auto &config = configs[config_idx];
+  char *buffer = nodeBuffer(config.memNode);
+
+  unsigned begin = workerBegin[config.cpuNode];
+  unsigned end = workerBegin[config.cpuNode + 1];
+  using Clock = std::chrono::steady_clock;
+
+  if (config.latency) {
+    // One CPU of the node, one dependent load per hop
+    Clock::time_point start, stop;
+    uint64_t offset = 0;
+    pool->run(begin, begin + 1, [&](unsigned tid) {
+      start = Clock::now();
+      for (uint64_t i = 0; i < kLatencyHops; ++i) {
+        offset = *reinterpret_cast<const volatile uint64_t *>(buffer + offset);
+      }
+      stop = Clock::now();
+    });
+    volatile uint64_t sink = offset;
+    (void)sink;
+    lastRunTimeMs = std::chrono::duration<double, std::milli>(stop - start).count();
+    lastRunOps = kLatencyHops;
+    return;
+  }
+
+  // Every CPU of the node reads its share of the buffer
+  unsigned threadCount = end - begin;
+  size_t chunkSize = (bufferSize / threadCount / 256) * 256;
+  std::vector<Clock::time_point> starts(threadCount), ends(threadCount);
+
+  pool->run(begin, end, [&](unsigned tid) {
+    unsigned t = tid - begin;
+    starts[t] = Clock::now();
+    run_read(buffer + t * chunkSize, chunkSize);
+    ends[t] = Clock::now();
+  });
+
+  // Aggregate bandwidth over the window in which any thread was reading
+  Clock::time_point first = *std::min_element(starts.begin(), starts.end());
+  Clock::time_point last = *std::max_element(ends.begin(), ends.end());
+  lastRunTimeMs = std::chrono::duration<double, std::milli>(last - first).count();
+  lastRunOps = chunkSize * threadCount;
+}
+
+void SysMemNumaBench::Teardown() {
+  pool.reset();
+  for (char *&buffer : buffers) {
+    if (buffer) {
+      ALIGNED_FREE(buffer);
+      buffer = nullptr;
+    }
+  }
+}
+
+BenchmarkResult SysMemNumaBench::GetResult(uint32_t config_idx) const {
+  return {lastRunOps, lastRunTimeMs};
+}
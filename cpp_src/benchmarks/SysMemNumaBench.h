@@ -0,0 +1,80 @@
+#pragma once
+
+#include "benchmarks/IBenchmark.h"
+#include "utils/Numa.h"
+#include "utils/PinnedThreadPool.h"
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+struct SysMemNumaConfig {
+  bool latency;
+  int cpuNode; // Index into nodes
+  int memNode;
+};
+
+// Node-to-node system memory matrix: read bandwidth with every CPU of one
+// NUMA node reading memory bound to another, and pointer-chase latency from
+// one CPU of the node. Rows are named "Read N<cpu> -> N<mem>" and
+// "Latency N<cpu> -> N<mem>"; once Setup() has seen the devices of the
+// context, nodes local to a GPU (from its PCI address) carry the GPU indices,
+// e.g. "N1 (GPU 0)".
+class SysMemNumaBench : public IBenchmark {
+public:
+  SysMemNumaBench();
+  ~SysMemNumaBench() override;
+
+  const char *GetName() const override { return "System Memory NUMA"; }
+  std::vector<std::string> GetAliases() const override {
+    return {"numa", "sysmem_numa"};
+  }
+  const char *GetMetric() const override { return "GB/s"; }
+  const char *GetMetric(uint32_t config_idx) const override;
+  bool IsSupported(const DeviceInfo &info,
+                   IComputeContext *context = nullptr) const override {
+    return true;
+  }
+
+  void Setup(IComputeContext &context, const std::string &kernel_dir) override;
+  void Run(uint32_t config_idx = 0) override;
+  void Teardown() override;
+  BenchmarkResult GetResult(uint32_t config_idx = 0) const override;
+  // Run() times only the measured loops
+  double GetDeviceTimeMs(uint32_t config_idx) const override {
+    return lastRunTimeMs;
+  }
+  const char *GetComponent(uint32_t config_idx = 0) const override {
+    return "Memory";
+  }
+  const char *GetSubCategory(uint32_t config_idx = 0) const override;
+  int GetSortWeight() const override { return 450; }
+  uint32_t GetNumConfigs() const override {
+    return static_cast<uint32_t>(configs.size());
+  }
+  std::string GetConfigName(uint32_t config_idx) const override;
+
+  // System benchmark is not tied to a specific GPU
+  bool IsDeviceDependent() const override { return false; }
+
+private:
+  std::string nodeLabel(int node) const;
+  // Buffer bound to nodes[node], allocated and filled on first use
+  char *nodeBuffer(int node);
+
+  std::vector<utils::NumaNode> nodes;
+  std::vector<SysMemNumaConfig> configs;
+  // Node index -> indices of the context's GPUs attached to it
+  std::map<int, std::vector<uint32_t>> gpusByNode;
+
+  // One worker per CPU, grouped by node: node i owns workers
+  // [workerBegin[i], workerBegin[i + 1])
+  std::unique_ptr<utils::PinnedThreadPool> pool;
+  std::vector<unsigned> workerBegin;
+
+  std::vector<char *> buffers; // Per node
+  size_t bufferSize = 0;
+
+  double lastRunTimeMs = 0.0;
+  uint64_t lastRunOps = 0;
+};
@@ -1,46 +1,22 @@
 #include "core/BenchmarkRunner.h"
+#include "benchmarks/BenchmarkRegistry.h"
 #include "benchmarks/CacheBench.h"
-#include "benchmarks/Fp16Bench.h"
-#include "benchmarks/Bf16Bench.h"
-#include "benchmarks/Fp32Bench.h"
-#include "benchmarks/Fp4Bench.h"
-#include "benchmarks/Fp64Bench.h"
-#include "benchmarks/Fp8Bench.h"
-#include "benchmarks/Int4Bench.h"
-#include "benchmarks/Int8Bench.h"
 #include "benchmarks/MemBandwidthBench.h"
-#include "benchmarks/RayAnyHitBench.h"
-#include "benchmarks/RayASBuildBench.h"
-#include "benchmarks/RayDivergenceBench.h"
-#include "benchmarks/RayIncoherentBench.h"
-#include "benchmarks/RayMaterialDivergenceBench.h"
-#include "benchmarks/RayPayloadBench.h"
-#include "benchmarks/RayProceduralBench.h"
-#include "benchmarks/RayTracingBench.h"
-#include "benchmarks/SysMemBandwidthBench.h"
-#include "benchmarks/SysMemLatencyBench.h"
 #include "core/ComputeBackendFactory.h"
 #include "core/ResultFormatter.h"
 #include "utils/KernelPath.h"
-// #include "benchmarks/Fp6Bench.h" // Temporarily disabled
+#include "utils/ShaderCache.h"
+#include "utils/ThreadPool.h"
 #include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <cmath>
+#include <deque>
 #include <iostream>
 #include <locale>
-#include <numeric>
-#include <random>
 #include <string>
 #include <thread>
 
-// Helper function to create a shuffled index array for pointer chasing
-std::vector<uint32_t> create_shuffled_indices(size_t size) {
-  std::vector<uint32_t> indices(size);
-  std::iota(indices.begin(), indices.end(), 0);
-  std::mt19937 g(1337); // Use a fixed seed for reproducibility
-  std::shuffle(indices.begin(), indices.end(), g);
-  return indices;
-}
-
 BenchmarkRunner::BenchmarkRunner(const std::vector<IComputeContext *> &contexts,
                                  bool verbose, bool debug, bool dumpGeometry)
     : contexts(contexts), verbose(verbose), debug(debug),
@@ -48,7 +24,6 @@ BenchmarkRunner::BenchmarkRunner(const std::vector<IComputeContext *> &contexts,
   for (auto *context : contexts) {
     context->setVerbose(verbose);
   }
-  discoverBenchmarks();
   formatter = std::make_unique<ResultFormatter>();
 }
 
@@ -56,8 +31,8 @@ BenchmarkRunner::~BenchmarkRunner() {}
 
 std::vector<std::string> BenchmarkRunner::getAvailableBenchmarks() const {
   std::vector<std::string> names;
-  for (const auto &bench : benchmarks) {
-    names.push_back(bench->GetName());
+  for (const auto &desc : BenchmarkRegistry::all()) {
+    names.push_back(desc.name);
   }
   return names;
 }
@@ -66,88 +41,12 @@ const std::vector<ResultData>& BenchmarkRunner::getResults() const {
   return formatter->getResults();
 }
 
-void BenchmarkRunner::discoverBenchmarks() {
-  benchmarks.push_back(std::make_unique<Fp64Bench>());
-  benchmarks.push_back(std::make_unique<Fp32Bench>());
-  benchmarks.push_back(std::make_unique<Fp16Bench>());
-  benchmarks.push_back(std::make_unique<Bf16Bench>());
-  benchmarks.push_back(std::make_unique<Fp8Bench>());
-  // benchmarks.push_back(std::make_unique<Fp6Bench>()); // Temporarily disabled
-  benchmarks.push_back(std::make_unique<Fp4Bench>());
-  benchmarks.push_back(std::make_unique<Int8Bench>());
-  benchmarks.push_back(std::make_unique<Int4Bench>());
-  benchmarks.push_back(std::make_unique<MemBandwidthBench>());
-  benchmarks.push_back(std::make_unique<SysMemBandwidthBench>());
-  benchmarks.push_back(std::make_unique<SysMemLatencyBench>());
-  benchmarks.push_back(std::make_unique<RayTracingBench>());
-  benchmarks.push_back(std::make_unique<RayDivergenceBench>());
-  benchmarks.push_back(std::make_unique<RayAnyHitBench>());
-  benchmarks.push_back(std::make_unique<RayIncoherentBench>());
-  benchmarks.push_back(std::make_unique<RayPayloadBench>());
-  benchmarks.push_back(std::make_unique<RayASBuildBench>());
-  benchmarks.push_back(std::make_unique<RayProceduralBench>());
-  benchmarks.push_back(std::make_unique<RayMaterialDivergenceBench>());
-
-  // Cache Bandwidth
-  const size_t l0_size = 16 * 1024; // 16KB L0 cache
-  std::vector<uint32_t> l0_init(l0_size / sizeof(uint32_t));
-  std::iota(l0_init.begin(), l0_init.end(), 0);
-
-  // Cache Bandwidth is currently difficult to measure reliably because shader compilers
-  // aggressively optimize out the memory reading loops via Dead-Code Elimination. 
-  // We've disabled these by default until a more robust measurement technique is implemented.
-  /*
-  benchmarks.push_back(std::make_unique<CacheBench>(
-      "L0 Cache Bandwidth", "GB/s", l0_size, "cache_bw_robust", l0_init,
-      std::vector<std::string>{"l0b"}, 0));
-
-  // Define target cache sizes for isolation
-  const size_t l1_size = 128 * 1024;       // 128KB
-  const size_t l2_size = 4 * 1024 * 1024;  // 4MB
-  const size_t l3_size = 64 * 1024 * 1024; // 64MB
-
-  // For cachebw_l1 (L1 cache), allocate 2MB (enough for the access pattern)
-  size_t cachebw_l1_size = 2 * 1024 * 1024;
-  std::vector<uint32_t> l1_bw_init(cachebw_l1_size / sizeof(uint32_t), 1);
-
-  // L1 Cache Bandwidth
-  benchmarks.push_back(std::make_unique<CacheBench>(
-      "L1 Cache Bandwidth", "GB/s", l1_size, "cache_bw_robust",
-      std::vector<uint32_t>{}, std::vector<std::string>{"l1b"}, 1));
-
-  // L2 Cache Bandwidth
-  benchmarks.push_back(std::make_unique<CacheBench>(
-      "L2 Cache Bandwidth", "GB/s", l2_size, "cache_bw_robust",
-      std::vector<uint32_t>{}, std::vector<std::string>{"l2b"}, 2));
-
-  // L3 Cache Bandwidth
-  benchmarks.push_back(std::make_unique<CacheBench>(
-      "L3 Cache Bandwidth", "GB/s", l3_size, "cache_bw_robust",
-      std::vector<uint32_t>{}, std::vector<std::string>{"l3b"}, 3));
-  */
-
-  // We still need the sizes for latency tests
-  const size_t l1_size = 128 * 1024;       // 128KB
-  const size_t l2_size = 4 * 1024 * 1024;  // 4MB
-  const size_t l3_size = 64 * 1024 * 1024; // 64MB
-
-  // Cache Latency
-  benchmarks.push_back(std::make_unique<CacheBench>(
-      "L0 Cache Latency", "ns", l0_size, "l0_cache_latency",
-      create_shuffled_indices(l0_size / sizeof(uint32_t)),
-      std::vector<std::string>{"l0l"}, 0));
-  benchmarks.push_back(std::make_unique<CacheBench>(
-      "L1 Cache Latency", "ns", l1_size, "cache_latency",
-      create_shuffled_indices(l1_size / sizeof(uint32_t)),
-      std::vector<std::string>{"l1l"}));
-  benchmarks.push_back(std::make_unique<CacheBench>(
-      "L2 Cache Latency", "ns", l2_size, "cache_latency",
-      create_shuffled_indices(l2_size / sizeof(uint32_t)),
-      std::vector<std::string>{"l2l"}));
-  benchmarks.push_back(std::make_unique<CacheBench>(
-      "L3 Cache Latency", "ns", l3_size, "cache_latency",
-      create_shuffled_indices(l3_size / sizeof(uint32_t)),
-      std::vector<std::string>{"l3l"}));
+void BenchmarkRunner::publishResult(const ResultData &result) {
+  formatter->addResult(result);
+  if (onResult) {
+    std::lock_guard<std::mutex> lock(resultMutex);
+    onResult(result);
+  }
 }
 
 struct BenchmarkResultRow {
@@ -156,58 +55,344 @@ struct BenchmarkResultRow {
   std::string unit;
 };
 
-// Helper to lowercase a string
-static std::string to_lower(std::string s) {
-  std::transform(s.begin(), s.end(), s.begin(),
-                 [](unsigned char c) { return std::tolower(c); });
-  return s;
+// Auto batching aims for submissions of about this length, long enough that
+// submit and sync overhead (tens of microseconds) is lost in the noise while
+// staying far from the TDR limits checked below.
+static constexpr double kAutoBatchTargetMs = 10.0;
+static constexpr uint32_t kMaxAutoBatch = 256;
+
+static void applySampleStats(ResultData &result, const SampleStats &stats) {
+  result.sampleCount = stats.count;
+  result.median_ms = stats.median;
+  result.mean_ms = stats.mean;
+  result.stddev_ms = stats.stddev;
+  result.min_ms = stats.min;
+  result.p95_ms = stats.p95;
+  result.p99_ms = stats.p99;
 }
 
-void BenchmarkRunner::run(const std::vector<std::string> &benchmarks_to_run) {
-  std::vector<std::string> lower_benchmarks_to_run;
-  for (const auto &b : benchmarks_to_run) {
-    lower_benchmarks_to_run.push_back(to_lower(b));
+// Compiles every planned kernel of every device on one pool before any
+// Setup() runs, so the createKernel() calls in Setup() hit the shader cache
+// (and, on Vulkan, adopt pipelines built here) instead of compiling one
+// shader after another. Failures are left for Setup() to report.
+void BenchmarkRunner::compileAhead(const ExecutionPlan &plan) {
+  size_t total = 0;
+  for (const auto &device : plan.devices())
+    total += device.kernels.size();
+  if (total == 0)
+    return;
+
+  auto start = std::chrono::steady_clock::now();
+  std::atomic<uint32_t> failed{0};
+  std::mutex logMutex;
+  {
+    utils::ThreadPool pool(static_cast<unsigned>(
+        std::min<size_t>(std::thread::hardware_concurrency(), total)));
+    for (const auto &device : plan.devices()) {
+      for (const auto &source : device.kernels) {
+        pool.submit([this, &device, &source, &failed, &logMutex]() {
+          try {
+            device.context->precompileKernel(source);
+          } catch (const std::exception &e) {
+            failed++;
+            if (verbose) {
+              std::lock_guard<std::mutex> lock(logMutex);
+              std::cerr << "Compile-ahead of " << source.file
+                        << " failed: " << e.what() << std::endl;
+            }
+          }
+        });
+      }
+    }
+    pool.wait();
   }
+  utils::ShaderCache::flush();
 
-  int totalSelected = contexts.size();
-  int totalAvailable = 0;
+  if (verbose) {
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                  std::chrono::steady_clock::now() - start)
+                  .count();
+    std::cout << "Compiled " << (total - failed) << "/" << total
+              << " kernel(s) ahead of setup in " << ms << " ms" << std::endl;
+  }
+}
 
-  // Check if we need to run any device-dependent benchmarks
-  bool hasDeviceBenchmarks = false;
-  for (const auto &bench : benchmarks) {
-    if (!bench->IsDeviceDependent())
-      continue;
+void BenchmarkRunner::runOnDevice(
+    const DevicePlan &device,
+    std::vector<std::unique_ptr<IBenchmark>> &benches) {
+  IComputeContext *context = device.context;
+  try {
+    // With --parallel-devices this runs on a worker thread
+    context->bindToCurrentThread();
+    const DeviceInfo &info = device.info;
+    if (verbose) {
+        std::cout << " [Device " << context->getSelectedDeviceIndex() << "] "
+                  << info.name << " ("
+                  << ComputeBackendFactory::getBackendName(
+                         context->getBackend())
+                  << ")" << std::endl;
+        std::cout << "  - VRAM:         "
+                  << static_cast<int>(std::round(info.memorySize /
+                                                 (1024.0 * 1024.0 * 1024.0)))
+                  << " GB" << std::endl;
+        std::cout << "  - Subgroup:     " << info.subgroupSize << " threads"
+                  << std::endl;
+        std::cout << "  - Shared Memory: "
+                  << (info.maxComputeSharedMemorySize / 1024) << " KB"
+                  << std::endl;
+        std::cout << std::endl;
+    }
 
-    bool should_run = false;
-    if (benchmarks_to_run.empty()) {
-      should_run = true;
-    } else {
-      std::string bench_name = bench->GetName();
-      if (bench_name == "Performance") {
-        bench_name += " (" + std::string(bench->GetSubCategory()) + ")";
+    context->setExpectedKernelCount(device.expectedKernelCount);
+
+    size_t position = 0;
+    for (const auto &planned : device.benchmarks) {
+      auto &bench = benches[planned.index];
+      ++position;
+      if (dumpGeometry) {
+        bench->DumpGeometry();
       }
-      std::string bench_name_lower = to_lower(bench_name);
-      auto aliases = bench->GetAliases();
-      for (const auto &run_name : lower_benchmarks_to_run) {
-        if (bench_name_lower.find(run_name) != std::string::npos) {
-          should_run = true;
-          break;
+
+      // Host-contended benchmarks run one at a time across device workers
+      std::unique_lock<std::mutex> hostLock(hostContendedMutex,
+                                            std::defer_lock);
+      if (serializeHostContended && bench->IsHostContended()) {
+        hostLock.lock();
+      }
+
+      try {
+        // Set debug flag for benchmarks
+        if (auto *membw =
+                dynamic_cast<MemBandwidthBench *>(bench.get())) {
+          membw->setDebug(debug);
+        } else if (auto *cache =
+                       dynamic_cast<CacheBench *>(bench.get())) {
+          cache->setDebug(debug);
         }
-        for (const auto &alias : aliases) {
-          if (to_lower(alias) == run_name) {
-            should_run = true;
-            break;
+
+        if (verbose) {
+          std::cout << "Setting up " << bench->GetName() << "..."
+                    << std::endl;
+        }
+        bench->Setup(*context, KernelPath::find());
+
+        uint32_t num_configs = bench->GetNumConfigs();
+
+        // For Memory Bandwidth tests in non-verbose mode, print a single
+        // summary message For Memory Bandwidth tests in non-verbose mode,
+        // we don't need a separate message as the individual configs will
+        // print updates via \r
+        bool is_membw =
+            (std::string(bench->GetName()) == "Memory Bandwidth");
+
+        for (uint32_t i = 0; i < num_configs; ++i) {
+          std::string bench_name = bench->GetName();
+          std::string config_name = bench->GetConfigName(i);
+          if (!planned.configs.matches(i, config_name))
+            continue;
+          if (!config_name.empty()) {
+            bench_name += " (" + config_name + ")";
+          }
+
+          // Only print individual "Running..." messages in verbose mode
+          if (verbose) {
+            std::cout << "[D" << context->getSelectedDeviceIndex() << " "
+                      << position << "/" << device.benchmarks.size()
+                      << "] Running " << bench_name << "..." << std::endl;
+          }
+
+          // One iteration = Run() + waitIdle(). host_ms is wall time,
+          // iter_ms the device time if the backend or benchmark can
+          // measure it (host time otherwise). Returns false if the
+          // dispatch got dangerously close to the driver TDR timeout.
+          bool deviceTimed = false;
+          double host_ms = 0;
+          double host_total_ms = 0;
+          auto timeIteration = [&](double &iter_ms) {
+            auto iter_start = context->now();
+            context->beginTiming();
+            bench->Run(i);
+            context->endTiming();
+            context->waitIdle();
+            auto iter_end = context->now();
+            host_ms =
+                std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    iter_end - iter_start)
+                    .count() /
+                1e6;
+            double device_ms = context->getTimingResult();
+            double bench_ms = bench->GetDeviceTimeMs(i);
+            if (bench_ms >= 0.0) {
+              device_ms = bench_ms;
+              deviceTimed = true;
+            } else {
+              deviceTimed = context->hasDeviceTimer() && device_ms > 0.0;
+            }
+            iter_ms = deviceTimed ? device_ms : host_ms;
+            if (verbose && host_ms > 500.0) {
+              std::cerr
+                  << "\n[WARNING] Single dispatch took " << host_ms
+                  << " ms — approaching amdgpu TDR timeout!" << std::endl;
+            }
+            if (host_ms > 3000.0) {
+              std::cerr
+                  << "\n[ABORT] Dispatch took " << host_ms
+                  << " ms — aborting benchmark to avoid system crash."
+                  << std::endl;
+              return false;
+            }
+            return true;
+          };
+
+          // Untimed warm-up until iteration times stop improving
+          WarmupDetector warmup(samplingPolicy);
+          bool aborted = false;
+          double iter_ms = 0;
+          while (!warmup.isWarm()) {
+            if (!timeIteration(iter_ms)) {
+              aborted = true;
+              break;
+            }
+            warmup.add(iter_ms);
+          }
+          if (verbose) {
+            std::cout << "[D" << context->getSelectedDeviceIndex()
+                      << "]   warm-up: " << warmup.iterations()
+                      << " iterations, " << warmup.elapsedMs() << " ms"
+                      << std::endl;
+          }
+
+          // Short dispatches mostly measure submission cost; batch them
+          uint32_t batch = 1;
+          if (!aborted && bench->SupportsBatching()) {
+            if (batchSize > 0) {
+              batch = batchSize;
+            } else if (host_ms > 0.0 && host_ms < kAutoBatchTargetMs) {
+              batch = static_cast<uint32_t>(std::min<double>(
+                  std::ceil(kAutoBatchTargetMs / host_ms), kMaxAutoBatch));
+            }
+            bench->SetBatchSize(batch);
+            if (verbose && batch > 1) {
+              std::cout << "[D" << context->getSelectedDeviceIndex()
+                        << "]   batch: " << batch
+                        << " dispatches per submission" << std::endl;
+            }
           }
+
+          // Sampled run
+          SampleCollector sampler(samplingPolicy);
+          double elapsed_ms = 0;
+          bool pipelined = !aborted && inFlight > 1 &&
+                           bench->SupportsBatching() &&
+                           context->hasAsyncDispatch();
+          if (pipelined) {
+            // Keep inFlight submissions queued so the device never idles.
+            // A sample is the interval between consecutive completions, i.e.
+            // the sustained rate; the first one still includes the ramp-up.
+            deviceTimed = false;
+            std::deque<DispatchHandle> queue;
+            for (uint32_t d = 0; d < inFlight; ++d) {
+              queue.push_back(bench->RunAsync(i));
+            }
+            auto last = context->now();
+            bool first = true;
+            while (!sampler.shouldStop(elapsed_ms)) {
+              context->wait(queue.front());
+              auto now = context->now();
+              queue.pop_front();
+              queue.push_back(bench->RunAsync(i));
+              host_ms = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            now - last)
+                            .count() /
+                        1e6;
+              last = now;
+              if (first) {
+                first = false;
+                continue;
+              }
+              if (host_ms > 3000.0) {
+                std::cerr << "\n[ABORT] Dispatch took " << host_ms
+                          << " ms — aborting benchmark to avoid system crash."
+                          << std::endl;
+                break;
+              }
+              sampler.add(host_ms / batch);
+              elapsed_ms += host_ms;
+              host_total_ms += host_ms / batch;
+            }
+            context->waitIdle();
+          } else {
+            while (!aborted && !sampler.shouldStop(elapsed_ms)) {
+              if (!timeIteration(iter_ms))
+                break;
+              sampler.add(iter_ms / batch);
+              elapsed_ms += host_ms;
+              host_total_ms += host_ms / batch;
+            }
+          }
+          SampleStats stats = sampler.finalize();
+          bench->SetBatchSize(1);
+
+          BenchmarkResult bench_result = bench->GetResult(i);
+
+          ResultData result_data;
+          result_data.backendName = ComputeBackendFactory::getBackendName(
+              context->getBackend());
+          result_data.deviceName = info.name;
+          result_data.benchmarkName = bench_name;
+          result_data.metric = bench->GetMetric(i);
+          result_data.operations =
+              bench_result.operations * stats.count;
+          result_data.time_ms = stats.total;
+          result_data.isEmulated = bench->IsEmulated(i);
+          result_data.component = bench->GetComponent(i);
+          result_data.subcategory = bench->GetSubCategory(i);
+          result_data.maxWorkGroupSize = info.maxWorkGroupSize;
+          result_data.deviceIndex = context->getSelectedDeviceIndex();
+          result_data.configIndex = i;
+          result_data.sortWeight = bench->GetSortWeight();
+          applySampleStats(result_data, stats);
+          result_data.warmupIterations = warmup.iterations();
+          result_data.warmup_ms = warmup.elapsedMs();
+          result_data.host_time_ms = host_total_ms;
+          result_data.device_time_ms = deviceTimed ? stats.total : 0.0;
+          result_data.deviceTimed = deviceTimed;
+          result_data.batchSize = batch;
+
+          publishResult(result_data);
+        }
+
+        bench->Teardown();
+        context->sleepFor(std::chrono::milliseconds(1000));
+      } catch (const std::exception &e) {
+        if (verbose) {
+            std::cerr << "Error running " << bench->GetName() << ": "
+                      << e.what() << std::endl;
+        }
+        // Make sure to clean up
+        try {
+          bench->Teardown();
+        } catch (...) {
+          // Ignore errors during cleanup
         }
       }
     }
+  } catch (const std::exception &e) {
+    std::cerr << "Error processing device: " << e.what() << std::endl;
+  }
+}
 
-    if (should_run) {
-      hasDeviceBenchmarks = true;
-      break;
-    }
+void BenchmarkRunner::run(const std::vector<std::string> &benchmarks_to_run) {
+  // Selection, support checks and kernel counts are resolved once up front
+  ExecutionPlan plan = ExecutionPlan::build(contexts, benchmarks_to_run);
+  if (dryRun) {
+    plan.print(std::cout, samplingPolicy, parallelDevices);
+    return;
   }
 
+  int totalAvailable = 0;
+  bool hasDeviceBenchmarks = plan.hasDeviceWork();
+
   std::vector<ComputeBackend> countedBackends;
 
   if (hasDeviceBenchmarks) {
@@ -260,321 +445,148 @@ void BenchmarkRunner::run(const std::vector<std::string> &benchmarks_to_run) {
       std::cout << "Selected execution targets:" << std::endl;
     }
 
-    for (auto *context : contexts) {
-      if (!context->isAvailable())
-        continue;
-      try {
-        DeviceInfo info = context->getCurrentDeviceInfo();
-        if (verbose) {
-            std::cout << " [Device " << context->getSelectedDeviceIndex() << "] "
-                      << info.name << " ("
-                      << ComputeBackendFactory::getBackendName(
-                             context->getBackend())
-                      << ")" << std::endl;
-            std::cout << "  - VRAM:         "
-                      << static_cast<int>(std::round(info.memorySize /
-                                                     (1024.0 * 1024.0 * 1024.0)))
-                      << " GB" << std::endl;
-            std::cout << "  - Subgroup:     " << info.subgroupSize << " threads"
-                      << std::endl;
-            std::cout << "  - Shared Memory: "
-                      << (info.maxComputeSharedMemorySize / 1024) << " KB"
-                      << std::endl;
-            std::cout << std::endl;
-        }
-
-        // Calculate total expected kernels for progress bar
-        uint32_t totalKernels = 0;
-        for (auto &bench : benchmarks) {
-          bool should_run = false;
-          if (benchmarks_to_run.empty()) {
-            should_run = true;
-          } else {
-            std::string bench_name_lower = to_lower(bench->GetName());
-            if (bench_name_lower == "performance") {
-              bench_name_lower +=
-                  " (" + to_lower(std::string(bench->GetSubCategory())) + ")";
-            }
-            auto aliases = bench->GetAliases();
-            for (const auto &run_name : lower_benchmarks_to_run) {
-              if (bench_name_lower.find(run_name) != std::string::npos) {
-                should_run = true;
-                break;
-              }
-              for (const auto &alias : aliases) {
-                if (to_lower(alias) == run_name) {
-                  should_run = true;
-                  break;
-                }
-              }
-            }
-          }
-          if (should_run && bench->IsSupported(info, context) &&
-              bench->IsDeviceDependent()) {
-            totalKernels += bench->GetExpectedKernelCount();
-          }
-        }
-        context->setExpectedKernelCount(totalKernels);
-
-        for (auto &bench : benchmarks) {
-          bool should_run = false;
-          if (benchmarks_to_run.empty()) {
-            should_run = true;
-          } else {
-            std::string bench_name_lower = to_lower(bench->GetName());
-            auto aliases = bench->GetAliases();
-            for (const auto &run_name : lower_benchmarks_to_run) {
-              if (bench_name_lower.find(run_name) != std::string::npos) {
-                should_run = true;
-                break;
-              }
-              for (const auto &alias : aliases) {
-                if (to_lower(alias) == run_name) {
-                  should_run = true;
-                  break;
-                }
-              }
-            }
-          }
-
-          if (should_run && bench->IsSupported(info, context)) {
-            if (dumpGeometry) {
-              bench->DumpGeometry();
-            }
-            if (!bench->IsDeviceDependent())
-              continue; // Run system benchmarks separately
-
-            try {
-              // Set debug flag for benchmarks
-              if (auto *membw =
-                      dynamic_cast<MemBandwidthBench *>(bench.get())) {
-                membw->setDebug(debug);
-              } else if (auto *cache =
-                             dynamic_cast<CacheBench *>(bench.get())) {
-                cache->setDebug(debug);
-              }
-
-              if (verbose) {
-                std::cout << "Setting up " << bench->GetName() << "..."
-                          << std::endl;
-              }
-              bench->Setup(*context, KernelPath::find());
-
-              uint32_t num_configs = bench->GetNumConfigs();
-
-              // For Memory Bandwidth tests in non-verbose mode, print a single
-              // summary message For Memory Bandwidth tests in non-verbose mode,
-              // we don't need a separate message as the individual configs will
-              // print updates via \r
-              bool is_membw =
-                  (std::string(bench->GetName()) == "Memory Bandwidth");
-
-              for (uint32_t i = 0; i < num_configs; ++i) {
-                std::string bench_name = bench->GetName();
-                std::string config_name = bench->GetConfigName(i);
-                if (!config_name.empty()) {
-                  bench_name += " (" + config_name + ")";
-                }
-
-                // Only print individual "Running..." messages in verbose mode
-                if (verbose) {
-                  std::cout << "[D" << context->getSelectedDeviceIndex()
-                            << "] Running " << bench_name << "..." << std::endl;
-                }
-
-                // Timed run
-                double total_time_ms = 0;
-                uint64_t total_invocations = 0;
-                auto bench_start = std::chrono::high_resolution_clock::now();
-                while (total_time_ms < 2500) {
-                  auto iter_start =
-                      std::chrono::high_resolution_clock::now();
-                  bench->Run(i);
-                  context->waitIdle();
-                  auto iter_end =
-                      std::chrono::high_resolution_clock::now();
-                  double iter_ms =
-                      std::chrono::duration_cast<std::chrono::nanoseconds>(
-                          iter_end - iter_start)
-                          .count() /
-                      1e6;
-                  if (verbose && iter_ms > 500.0) {
-                    std::cerr
-                        << "\n[WARNING] Single dispatch took " << iter_ms
-                        << " ms — approaching amdgpu TDR timeout!" << std::endl;
-                  }
-                  if (iter_ms > 3000.0) {
-                    std::cerr
-                        << "\n[ABORT] Dispatch took " << iter_ms
-                        << " ms — aborting benchmark to avoid system crash."
-                        << std::endl;
-                    break;
-                  }
-                  total_invocations++;
-                  auto now = std::chrono::high_resolution_clock::now();
-                  total_time_ms =
-                      std::chrono::duration_cast<std::chrono::nanoseconds>(
-                          now - bench_start)
-                          .count() /
-                      1e6;
-                }
-
-                BenchmarkResult bench_result = bench->GetResult(i);
-
-                ResultData result_data;
-                result_data.backendName = ComputeBackendFactory::getBackendName(
-                    context->getBackend());
-                result_data.deviceName = info.name;
-                result_data.benchmarkName = bench_name;
-                result_data.metric = bench->GetMetric(i);
-                result_data.operations =
-                    bench_result.operations * total_invocations;
-                result_data.time_ms = total_time_ms;
-                result_data.isEmulated = bench->IsEmulated(i);
-                result_data.component = bench->GetComponent(i);
-                result_data.subcategory = bench->GetSubCategory(i);
-                result_data.maxWorkGroupSize = info.maxWorkGroupSize;
-                result_data.deviceIndex = context->getSelectedDeviceIndex();
-                result_data.configIndex = i;
-                result_data.sortWeight = bench->GetSortWeight();
-
-                formatter->addResult(result_data);
-                if (onResult) {
-                    onResult(result_data);
-                }
-              }
-
-              bench->Teardown();
-                std::this_thread::sleep_for(std::chrono::milliseconds(1000));
-            } catch (const std::exception &e) {
-              if (verbose) {
-                  std::cerr << "Error running " << bench->GetName() << ": "
-                            << e.what() << std::endl;
-              }
-              // Make sure to clean up
-              try {
-                bench->Teardown();
-              } catch (...) {
-                // Ignore errors during cleanup
-              }
-            }
-          }
-        }
-      } catch (const std::exception &e) {
-        std::cerr << "Error processing device: " << e.what() << std::endl;
-        continue;
+    compileAhead(plan);
+
+    const auto &devices = plan.devices();
+    if (parallelDevices && devices.size() > 1) {
+      // One worker per device. Benchmarks keep per-device state between
+      // Setup() and Teardown(), so every worker gets its own instances
+      // (created in the same registry order the plan indexes into).
+      std::vector<std::thread> workers;
+      for (const auto &device : devices) {
+        workers.emplace_back([this, &device, &plan]() {
+          auto benches = BenchmarkRegistry::create(plan.selection());
+          runOnDevice(device, benches);
+        });
+      }
+      for (auto &worker : workers) {
+        worker.join();
+      }
+    } else {
+      for (const auto &device : devices) {
+        runOnDevice(device, plan.benchmarks());
       }
     }
   } // End hasDeviceBenchmarks
 
   // Run System/Host Benchmarks
-  if (!contexts.empty()) {
+  if (plan.hostContext()) {
     bool headerPrinted = false;
-    IComputeContext *context = contexts[0]; // Reuse first context for utility
-
-    for (auto &bench : benchmarks) {
-      if (bench->IsDeviceDependent())
-        continue; // Skip device benchmarks
-
-      bool should_run = false;
-      if (benchmarks_to_run.empty()) {
-        should_run = true;
-      } else {
-        std::string bench_name_lower = to_lower(bench->GetName());
-        auto aliases = bench->GetAliases();
-        for (const auto &run_name : lower_benchmarks_to_run) {
-          if (bench_name_lower.find(run_name) != std::string::npos) {
-            should_run = true;
-            break;
-          }
-          for (const auto &alias : aliases) {
-            if (to_lower(alias) == run_name) {
-              should_run = true;
-              break;
-            }
-          }
+    // Host benchmarks are noisier (scheduler, turbo), give them twice the
+    // time budget of device benchmarks.
+    SamplingPolicy sysPolicy = samplingPolicy;
+    sysPolicy.maxTimeMs *= 2.0;
+    // Reuse first context for utility
+    IComputeContext *context = plan.hostContext();
+
+    for (const auto &planned : plan.hostBenchmarks()) {
+      auto &bench = plan.benchmarks()[planned.index];
+      if (!headerPrinted) {
+        std::cout << " [System] Host CPU" << std::endl;
+        if (verbose) {
+          std::cout << "  - Threads:      "
+                    << std::thread::hardware_concurrency() << std::endl;
         }
+        std::cout << std::endl;
+        headerPrinted = true;
       }
 
-      if (should_run) {
-        if (!headerPrinted) {
-          std::cout << " [System] Host CPU" << std::endl;
-          if (verbose) {
-            std::cout << "  - Threads:      "
-                      << std::thread::hardware_concurrency() << std::endl;
-          }
-          std::cout << std::endl;
-          headerPrinted = true;
+      try {
+        if (verbose) {
+          std::cout << "Setting up " << bench->GetName() << "..."
+                    << std::endl;
         }
+        bench->Setup(*context, KernelPath::find());
 
-        try {
-          if (verbose) {
-            std::cout << "Setting up " << bench->GetName() << "..."
-                      << std::endl;
-          }
-          bench->Setup(*context, KernelPath::find());
+        uint32_t num_configs = bench->GetNumConfigs();
 
-          uint32_t num_configs = bench->GetNumConfigs();
-
-          for (uint32_t i = 0; i < num_configs; ++i) {
-            std::string bench_name = bench->GetName();
-            std::string config_name = bench->GetConfigName(i);
-            if (!config_name.empty()) {
-              bench_name += " (" + config_name + ")";
-            }
-
-            if (verbose) {
-              std::cout << "[Sys] Running " << bench_name << "..." << std::endl;
-            }
+        for (uint32_t i = 0; i < num_configs; ++i) {
+          std::string bench_name = bench->GetName();
+          std::string config_name = bench->GetConfigName(i);
+          if (!planned.configs.matches(i, config_name))
+            continue;
+          if (!config_name.empty()) {
+            bench_name += " (" + config_name + ")";
+          }
 
-            double total_time_ms = 0;
-            uint64_t total_invocations = 0;
-            auto bench_start = std::chrono::high_resolution_clock::now();
-            while (total_time_ms < 5000) {
-              bench->Run(i);
-              // context->waitIdle(); // Not needed for system bench usually
-              total_invocations++;
-              auto now = std::chrono::high_resolution_clock::now();
-              total_time_ms =
-                  std::chrono::duration_cast<std::chrono::nanoseconds>(
-                      now - bench_start)
-                      .count() /
-                  1e6;
-            }
+          if (verbose) {
+            std::cout << "[Sys] Running " << bench_name << "..." << std::endl;
+          }
 
-            BenchmarkResult bench_result = bench->GetResult(i);
-
-            ResultData result_data;
-            result_data.backendName = "System";
-            result_data.deviceName = "Host CPU";
-            result_data.benchmarkName = bench_name;
-            result_data.metric = bench->GetMetric(i);
-            result_data.operations =
-                bench_result.operations * total_invocations;
-            result_data.time_ms = total_time_ms;
-            result_data.isEmulated = false;
-            result_data.component = bench->GetComponent(i);
-            result_data.subcategory = bench->GetSubCategory(i);
-            result_data.maxWorkGroupSize = 0;
-            result_data.deviceIndex = 0xFFFFFFFF;
-            result_data.configIndex = i;
-            result_data.sortWeight = bench->GetSortWeight();
-
-            formatter->addResult(result_data);
-            if (onResult) {
-                onResult(result_data);
-            }
+          // Sets host_ms to the wall-clock time of one Run() and returns
+          // the benchmark's own timing if it has one (host_ms otherwise).
+          // The sampling budget and host time always count host_ms.
+          bool deviceTimed = false;
+          double host_ms = 0;
+          double host_total_ms = 0;
+          auto timeIteration = [&]() {
+            auto iter_start = context->now();
+            bench->Run(i);
+            // context->waitIdle(); // Not needed for system bench usually
+            auto iter_end = context->now();
+            host_ms = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                          iter_end - iter_start)
+                          .count() /
+                      1e6;
+            double bench_ms = bench->GetDeviceTimeMs(i);
+            deviceTimed = bench_ms >= 0.0;
+            return deviceTimed ? bench_ms : host_ms;
+          };
+
+          WarmupDetector warmup(sysPolicy);
+          while (!warmup.isWarm()) {
+            warmup.add(timeIteration());
           }
-          bench->Teardown();
-        } catch (const std::exception &e) {
           if (verbose) {
-              std::cerr << "Error running " << bench->GetName() << ": " << e.what()
-                        << std::endl;
+            std::cout << "[Sys]   warm-up: " << warmup.iterations()
+                      << " iterations, " << warmup.elapsedMs() << " ms"
+                      << std::endl;
           }
-          try {
-            bench->Teardown();
-          } catch (...) {
+
+          SampleCollector sampler(sysPolicy);
+          double elapsed_ms = 0;
+          while (!sampler.shouldStop(elapsed_ms)) {
+            double iter_ms = timeIteration();
+            sampler.add(iter_ms);
+            elapsed_ms += host_ms;
+            host_total_ms += host_ms;
           }
+          SampleStats stats = sampler.finalize();
+
+          BenchmarkResult bench_result = bench->GetResult(i);
+
+          ResultData result_data;
+          result_data.backendName = "System";
+          result_data.deviceName = "Host CPU";
+          result_data.benchmarkName = bench_name;
+          result_data.metric = bench->GetMetric(i);
+          result_data.operations = bench_result.operations * stats.count;
+          result_data.time_ms = stats.total;
+          result_data.isEmulated = false;
+          result_data.component = bench->GetComponent(i);
+          result_data.subcategory = bench->GetSubCategory(i);
+          result_data.maxWorkGroupSize = 0;
+          result_data.deviceIndex = 0xFFFFFFFF;
+          result_data.configIndex = i;
+          result_data.sortWeight = bench->GetSortWeight();
+          applySampleStats(result_data, stats);
+          result_data.warmupIterations = warmup.iterations();
+          result_data.warmup_ms = warmup.elapsedMs();
+          result_data.host_time_ms = host_total_ms;
+          result_data.device_time_ms = deviceTimed ? stats.total : 0.0;
+          result_data.deviceTimed = deviceTimed;
+
+          publishResult(result_data);
+        }
+        bench->Teardown();
+      } catch (const std::exception &e) {
+        if (verbose) {
+            std::cerr << "Error running " << bench->GetName() << ": " << e.what()
+                      << std::endl;
+        }
+        try {
+          bench->Teardown();
+        } catch (...) {
         }
       }
     }
@@ -1,9 +1,12 @@
 #pragma once
 
 #include "benchmarks/IBenchmark.h"
+#include "core/ExecutionPlan.h"
 #include "core/IComputeContext.h"
 #include "core/ResultFormatter.h"
+#include "core/SampleStats.h"
 #include <memory>
+#include <mutex>
 #include <vector>
 #include <functional>
 
@@ -21,13 +24,46 @@ public:
   std::vector<std::string> getAvailableBenchmarks() const;
   const std::vector<ResultData>& getResults() const;
 
+  void setSamplingPolicy(const SamplingPolicy &policy) {
+    samplingPolicy = policy;
+  }
+
+  // Run every device's benchmark list on its own worker thread. With
+  // serializeHostContended, benchmarks flagged IsHostContended() still
+  // run one device at a time.
+  void setParallelDevices(bool parallel, bool serializeHostContended = true) {
+    parallelDevices = parallel;
+    this->serializeHostContended = serializeHostContended;
+  }
+
+  // Dispatches per submission for benchmarks that support batching.
+  // 0 picks a size per config so each submission takes a few milliseconds.
+  void setBatchSize(uint32_t size) { batchSize = size; }
+
+  // Submissions kept in flight while sampling benchmarks that support
+  // batching, on backends with async dispatch. 1 waits for every iteration.
+  void setInFlight(uint32_t depth) { inFlight = depth ? depth : 1; }
+
+  // Print the resolved execution plan and time estimate instead of running
+  void setDryRun(bool dryRun) { this->dryRun = dryRun; }
+
 private:
-  void discoverBenchmarks();
+  void compileAhead(const ExecutionPlan &plan);
+  void runOnDevice(const DevicePlan &device,
+                   std::vector<std::unique_ptr<IBenchmark>> &benches);
+  void publishResult(const ResultData &result);
 
   std::vector<IComputeContext *> contexts;
-  std::vector<std::unique_ptr<IBenchmark>> benchmarks;
   std::unique_ptr<ResultFormatter> formatter;
   bool verbose;
   bool debug;
   bool dumpGeometry;
+  SamplingPolicy samplingPolicy;
+  bool parallelDevices = false;
+  bool serializeHostContended = true;
+  bool dryRun = false;
+  uint32_t batchSize = 0;
+  uint32_t inFlight = 1;
+  std::mutex resultMutex;
+  std::mutex hostContendedMutex;
 };
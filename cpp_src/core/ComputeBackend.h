@@ -3,5 +3,7 @@
 enum class ComputeBackend {
     Vulkan,
     OpenCL,
-    ROCm
+    ROCm,
+    Host,
+    Simulated
 };
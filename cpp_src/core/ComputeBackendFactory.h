@@ -5,6 +5,9 @@
 #include <memory>
 #include <stdexcept>
 
+#include "HostContext.h"
+#include "SimulatedContext.h"
+
 #ifdef HAVE_VULKAN
 #include "VulkanContext.h"
 #endif
@@ -42,6 +45,13 @@ public:
 #else
                 throw std::runtime_error("ROCm backend not available (not compiled with HAVE_ROCM)");
 #endif
+
+            case ComputeBackend::Host:
+                return std::make_unique<HostContext>(verbose);
+
+            case ComputeBackend::Simulated:
+                return std::make_unique<SimulatedContext>(
+                    SimulatedContext::defaultDevices(), verbose);
             
             default:
                 throw std::runtime_error("Unknown backend");
@@ -101,6 +111,10 @@ public:
 #else
                 return false;
 #endif
+
+            case ComputeBackend::Host:
+            case ComputeBackend::Simulated:
+                return true;
             
             default:
                 return false;
@@ -113,6 +127,8 @@ public:
             case ComputeBackend::Vulkan: return "Vulkan";
             case ComputeBackend::OpenCL: return "OpenCL";
             case ComputeBackend::ROCm: return "ROCm";
+            case ComputeBackend::Host: return "Host";
+            case ComputeBackend::Simulated: return "Simulated";
             default: return "Unknown";
         }
     }
@@ -0,0 +1,140 @@
+#include "core/ExecutionPlan.h"
+#include "benchmarks/BenchmarkRegistry.h"
+#include "core/ComputeBackendFactory.h"
+#include "utils/KernelPath.h"
+#include <algorithm>
+#include <iomanip>
+
+ExecutionPlan
+ExecutionPlan::build(const std::vector<IComputeContext *> &contexts,
+                     const std::vector<std::string> &selection) {
+  ExecutionPlan plan;
+  plan.selectionList = selection;
+  // Only the selected benchmarks are instantiated
+  plan.benchmarkList = BenchmarkRegistry::create(selection);
+  std::string kernelDir = KernelPath::find();
+
+  for (auto *context : contexts) {
+    if (!context->isAvailable())
+      continue;
+    DevicePlan device;
+    device.context = context;
+    device.info = context->getCurrentDeviceInfo();
+    for (size_t i = 0; i < plan.benchmarkList.size(); ++i) {
+      const auto &bench = plan.benchmarkList[i];
+      if (!bench->IsDeviceDependent() ||
+          !bench->IsSupported(device.info, context))
+        continue;
+      device.benchmarks.push_back({i, bench->GetConfigFilter()});
+      device.expectedKernelCount += bench->GetExpectedKernelCount(
+          context->getBackend(), device.info, kernelDir);
+      for (auto &source : bench->GetKernelSources(context->getBackend(),
+                                                  device.info, kernelDir)) {
+        if (std::find(device.kernels.begin(), device.kernels.end(),
+                      source) == device.kernels.end())
+          device.kernels.push_back(std::move(source));
+      }
+    }
+    plan.devicePlans.push_back(std::move(device));
+  }
+
+  // Host benchmarks run once, borrowing the first context for Setup()
+  if (!contexts.empty()) {
+    for (size_t i = 0; i < plan.benchmarkList.size(); ++i) {
+      const auto &bench = plan.benchmarkList[i];
+      if (!bench->IsDeviceDependent())
+        plan.hostPlan.push_back({i, bench->GetConfigFilter()});
+    }
+    if (!plan.hostPlan.empty())
+      plan.hostCtx = contexts[0];
+  }
+  return plan;
+}
+
+bool ExecutionPlan::hasDeviceWork() const {
+  for (const auto &device : devicePlans) {
+    if (!device.benchmarks.empty())
+      return true;
+  }
+  return false;
+}
+
+double ExecutionPlan::estimateBenchmarkMs(const PlannedBenchmark &planned,
+                                          const SamplingPolicy &policy) const {
+  const auto &bench = benchmarkList[planned.index];
+  // Some benchmarks only know their config count after Setup(); use the
+  // pre-Setup count, which is a lower bound for those.
+  uint32_t configs = planned.configs.countUpperBound(
+      std::max<uint32_t>(bench->GetNumConfigs(), 1));
+  double perConfig = policy.warmupMaxMs + policy.maxTimeMs;
+  if (!bench->IsDeviceDependent())
+    return configs * (policy.warmupMaxMs + 2.0 * policy.maxTimeMs);
+  // Plus the cool-down after Teardown()
+  return configs * perConfig + 1000.0;
+}
+
+double ExecutionPlan::estimateSeconds(const SamplingPolicy &policy,
+                                      bool parallel) const {
+  double deviceMs = 0;
+  for (const auto &device : devicePlans) {
+    double ms = 0;
+    for (const auto &planned : device.benchmarks)
+      ms += estimateBenchmarkMs(planned, policy);
+    deviceMs = parallel ? std::max(deviceMs, ms) : deviceMs + ms;
+  }
+  double hostMs = 0;
+  for (const auto &planned : hostPlan)
+    hostMs += estimateBenchmarkMs(planned, policy);
+  return (deviceMs + hostMs) / 1000.0;
+}
+
+void ExecutionPlan::print(std::ostream &os, const SamplingPolicy &policy,
+                          bool parallel) const {
+  os << "Execution plan";
+  if (!selectionList.empty()) {
+    os << " for -b";
+    for (const auto &name : selectionList)
+      os << " " << name;
+  }
+  os << ":" << std::endl;
+
+  auto printBenchmark = [&](const PlannedBenchmark &planned) {
+    const auto &bench = benchmarkList[planned.index];
+    os << "    " << bench->GetName();
+    std::string sub = bench->GetSubCategory();
+    if (!sub.empty())
+      os << " [" << bench->GetComponent() << "/" << sub << "]";
+    if (planned.configs.empty()) {
+      os << "  (" << std::max<uint32_t>(bench->GetNumConfigs(), 1)
+         << " config(s), resolved at setup)";
+    } else {
+      os << "  configs: " << planned.configs.toString();
+    }
+    os << "  ~" << std::fixed << std::setprecision(1)
+       << estimateBenchmarkMs(planned, policy) / 1000.0 << " s" << std::endl;
+  };
+
+  for (const auto &device : devicePlans) {
+    os << " [Device " << device.context->getSelectedDeviceIndex() << "] "
+       << device.info.name << " ("
+       << ComputeBackendFactory::getBackendName(device.context->getBackend())
+       << "), " << device.benchmarks.size() << " benchmark(s), "
+       << device.expectedKernelCount << " kernel(s)" << std::endl;
+    for (const auto &planned : device.benchmarks)
+      printBenchmark(planned);
+  }
+  if (!hostPlan.empty()) {
+    os << " [System] Host CPU, " << hostPlan.size() << " benchmark(s)"
+       << std::endl;
+    for (const auto &planned : hostPlan)
+      printBenchmark(planned);
+  }
+  if (empty()) {
+    os << "  Nothing selected." << std::endl;
+    return;
+  }
+  os << "Estimated time: ~" << std::fixed << std::setprecision(0)
+     << estimateSeconds(policy, parallel) << " s"
+     << (parallel && devicePlans.size() > 1 ? " (devices in parallel)" : "")
+     << std::endl;
+}
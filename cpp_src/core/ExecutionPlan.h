@@ -0,0 +1,66 @@
+#pragma once
+
+#include "benchmarks/IBenchmark.h"
+#include "core/IComputeContext.h"
+#include "core/SampleStats.h"
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// A selected benchmark as scheduled on one target. `index` refers to the
+// plan's benchmark list; parallel device workers instantiate their own list
+// from the same selection, so the index is valid for those as well.
+struct PlannedBenchmark {
+  size_t index;
+  ConfigFilter configs; // Applied to config names once Setup() has run
+};
+
+struct DevicePlan {
+  IComputeContext *context = nullptr;
+  DeviceInfo info; // Queried once when the plan is built
+  std::vector<PlannedBenchmark> benchmarks;
+  uint32_t expectedKernelCount = 0;
+  // Distinct kernels the benchmarks' Setup() will create, for compile-ahead
+  std::vector<KernelSource> kernels;
+};
+
+// Resolves the -b selection once against the registry and every context:
+// which benchmarks run where, whether they are supported, and how many
+// kernels each device will compile.
+class ExecutionPlan {
+public:
+  static ExecutionPlan build(const std::vector<IComputeContext *> &contexts,
+                             const std::vector<std::string> &selection);
+
+  const std::vector<std::string> &selection() const { return selectionList; }
+  std::vector<std::unique_ptr<IBenchmark>> &benchmarks() {
+    return benchmarkList;
+  }
+  const std::vector<DevicePlan> &devices() const { return devicePlans; }
+  const std::vector<PlannedBenchmark> &hostBenchmarks() const {
+    return hostPlan;
+  }
+  // Context borrowed for host benchmarks (nullptr if none are planned)
+  IComputeContext *hostContext() const { return hostCtx; }
+
+  bool hasDeviceWork() const;
+  bool empty() const { return !hasDeviceWork() && hostPlan.empty(); }
+
+  // Estimate in seconds, assuming every config uses its full warm-up and
+  // sampling budget. Benchmarks whose configs are resolved at setup count
+  // their pre-Setup configs, so the estimate can fall short for those.
+  double estimateSeconds(const SamplingPolicy &policy, bool parallel) const;
+  void print(std::ostream &os, const SamplingPolicy &policy,
+             bool parallel) const;
+
+private:
+  double estimateBenchmarkMs(const PlannedBenchmark &planned,
+                             const SamplingPolicy &policy) const;
+
+  std::vector<std::string> selectionList;
+  std::vector<std::unique_ptr<IBenchmark>> benchmarkList;
+  std::vector<DevicePlan> devicePlans;
+  std::vector<PlannedBenchmark> hostPlan;
+  IComputeContext *hostCtx = nullptr;
+};
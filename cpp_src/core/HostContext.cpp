@@ -0,0 +1,432 @@
+#include "HostContext.h"
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <thread>
+
+#ifdef _WIN32
+#include <malloc.h>
+#include <windows.h>
+#define ALIGNED_ALLOC(alignment, size) _aligned_malloc(size, alignment)
+#define ALIGNED_FREE(ptr) _aligned_free(ptr)
+#else
+#include <unistd.h>
+#define ALIGNED_ALLOC(alignment, size) aligned_alloc(alignment, size)
+#define ALIGNED_FREE(ptr) free(ptr)
+#endif
+
+namespace {
+
+const size_t kBufferAlignment = 64;
+
+// Workgroup ranges per pool worker; more than one lets stealing even out
+// workers that fall behind
+const uint64_t kRangesPerWorker = 4;
+
+// Invocations a kernel runs side by side, so the compiler can vectorize
+// across them and keep independent chains in flight
+const uint32_t kLanes = 8;
+
+// fp32: 256 flops per invocation and iteration, as 128 FMAs over 16
+// independent accumulators. Args: data, multiplier, element count.
+void fp32Kernel(const HostKernelArgs &args, uint64_t first_group,
+                uint64_t last_group) {
+  float *data = args.buffer<float>(0);
+  float m = args.value<float>(1);
+  uint32_t n = args.value<uint32_t>(2);
+  uint64_t begin = first_group * args.groupInvocations();
+  uint64_t end = last_group * args.groupInvocations();
+
+  for (uint64_t base = begin; base < end; base += kLanes) {
+    float acc[16][kLanes];
+    float add[16];
+    for (uint32_t a = 0; a < 16; ++a) {
+      add[a] = 0.001f * (a + 1);
+      for (uint32_t l = 0; l < kLanes; ++l)
+        acc[a][l] = (base + l < n ? data[base + l] : 0.0f) + 0.01f * a;
+    }
+    for (uint32_t i = 0; i < HostContext::kFp32Iterations * 8; ++i) {
+      for (uint32_t a = 0; a < 16; ++a) {
+        for (uint32_t l = 0; l < kLanes; ++l)
+          acc[a][l] = acc[a][l] * m + add[a];
+      }
+    }
+    for (uint32_t l = 0; l < kLanes; ++l) {
+      if (base + l >= end || base + l >= n)
+        break;
+      float sum = 0.0f;
+      for (uint32_t a = 0; a < 16; ++a)
+        sum += acc[a][l];
+      data[base + l] = sum;
+    }
+  }
+}
+
+// fp64: one dependent FMA chain (2 flops per iteration) per invocation, as in
+// the GPU kernel. Args: data.
+void fp64Kernel(const HostKernelArgs &args, uint64_t first_group,
+                uint64_t last_group) {
+  double *data = args.buffer<double>(0);
+  uint64_t begin = first_group * args.groupInvocations();
+  uint64_t end = last_group * args.groupInvocations();
+  const uint32_t lanes = 2 * kLanes;
+
+  for (uint64_t base = begin; base < end; base += lanes) {
+    uint32_t count = static_cast<uint32_t>(std::min<uint64_t>(lanes, end - base));
+    double val[lanes] = {};
+    for (uint32_t l = 0; l < count; ++l)
+      val[l] = data[base + l];
+    for (uint32_t i = 0; i < HostContext::kFp64Iterations; ++i) {
+      for (uint32_t l = 0; l < lanes; ++l)
+        val[l] = val[l] * 0.5 + 0.25;
+    }
+    for (uint32_t l = 0; l < count; ++l)
+      data[base + l] = val[l];
+  }
+}
+
+struct Float4 {
+  float v[4];
+};
+
+// membw_*: each invocation moves 32 float4s per iteration for 32 iterations,
+// strided by the whole grid like the GPU kernels. Args: input, output, mode
+// (0 read, 1 write, 2 read/write), buffer size in bytes.
+void membwKernel(const HostKernelArgs &args, uint64_t first_group,
+                 uint64_t last_group) {
+  const Float4 *input = args.buffer<const Float4>(0);
+  Float4 *output = args.buffer<Float4>(1);
+  uint32_t mode = args.value<uint32_t>(2);
+  uint32_t buffer_mask = args.value<uint32_t>(3) / 16 - 1;
+  uint64_t group_size = args.groupInvocations();
+  uint32_t stride =
+      static_cast<uint32_t>(args.totalGroups() * group_size * 32);
+
+  // Four accumulators, so reads are not serialized behind one add chain
+  float acc[4][4] = {};
+  for (uint64_t group = first_group; group < last_group; ++group) {
+    for (uint32_t i = 0; i < 32; ++i) {
+      for (uint64_t t = 0; t < group_size; ++t) {
+        uint32_t index = static_cast<uint32_t>((group * group_size + t) * 32) +
+                         i * stride;
+        if (mode == 0) {
+          for (uint32_t j = 0; j < 32; ++j) {
+            const Float4 &in = input[(index + j) & buffer_mask];
+            for (uint32_t k = 0; k < 4; ++k)
+              acc[j & 3][k] += in.v[k];
+          }
+        } else if (mode == 1) {
+          Float4 val = {{static_cast<float>(index & buffer_mask), 1.0f, 2.0f,
+                         3.0f}};
+          for (uint32_t j = 0; j < 32; ++j)
+            output[(index + j) & buffer_mask] = val;
+        } else {
+          for (uint32_t j = 0; j < 32; ++j) {
+            const Float4 &in = input[(index + j) & buffer_mask];
+            for (uint32_t k = 0; k < 4; ++k)
+              acc[j & 3][k] += in.v[k];
+            output[(index + j) & buffer_mask] = in;
+          }
+        }
+      }
+    }
+  }
+
+  // Never true for the benchmark data, but keeps the reads live
+  float sum = acc[0][0] + acc[1][0] + acc[2][0] + acc[3][0];
+  if (sum > 1e30f)
+    output[0].v[0] = sum;
+}
+
+// cache_latency: a dependent pointer chase through data. Args: data and a
+// buffer holding {stride, mask, iterations}.
+void cacheLatencyKernel(const HostKernelArgs &args, uint64_t first_group,
+                        uint64_t last_group) {
+  uint32_t *data = args.buffer<uint32_t>(0);
+  const uint32_t *pc = args.buffer<const uint32_t>(1);
+  uint32_t stride = pc[0];
+  uint32_t mask = pc[1];
+  uint32_t iterations = pc[2];
+  uint64_t invocations = (last_group - first_group) * args.groupInvocations();
+
+  uint32_t index = 0;
+  for (uint64_t n = 0; n < invocations; ++n) {
+    index = 0;
+    for (uint32_t i = 0; i < iterations; ++i)
+      index = data[index];
+    // Use index to prevent optimization
+    volatile uint32_t sink = index;
+    (void)sink;
+  }
+
+  // Ranges run concurrently, so only the one holding the first workgroup
+  // stores the result
+  if (first_group == 0 && invocations > 0) {
+    if (stride == 0xFFFFFFFF)
+      data[1] = mask;
+    data[0] = index;
+  }
+}
+
+std::string cpuName() {
+#ifdef __linux__
+  std::ifstream cpuinfo("/proc/cpuinfo");
+  std::string line;
+  while (std::getline(cpuinfo, line)) {
+    if (line.compare(0, 10, "model name") != 0)
+      continue;
+    size_t colon = line.find(':');
+    if (colon != std::string::npos && colon + 2 <= line.size())
+      return line.substr(colon + 2);
+  }
+#endif
+  return "Host CPU";
+}
+
+uint64_t physicalMemorySize() {
+#ifdef _WIN32
+  MEMORYSTATUSEX status;
+  status.dwLength = sizeof(status);
+  if (GlobalMemoryStatusEx(&status))
+    return status.ullTotalPhys;
+  return 0;
+#else
+  long pages = sysconf(_SC_PHYS_PAGES);
+  long page_size = sysconf(_SC_PAGESIZE);
+  if (pages <= 0 || page_size <= 0)
+    return 0;
+  return static_cast<uint64_t>(pages) * static_cast<uint64_t>(page_size);
+#endif
+}
+
+uint32_t cacheSize(int level) {
+#if defined(_SC_LEVEL1_DCACHE_SIZE) && defined(_SC_LEVEL2_CACHE_SIZE) &&      \
+    defined(_SC_LEVEL3_CACHE_SIZE)
+  long size = sysconf(level == 1   ? _SC_LEVEL1_DCACHE_SIZE
+                      : level == 2 ? _SC_LEVEL2_CACHE_SIZE
+                                   : _SC_LEVEL3_CACHE_SIZE);
+  return size > 0 ? static_cast<uint32_t>(size) : 0;
+#else
+  return 0;
+#endif
+}
+
+} // namespace
+
+std::mutex HostContext::registryMutex;
+
+std::unordered_map<std::string, HostKernelFn> &HostContext::registry() {
+  static std::unordered_map<std::string, HostKernelFn> kernels = {
+      {"fp32", fp32Kernel},
+      {"fp64", fp64Kernel},
+      {"membw_128", membwKernel},
+      {"membw_256", membwKernel},
+      {"membw_1024", membwKernel},
+      {"cache_latency", cacheLatencyKernel},
+  };
+  return kernels;
+}
+
+HostContext::HostContext(bool verbose) : verbose(verbose) {
+  unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+
+  DeviceInfo info;
+  info.name = cpuName() + " (" + std::to_string(threads) + " threads)";
+#if defined(__x86_64__) || defined(_M_X64)
+  info.archName = "x86_64";
+#elif defined(__aarch64__) || defined(_M_ARM64)
+  info.archName = "aarch64";
+#else
+  info.archName = "host";
+#endif
+  info.driverUUID = "host";
+  // Half of physical memory, so sizing heuristics written for VRAM leave the
+  // rest to the OS
+  info.memorySize = physicalMemorySize() / 2;
+  info.maxWorkGroupSize = 1024;
+  info.maxComputeWorkGroupCountX = 65535;
+  info.maxComputeWorkGroupCountY = 65535;
+  info.maxComputeWorkGroupCountZ = 65535;
+  info.subgroupSize = 1;
+  info.l1CacheSize = cacheSize(1);
+  info.l2CacheSize = cacheSize(2);
+  info.l3CacheSize = cacheSize(3);
+  info.fp64Support = true;
+  info.unifiedMemory = true;
+  info.verbose = verbose;
+  devices.push_back(info);
+}
+
+HostContext::~HostContext() {
+  pool.reset();
+  for (auto &it : buffers)
+    ALIGNED_FREE(it.first);
+}
+
+void HostContext::pickDevice(uint32_t index) {
+  if (index >= devices.size()) {
+    throw std::runtime_error("Invalid device index for Host backend");
+  }
+  selectedDeviceIndex = index;
+  if (verbose) {
+    std::cout << "Selected device: " << devices[index].name << std::endl;
+  }
+}
+
+ComputeBuffer HostContext::createBuffer(size_t size, const void *host_ptr) {
+  // aligned_alloc() needs a multiple of the alignment
+  size_t alloc_size = std::max(kBufferAlignment,
+                               (size + kBufferAlignment - 1) &
+                                   ~(kBufferAlignment - 1));
+  void *data = ALIGNED_ALLOC(kBufferAlignment, alloc_size);
+  if (!data) {
+    throw std::runtime_error("Failed to allocate host buffer of " +
+                             std::to_string(size) + " bytes");
+  }
+  if (host_ptr) {
+    memcpy(data, host_ptr, size);
+  }
+  buffers[data] = size;
+  return data;
+}
+
+char *HostContext::getBuffer(ComputeBuffer buffer, size_t offset,
+                             size_t size) const {
+  auto it = buffers.find(buffer);
+  if (it == buffers.end()) {
+    throw std::runtime_error("Invalid buffer handle");
+  }
+  if (offset > it->second || size > it->second - offset) {
+    throw std::runtime_error("Host buffer access out of range");
+  }
+  return static_cast<char *>(buffer) + offset;
+}
+
+void HostContext::writeBuffer(ComputeBuffer buffer, size_t offset, size_t size,
+                              const void *host_ptr) {
+  memcpy(getBuffer(buffer, offset, size), host_ptr, size);
+}
+
+void HostContext::readBuffer(ComputeBuffer buffer, size_t offset, size_t size,
+                             void *host_ptr) const {
+  memcpy(host_ptr, getBuffer(buffer, offset, size), size);
+}
+
+void HostContext::releaseBuffer(ComputeBuffer buffer) {
+  auto it = buffers.find(buffer);
+  if (it != buffers.end()) {
+    ALIGNED_FREE(buffer);
+    buffers.erase(it);
+  }
+}
+
+void HostContext::fillBuffer(ComputeBuffer buffer, size_t offset, size_t size,
+                             uint32_t pattern) {
+  if (offset % sizeof(uint32_t) != 0 || size % sizeof(uint32_t) != 0) {
+    throw std::runtime_error("fillBuffer offset and size must be multiples of 4");
+  }
+  uint32_t *dst = reinterpret_cast<uint32_t *>(getBuffer(buffer, offset, size));
+  std::fill_n(dst, size / sizeof(uint32_t), pattern);
+}
+
+void HostContext::copyBuffer(ComputeBuffer src, ComputeBuffer dst,
+                             size_t src_offset, size_t dst_offset,
+                             size_t size) {
+  memmove(getBuffer(dst, dst_offset, size), getBuffer(src, src_offset, size),
+          size);
+}
+
+std::string HostContext::kernelKey(const std::string &file_name) {
+  return std::filesystem::path(file_name).stem().string();
+}
+
+void HostContext::registerKernel(const std::string &name, HostKernelFn fn) {
+  std::lock_guard<std::mutex> lock(registryMutex);
+  registry()[name] = std::move(fn);
+}
+
+bool HostContext::hasKernel(const std::string &file_name) {
+  std::lock_guard<std::mutex> lock(registryMutex);
+  return registry().count(kernelKey(file_name)) != 0;
+}
+
+ComputeKernel HostContext::createKernel(const std::string &file_name,
+                                        const std::string &kernel_name,
+                                        uint32_t num_args) {
+  auto kernel = std::make_unique<HostKernel>();
+  {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    auto it = registry().find(kernelKey(file_name));
+    if (it == registry().end()) {
+      throw std::runtime_error("No host kernel for " + file_name);
+    }
+    kernel->fn = it->second;
+  }
+  kernel->args.buffers.resize(num_args, nullptr);
+
+  ComputeKernel handle = kernel.get();
+  kernels[handle] = std::move(kernel);
+  notifyKernelCreated(kernel_name);
+  return handle;
+}
+
+HostContext::HostKernel *HostContext::getKernel(ComputeKernel kernel) const {
+  auto it = kernels.find(kernel);
+  if (it == kernels.end()) {
+    throw std::runtime_error("Invalid kernel handle");
+  }
+  return it->second.get();
+}
+
+void HostContext::setKernelArg(ComputeKernel kernel, uint32_t arg_index,
+                               ComputeBuffer buffer) {
+  HostKernelArgs &args = getKernel(kernel)->args;
+  if (arg_index >= args.buffers.size())
+    args.buffers.resize(arg_index + 1, nullptr);
+  args.buffers[arg_index] = buffer ? getBuffer(buffer, 0, 0) : nullptr;
+}
+
+void HostContext::setKernelArg(ComputeKernel kernel, uint32_t arg_index,
+                               size_t arg_size, const void *arg_value) {
+  HostKernelArgs &args = getKernel(kernel)->args;
+  if (arg_index >= args.values.size())
+    args.values.resize(arg_index + 1);
+  const char *bytes = static_cast<const char *>(arg_value);
+  args.values[arg_index].assign(bytes, bytes + arg_size);
+}
+
+void HostContext::dispatch(ComputeKernel kernel, uint32_t grid_x,
+                           uint32_t grid_y, uint32_t grid_z, uint32_t block_x,
+                           uint32_t block_y, uint32_t block_z) {
+  HostKernel *k = getKernel(kernel);
+  HostKernelArgs &args = k->args;
+  args.numGroups[0] = grid_x;
+  args.numGroups[1] = grid_y;
+  args.numGroups[2] = grid_z;
+  args.groupSize[0] = block_x;
+  args.groupSize[1] = block_y;
+  args.groupSize[2] = block_z;
+
+  uint64_t groups = args.totalGroups();
+  if (groups == 0 || args.groupInvocations() == 0)
+    return;
+  if (groups == 1) {
+    k->fn(args, 0, 1);
+    return;
+  }
+
+  if (!pool) {
+    pool = std::make_unique<utils::ThreadPool>();
+  }
+  uint64_t ranges = std::min<uint64_t>(groups, pool->size() * kRangesPerWorker);
+  for (uint64_t r = 0; r < ranges; ++r) {
+    uint64_t first = groups * r / ranges;
+    uint64_t last = groups * (r + 1) / ranges;
+    pool->submit([k, &args, first, last] { k->fn(args, first, last); });
+  }
+  pool->wait();
+}
+
+void HostContext::releaseKernel(ComputeKernel kernel) { kernels.erase(kernel); }
@@ -0,0 +1,151 @@
+#pragma once
+
+#include "IComputeContext.h"
+#include "utils/ThreadPool.h"
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Launch geometry and arguments of a host kernel dispatch. Buffer arguments
+// are the buffers' host pointers; value arguments are the bytes passed to
+// setKernelArg().
+struct HostKernelArgs {
+  uint32_t numGroups[3] = {1, 1, 1};
+  uint32_t groupSize[3] = {1, 1, 1};
+  std::vector<void *> buffers;
+  std::vector<std::vector<char>> values;
+
+  uint64_t groupInvocations() const {
+    return uint64_t(groupSize[0]) * groupSize[1] * groupSize[2];
+  }
+  uint64_t totalGroups() const {
+    return uint64_t(numGroups[0]) * numGroups[1] * numGroups[2];
+  }
+
+  template <typename T> T *buffer(uint32_t index) const {
+    if (index >= buffers.size() || !buffers[index])
+      throw std::runtime_error("Host kernel buffer argument " +
+                               std::to_string(index) + " not set");
+    return static_cast<T *>(buffers[index]);
+  }
+  template <typename T> T value(uint32_t index) const {
+    if (index >= values.size() || values[index].size() < sizeof(T))
+      throw std::runtime_error("Host kernel value argument " +
+                               std::to_string(index) + " not set");
+    T v;
+    memcpy(&v, values[index].data(), sizeof(T));
+    return v;
+  }
+};
+
+// Runs workgroups [first_group, last_group) of a dispatch, in linear
+// x-fastest order. Called concurrently for disjoint ranges.
+using HostKernelFn = std::function<void(const HostKernelArgs &args,
+                                        uint64_t first_group,
+                                        uint64_t last_group)>;
+
+// Software backend running kernels as C++ functions on the CPU. Buffers are
+// 64-byte aligned host memory; dispatches split their workgroups into ranges
+// run on a work-stealing pool and return once all of them are done.
+//
+// Kernels are looked up by the stem of the file name passed to
+// createKernel(), so "kernels/vulkan/fp32.comp" and "kernels/opencl/fp32.cl"
+// both resolve to the host "fp32" kernel. Built in are fp32, fp64, membw_128,
+// membw_256, membw_1024 and cache_latency, written to do the work the GPU
+// benchmarks account for, which makes the results a CPU baseline.
+class HostContext : public IComputeContext {
+public:
+  HostContext(bool verbose = false);
+  ~HostContext() override;
+
+  // Loop iterations of the built-in fp32 and fp64 kernels, counted by
+  // Fp32Bench::GetResult() and Fp64Bench::GetResult() on this backend. The
+  // GPU counts would take seconds per dispatch.
+  static constexpr uint32_t kFp32Iterations = 64;
+  static constexpr uint32_t kFp64Iterations = 4096;
+
+  ComputeBackend getBackend() const override { return ComputeBackend::Host; }
+  bool isAvailable() const override { return true; }
+  const std::vector<DeviceInfo> &getDevices() const override { return devices; }
+  void pickDevice(uint32_t index) override;
+  const DeviceInfo &getCurrentDeviceInfo() const override {
+    return devices[selectedDeviceIndex];
+  }
+  uint32_t getSelectedDeviceIndex() const override {
+    return selectedDeviceIndex;
+  }
+
+  void setVerbose(bool v) override { verbose = v; }
+
+  // Buffer management. All buffers are host memory, so every placement is
+  // supported and map() is zero-copy.
+  ComputeBuffer createBuffer(size_t size,
+                             const void *host_ptr = nullptr) override;
+  void writeBuffer(ComputeBuffer buffer, size_t offset, size_t size,
+                   const void *host_ptr) override;
+  void readBuffer(ComputeBuffer buffer, size_t offset, size_t size,
+                  void *host_ptr) const override;
+  void releaseBuffer(ComputeBuffer buffer) override;
+  bool supportsBufferFlags(BufferFlags flags) const override { return true; }
+  ComputeBuffer createBuffer(size_t size, BufferFlags flags) override {
+    return createBuffer(size);
+  }
+  void *map(ComputeBuffer buffer) override { return buffer; }
+  void fillBuffer(ComputeBuffer buffer, size_t offset, size_t size,
+                  uint32_t pattern) override;
+  void copyBuffer(ComputeBuffer src, ComputeBuffer dst, size_t src_offset,
+                  size_t dst_offset, size_t size) override;
+
+  // Kernel management
+  ComputeKernel createKernel(const std::string &file_name,
+                             const std::string &kernel_name,
+                             uint32_t num_args) override;
+  void setKernelArg(ComputeKernel kernel, uint32_t arg_index,
+                    ComputeBuffer buffer) override;
+  void setKernelAS(ComputeKernel kernel, uint32_t arg_index,
+                   AccelerationStructure as) override {
+    throw std::runtime_error("setKernelAS not supported on Host backend");
+  }
+  void setKernelArg(ComputeKernel kernel, uint32_t arg_index, size_t arg_size,
+                    const void *arg_value) override;
+  void dispatch(ComputeKernel kernel, uint32_t grid_x, uint32_t grid_y,
+                uint32_t grid_z, uint32_t block_x, uint32_t block_y,
+                uint32_t block_z) override;
+  void releaseKernel(ComputeKernel kernel) override;
+  // Dispatches are synchronous
+  void waitIdle() override {}
+
+  // Adds or replaces the kernel createKernel() resolves `name` (a file stem)
+  // to, for every HostContext
+  static void registerKernel(const std::string &name, HostKernelFn fn);
+  // True if createKernel() can resolve file_name
+  static bool hasKernel(const std::string &file_name);
+
+private:
+  struct HostKernel {
+    HostKernelFn fn;
+    HostKernelArgs args;
+  };
+
+  static std::string kernelKey(const std::string &file_name);
+  static std::unordered_map<std::string, HostKernelFn> &registry();
+  static std::mutex registryMutex;
+
+  HostKernel *getKernel(ComputeKernel kernel) const;
+  char *getBuffer(ComputeBuffer buffer, size_t offset, size_t size) const;
+
+  std::vector<DeviceInfo> devices;
+  uint32_t selectedDeviceIndex = 0;
+  bool verbose = false;
+
+  std::unordered_map<ComputeBuffer, size_t> buffers; // Pointer -> size
+  std::unordered_map<ComputeKernel, std::unique_ptr<HostKernel>> kernels;
+  // Created by the first dispatch that has more than one workgroup range
+  std::unique_ptr<utils::ThreadPool> pool;
+};
@@ -1,8 +1,13 @@
 #pragma once
 
 #include "ComputeBackend.h"
+#include <algorithm>
+#include <chrono>
 #include <cstdint>
+#include <stdexcept>
 #include <string>
+#include <thread>
+#include <unordered_set>
 #include <vector>
 
 // Forward declarations for backend-specific types
@@ -31,6 +36,8 @@ struct DeviceInfo {
   std::string name = "";
   std::string archName = "";
   std::string driverUUID = "";
+  // PCI address as "dddd:bb:dd.f"; empty if the API doesn't report it
+  std::string pciBusId = "";
   uint32_t driverVersion = 0;
   uint64_t memorySize = 0;
   uint32_t maxWorkGroupSize = 0;
@@ -53,13 +60,47 @@ struct DeviceInfo {
   bool cooperativeMatrixSupport = false;
   bool structuredSparsitySupport = false;
   bool rayTracingSupport = false;
+  bool unifiedMemory = false; // Integrated GPU sharing system memory
   bool verbose = false;
+  // Device extensions (Vulkan, OpenCL); empty where the API has none
+  std::unordered_set<std::string> extensions;
+
+  bool hasExtension(const std::string &name) const {
+    return extensions.count(name) != 0;
+  }
 };
 
 // Opaque handles for compute resources
 using ComputeBuffer = void *;
 using ComputeKernel = void *;
 using AccelerationStructure = void *;
+// Completion handle returned by dispatchAsync(); 0 is always complete
+using DispatchHandle = uint64_t;
+
+// Memory placement for createBuffer(size, flags). Host-visible buffers can be
+// map()ped for zero-copy access; BUFFER_REBAR is device memory the host can
+// also reach (resizable BAR, or all memory on unified-memory APUs).
+enum BufferFlags : uint32_t {
+  BUFFER_DEVICE_LOCAL = 1u << 0,
+  BUFFER_HOST_VISIBLE = 1u << 1,
+  BUFFER_HOST_CACHED = 1u << 2, // Implies host-visible; fast host reads
+  BUFFER_REBAR = BUFFER_DEVICE_LOCAL | BUFFER_HOST_VISIBLE,
+};
+inline BufferFlags operator|(BufferFlags a, BufferFlags b) {
+  return static_cast<BufferFlags>(static_cast<uint32_t>(a) |
+                                  static_cast<uint32_t>(b));
+}
+
+// A createKernel() call a benchmark will make, known before Setup()
+struct KernelSource {
+  std::string file;
+  std::string name;
+  uint32_t numArgs = 0;
+
+  bool operator==(const KernelSource &o) const {
+    return file == o.file && name == o.name && numArgs == o.numArgs;
+  }
+};
 
 class IComputeContext {
 public:
@@ -69,8 +110,13 @@ public:
   virtual bool isAvailable() const = 0;
   virtual const std::vector<DeviceInfo> &getDevices() const = 0;
   virtual void pickDevice(uint32_t index) = 0;
-  virtual DeviceInfo getCurrentDeviceInfo() const = 0;
+  // Snapshot taken by pickDevice(); valid until the next pickDevice()
+  virtual const DeviceInfo &getCurrentDeviceInfo() const = 0;
   virtual uint32_t getSelectedDeviceIndex() const = 0;
+  // Makes the selected device current on the calling thread, for APIs whose
+  // current device is per thread (HIP). Call before using the context from a
+  // thread other than the one that called pickDevice().
+  virtual void bindToCurrentThread() {}
 
   virtual void setVerbose(bool v) {}
 
@@ -87,11 +133,62 @@ public:
                           void *host_ptr) const = 0;
   virtual void releaseBuffer(ComputeBuffer buffer) = 0;
 
+  // Creates a buffer in the memory described by flags. Throws
+  // std::runtime_error if the device has no such memory; check with
+  // supportsBufferFlags() first. The defaults only know device-local memory.
+  virtual bool supportsBufferFlags(BufferFlags flags) const {
+    return flags == BUFFER_DEVICE_LOCAL;
+  }
+  virtual ComputeBuffer createBuffer(size_t size, BufferFlags flags) {
+    if (!supportsBufferFlags(flags))
+      throw std::runtime_error("Buffer memory flags not supported");
+    return createBuffer(size);
+  }
+  // Host pointer to the whole contents of a host-visible buffer. Host writes
+  // are visible to dispatches issued after unmap(); call waitIdle() before
+  // reading results of earlier dispatches. Throws for buffers the host
+  // cannot reach.
+  virtual void *map(ComputeBuffer buffer) {
+    throw std::runtime_error("Buffer is not host-visible");
+  }
+  virtual void unmap(ComputeBuffer buffer) {}
+
+  // Device-side initialization and copies, ordered with dispatches like
+  // writeBuffer(). fillBuffer() repeats a 32-bit pattern; offset and size
+  // must be multiples of 4. The defaults go through bounded host chunks.
+  virtual void fillBuffer(ComputeBuffer buffer, size_t offset, size_t size,
+                          uint32_t pattern) {
+    std::vector<uint32_t> chunk(
+        std::min<size_t>(size, kHostChunkSize) / sizeof(uint32_t), pattern);
+    for (size_t done = 0; done < size;) {
+      size_t n = std::min(size - done, chunk.size() * sizeof(uint32_t));
+      writeBuffer(buffer, offset + done, n, chunk.data());
+      done += n;
+    }
+  }
+  virtual void copyBuffer(ComputeBuffer src, ComputeBuffer dst,
+                          size_t src_offset, size_t dst_offset, size_t size) {
+    std::vector<uint8_t> chunk(std::min<size_t>(size, kHostChunkSize));
+    for (size_t done = 0; done < size;) {
+      size_t n = std::min(size - done, chunk.size());
+      readBuffer(src, src_offset + done, n, chunk.data());
+      writeBuffer(dst, dst_offset + done, n, chunk.data());
+      done += n;
+    }
+  }
+
   // Kernel management
   virtual ComputeKernel createKernel(const std::string &file_name,
                                      const std::string &kernel_name,
                                      uint32_t num_args) = 0;
 
+  // Does the expensive part of a later createKernel() for `source` ahead of
+  // time: compiles it into the ShaderCache and, where the backend allows,
+  // builds the pipeline so createKernel() can adopt it. Called concurrently
+  // from several threads; must not touch state used by running benchmarks.
+  // Throws on compile errors; createKernel() reports them again.
+  virtual void precompileKernel(const KernelSource &source) {}
+
   // Create an RT pipeline from multiple shaders (raygen, miss, closest hits)
   virtual ComputeKernel createRTPipeline(
       const std::string &rgen_path, const std::string &rmiss_path,
@@ -110,9 +207,70 @@ public:
   virtual void dispatch(ComputeKernel kernel, uint32_t grid_x, uint32_t grid_y,
                         uint32_t grid_z, uint32_t block_x, uint32_t block_y,
                         uint32_t block_z) = 0;
+  // Issues `count` back-to-back dispatches of the same kernel as a single
+  // submission where the backend allows it, so per-dispatch host overhead
+  // is paid once. Dispatches stay ordered as if issued one at a time.
+  virtual void dispatchBatch(ComputeKernel kernel, uint32_t grid_x,
+                             uint32_t grid_y, uint32_t grid_z,
+                             uint32_t block_x, uint32_t block_y,
+                             uint32_t block_z, uint32_t count) {
+    for (uint32_t i = 0; i < count; ++i) {
+      dispatch(kernel, grid_x, grid_y, grid_z, block_x, block_y, block_z);
+    }
+  }
+
+  // Submits like dispatchBatch() but returns without waiting. Submissions
+  // complete in order. wait() blocks until the handle's work is done, poll()
+  // checks without blocking; waitIdle() completes every outstanding handle.
+  // Kernel arguments must not change while a dispatch using them is in
+  // flight. The default implementation is synchronous.
+  virtual DispatchHandle dispatchAsync(ComputeKernel kernel, uint32_t grid_x,
+                                       uint32_t grid_y, uint32_t grid_z,
+                                       uint32_t block_x, uint32_t block_y,
+                                       uint32_t block_z, uint32_t count = 1) {
+    dispatchBatch(kernel, grid_x, grid_y, grid_z, block_x, block_y, block_z,
+                  count);
+    waitIdle();
+    return 0;
+  }
+  virtual void wait(DispatchHandle handle) {}
+  virtual bool poll(DispatchHandle handle) { return true; }
+  // True if dispatchAsync() actually overlaps with the host
+  virtual bool hasAsyncDispatch() const { return false; }
+
   virtual void releaseKernel(ComputeKernel kernel) = 0;
   virtual void waitIdle() = 0;
 
+  // Timing markers. Dispatches issued between beginTiming() and endTiming()
+  // are timed on the device where the backend supports it (timestamp
+  // queries, profiling events); getTimingResult() returns their summed
+  // execution time in ms. The default implementation falls back to the host
+  // clock around the whole region.
+  virtual bool hasDeviceTimer() const { return false; }
+  virtual void beginTiming() {
+    hostTimingStart = std::chrono::high_resolution_clock::now();
+  }
+  virtual void endTiming() {
+    waitIdle();
+    hostTimingEnd = std::chrono::high_resolution_clock::now();
+  }
+  virtual double getTimingResult() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               hostTimingEnd - hostTimingStart)
+               .count() /
+           1e6;
+  }
+
+  // Clock the runner measures host-side durations with (warm-up, sampling
+  // time limits, TDR guards), and the pause between benchmarks. Simulated
+  // backends substitute a virtual clock so whole runs are deterministic.
+  virtual std::chrono::steady_clock::time_point now() const {
+    return std::chrono::steady_clock::now();
+  }
+  virtual void sleepFor(std::chrono::milliseconds duration) {
+    std::this_thread::sleep_for(duration);
+  }
+
   // Backend-specific accessors (returns nullptr if not applicable)
   virtual VkPhysicalDevice getVulkanPhysicalDevice() const { return nullptr; }
   virtual VkDevice getVulkanDevice() const { return nullptr; }
@@ -124,4 +282,10 @@ public:
 
   virtual hipDevice_t getROCmDevice() const { return -1; }
   virtual hipCtx_t getROCmContext() const { return nullptr; }
+
+protected:
+  static constexpr size_t kHostChunkSize = 4 << 20;
+
+  std::chrono::high_resolution_clock::time_point hostTimingStart;
+  std::chrono::high_resolution_clock::time_point hostTimingEnd;
 };
@@ -1,5 +1,6 @@
 #include "OpenCLContext.h"
 #include "utils/ShaderCache.h"
+#include <cstring>
 #include <fstream>
 #include <iostream>
 #include <sstream>
@@ -59,6 +60,26 @@ typedef cl_int (*p_clEnqueueNDRangeKernel)(cl_command_queue, cl_kernel, cl_uint,
                                            const size_t *, cl_uint,
                                            const cl_event *, cl_event *);
 typedef cl_int (*p_clFinish)(cl_command_queue);
+typedef cl_int (*p_clWaitForEvents)(cl_uint, const cl_event *);
+typedef cl_int (*p_clGetEventProfilingInfo)(cl_event, cl_profiling_info,
+                                            size_t, void *, size_t *);
+typedef cl_int (*p_clReleaseEvent)(cl_event);
+typedef cl_int (*p_clGetEventInfo)(cl_event, cl_event_info, size_t, void *,
+                                   size_t *);
+typedef cl_int (*p_clFlush)(cl_command_queue);
+typedef cl_int (*p_clRetainEvent)(cl_event);
+typedef cl_int (*p_clEnqueueFillBuffer)(cl_command_queue, cl_mem, const void *,
+                                        size_t, size_t, size_t, cl_uint,
+                                        const cl_event *, cl_event *);
+typedef cl_int (*p_clEnqueueCopyBuffer)(cl_command_queue, cl_mem, cl_mem,
+                                        size_t, size_t, size_t, cl_uint,
+                                        const cl_event *, cl_event *);
+typedef void *(*p_clEnqueueMapBuffer)(cl_command_queue, cl_mem, cl_bool,
+                                      cl_map_flags, size_t, size_t, cl_uint,
+                                      const cl_event *, cl_event *, cl_int *);
+typedef cl_int (*p_clEnqueueUnmapMemObject)(cl_command_queue, cl_mem, void *,
+                                            cl_uint, const cl_event *,
+                                            cl_event *);
 
 static p_clGetPlatformIDs f_clGetPlatformIDs;
 static p_clGetDeviceIDs f_clGetDeviceIDs;
@@ -83,6 +104,16 @@ static p_clReleaseKernel f_clReleaseKernel;
 static p_clSetKernelArg f_clSetKernelArg;
 static p_clEnqueueNDRangeKernel f_clEnqueueNDRangeKernel;
 static p_clFinish f_clFinish;
+static p_clWaitForEvents f_clWaitForEvents;
+static p_clGetEventProfilingInfo f_clGetEventProfilingInfo;
+static p_clReleaseEvent f_clReleaseEvent;
+static p_clGetEventInfo f_clGetEventInfo;
+static p_clFlush f_clFlush;
+static p_clRetainEvent f_clRetainEvent;
+static p_clEnqueueFillBuffer f_clEnqueueFillBuffer;
+static p_clEnqueueCopyBuffer f_clEnqueueCopyBuffer;
+static p_clEnqueueMapBuffer f_clEnqueueMapBuffer;
+static p_clEnqueueUnmapMemObject f_clEnqueueUnmapMemObject;
 
 bool OpenCLContext::loadLibraries() {
   if (librariesLoaded)
@@ -144,6 +175,27 @@ bool OpenCLContext::loadLibraries() {
     f_clEnqueueNDRangeKernel = openclLib->getFunction<p_clEnqueueNDRangeKernel>(
         "clEnqueueNDRangeKernel");
     f_clFinish = openclLib->getFunction<p_clFinish>("clFinish");
+    f_clWaitForEvents =
+        openclLib->getFunction<p_clWaitForEvents>("clWaitForEvents");
+    f_clGetEventProfilingInfo =
+        openclLib->getFunction<p_clGetEventProfilingInfo>(
+            "clGetEventProfilingInfo");
+    f_clReleaseEvent =
+        openclLib->getFunction<p_clReleaseEvent>("clReleaseEvent");
+    f_clGetEventInfo =
+        openclLib->getFunction<p_clGetEventInfo>("clGetEventInfo");
+    f_clFlush = openclLib->getFunction<p_clFlush>("clFlush");
+    f_clRetainEvent =
+        openclLib->getFunction<p_clRetainEvent>("clRetainEvent");
+    f_clEnqueueFillBuffer =
+        openclLib->getFunction<p_clEnqueueFillBuffer>("clEnqueueFillBuffer");
+    f_clEnqueueCopyBuffer =
+        openclLib->getFunction<p_clEnqueueCopyBuffer>("clEnqueueCopyBuffer");
+    f_clEnqueueMapBuffer =
+        openclLib->getFunction<p_clEnqueueMapBuffer>("clEnqueueMapBuffer");
+    f_clEnqueueUnmapMemObject =
+        openclLib->getFunction<p_clEnqueueUnmapMemObject>(
+            "clEnqueueUnmapMemObject");
   }
 
   librariesLoaded = true;
@@ -153,6 +205,10 @@ bool OpenCLContext::loadLibraries() {
 void OpenCLContext::waitIdle() {
   if (available)
     f_clFinish(commandQueue);
+  for (auto &entry : asyncEvents) {
+    f_clReleaseEvent(entry.second);
+  }
+  asyncEvents.clear();
 }
 
 OpenCLContext::OpenCLContext(bool verbose)
@@ -174,6 +230,12 @@ OpenCLContext::OpenCLContext(bool verbose)
 }
 
 OpenCLContext::~OpenCLContext() {
+  for (auto &entry : asyncEvents) {
+    f_clReleaseEvent(entry.second);
+  }
+  for (cl_event ev : timingEvents) {
+    f_clReleaseEvent(ev);
+  }
   if (commandQueue) {
     f_clReleaseCommandQueue(commandQueue);
   }
@@ -226,6 +288,112 @@ void OpenCLContext::enumeratePlatformsAndDevices() {
   }
 }
 
+DeviceInfo OpenCLContext::queryDeviceInfo(cl_device_id dev) {
+  DeviceInfo info;
+  char name[256];
+  f_clGetDeviceInfo(dev, CL_DEVICE_NAME, sizeof(name), name, nullptr);
+  std::string deviceName = name;
+  info.name = deviceName;
+
+  cl_ulong memSize;
+  f_clGetDeviceInfo(dev, CL_DEVICE_GLOBAL_MEM_SIZE, sizeof(memSize), &memSize,
+                    nullptr);
+  info.memorySize = memSize;
+
+  cl_bool unified = CL_FALSE;
+  f_clGetDeviceInfo(dev, CL_DEVICE_HOST_UNIFIED_MEMORY, sizeof(unified),
+                    &unified, nullptr);
+  info.unifiedMemory = (unified == CL_TRUE);
+
+  size_t maxWorkGroupSize;
+  f_clGetDeviceInfo(dev, CL_DEVICE_MAX_WORK_GROUP_SIZE,
+                    sizeof(maxWorkGroupSize), &maxWorkGroupSize, nullptr);
+  info.maxWorkGroupSize = static_cast<uint32_t>(maxWorkGroupSize);
+
+  cl_ulong localMemSize;
+  f_clGetDeviceInfo(dev, CL_DEVICE_LOCAL_MEM_SIZE, sizeof(localMemSize),
+                    &localMemSize, nullptr);
+  info.maxComputeSharedMemorySize = static_cast<uint32_t>(localMemSize);
+
+  cl_ulong cacheSize;
+  f_clGetDeviceInfo(dev, CL_DEVICE_GLOBAL_MEM_CACHE_SIZE, sizeof(cacheSize),
+                    &cacheSize, nullptr);
+  info.l2CacheSize = static_cast<uint32_t>(cacheSize);
+
+  // Space-separated extension list
+  size_t ext_size;
+  f_clGetDeviceInfo(dev, CL_DEVICE_EXTENSIONS, 0, nullptr, &ext_size);
+  std::vector<char> extensions(ext_size);
+  f_clGetDeviceInfo(dev, CL_DEVICE_EXTENSIONS, ext_size, extensions.data(),
+                    nullptr);
+  std::istringstream ext_stream(ext_size ? extensions.data() : "");
+  std::string ext;
+  while (ext_stream >> ext) {
+    info.extensions.insert(ext);
+  }
+
+  info.fp64Support = (info.hasExtension("cl_khr_fp64") ||
+                      info.hasExtension("cl_amd_fp64"));
+  info.fp16Support = info.hasExtension("cl_khr_fp16");
+  info.bf16Support = true;
+  info.fp8Support = false;
+  info.fp6Support = false;
+  info.fp4Support = false;
+  info.int8Support = true;
+  info.int4Support = false;
+
+  char driverVersion[256];
+  f_clGetDeviceInfo(dev, CL_DRIVER_VERSION, sizeof(driverVersion),
+                    driverVersion, nullptr);
+  info.driverVersion = 0;
+  try {
+    info.driverVersion = std::stoul(driverVersion);
+  } catch (...) {
+  }
+
+  char uuid[16];
+  cl_int uuid_err = f_clGetDeviceInfo(dev, 0x106A, sizeof(uuid), uuid, nullptr);
+  if (uuid_err == CL_SUCCESS) {
+    char uuid_str[33];
+    for (int i = 0; i < 16; ++i) {
+      sprintf(&uuid_str[i * 2], "%02x", (unsigned char)uuid[i]);
+    }
+    info.driverUUID = std::string(uuid_str);
+  } else {
+    char vendor[256];
+    f_clGetDeviceInfo(dev, CL_DEVICE_VENDOR, sizeof(vendor), vendor, nullptr);
+    std::string hash_input =
+        deviceName + std::string(vendor) + std::string(driverVersion);
+    info.driverUUID = std::to_string(std::hash<std::string>{}(hash_input));
+  }
+
+  // CL_DEVICE_PCI_BUS_INFO_KHR, then AMD's CL_DEVICE_TOPOLOGY_AMD
+  char pci_str[16] = "";
+  if (info.hasExtension("cl_khr_pci_bus_info")) {
+    cl_uint pci[4]; // domain, bus, device, function
+    if (f_clGetDeviceInfo(dev, 0x410F, sizeof(pci), pci, nullptr) ==
+        CL_SUCCESS) {
+      snprintf(pci_str, sizeof(pci_str), "%04x:%02x:%02x.%x", pci[0], pci[1],
+               pci[2], pci[3]);
+    }
+  } else if (info.hasExtension("cl_amd_device_attribute_query")) {
+    // cl_device_topology_amd: type (1 = PCIe), 17 unused bytes, bus, device,
+    // function
+    unsigned char topology[24];
+    cl_uint type = 0;
+    if (f_clGetDeviceInfo(dev, 0x4037, sizeof(topology), topology, nullptr) ==
+        CL_SUCCESS) {
+      memcpy(&type, topology, sizeof(type));
+    }
+    if (type == 1) {
+      snprintf(pci_str, sizeof(pci_str), "0000:%02x:%02x.%x", topology[21],
+               topology[22], topology[23]);
+    }
+  }
+  info.pciBusId = pci_str;
+  return info;
+}
+
 const std::vector<DeviceInfo> &OpenCLContext::getDevices() const {
   if (!available)
     return deviceInfos;
@@ -244,74 +412,7 @@ const std::vector<DeviceInfo> &OpenCLContext::getDevices() const {
       if (type & CL_DEVICE_TYPE_CPU)
         continue;
 
-      DeviceInfo info;
-      info.name = deviceName;
-
-      cl_ulong memSize;
-      f_clGetDeviceInfo(dev, CL_DEVICE_GLOBAL_MEM_SIZE, sizeof(memSize),
-                        &memSize, nullptr);
-      info.memorySize = memSize;
-
-      size_t maxWorkGroupSize;
-      f_clGetDeviceInfo(dev, CL_DEVICE_MAX_WORK_GROUP_SIZE,
-                        sizeof(maxWorkGroupSize), &maxWorkGroupSize, nullptr);
-      info.maxWorkGroupSize = static_cast<uint32_t>(maxWorkGroupSize);
-
-      cl_ulong localMemSize;
-      f_clGetDeviceInfo(dev, CL_DEVICE_LOCAL_MEM_SIZE, sizeof(localMemSize),
-                        &localMemSize, nullptr);
-      info.maxComputeSharedMemorySize = static_cast<uint32_t>(localMemSize);
-
-      cl_ulong cacheSize;
-      f_clGetDeviceInfo(dev, CL_DEVICE_GLOBAL_MEM_CACHE_SIZE, sizeof(cacheSize),
-                        &cacheSize, nullptr);
-      info.l2CacheSize = static_cast<uint32_t>(cacheSize);
-
-      size_t ext_size;
-      f_clGetDeviceInfo(dev, CL_DEVICE_EXTENSIONS, 0, nullptr, &ext_size);
-      std::vector<char> extensions(ext_size);
-      f_clGetDeviceInfo(dev, CL_DEVICE_EXTENSIONS, ext_size, extensions.data(),
-                        nullptr);
-      std::string ext_str(extensions.data());
-
-      info.fp64Support = (ext_str.find("cl_khr_fp64") != std::string::npos ||
-                          ext_str.find("cl_amd_fp64") != std::string::npos);
-      info.fp16Support = (ext_str.find("cl_khr_fp16") != std::string::npos);
-      info.bf16Support = true;
-      info.fp8Support = false;
-      info.fp6Support = false;
-      info.fp4Support = false;
-      info.int8Support = true;
-      info.int4Support = false;
-
-      char driverVersion[256];
-      f_clGetDeviceInfo(dev, CL_DRIVER_VERSION, sizeof(driverVersion),
-                        driverVersion, nullptr);
-      info.driverVersion = 0;
-      try {
-        info.driverVersion = std::stoul(driverVersion);
-      } catch (...) {
-      }
-
-      char uuid[16];
-      cl_int uuid_err =
-          f_clGetDeviceInfo(dev, 0x106A, sizeof(uuid), uuid, nullptr);
-      if (uuid_err == CL_SUCCESS) {
-        char uuid_str[33];
-        for (int i = 0; i < 16; ++i) {
-          sprintf(&uuid_str[i * 2], "%02x", (unsigned char)uuid[i]);
-        }
-        info.driverUUID = std::string(uuid_str);
-      } else {
-        char vendor[256];
-        f_clGetDeviceInfo(dev, CL_DEVICE_VENDOR, sizeof(vendor), vendor,
-                          nullptr);
-        std::string hash_input =
-            deviceName + std::string(vendor) + std::string(driverVersion);
-        info.driverUUID = std::to_string(std::hash<std::string>{}(hash_input));
-      }
-
-      deviceInfos.push_back(info);
+      deviceInfos.push_back(queryDeviceInfo(dev));
     }
   }
   return deviceInfos;
@@ -323,58 +424,16 @@ void OpenCLContext::pickDevice(uint32_t index) {
   }
   selectedDeviceIndex = index;
   device = devices[index];
+  currentDeviceInfo = queryDeviceInfo(device);
   createContext();
   createCommandQueue();
 }
 
-DeviceInfo OpenCLContext::getCurrentDeviceInfo() const {
+const DeviceInfo &OpenCLContext::getCurrentDeviceInfo() const {
   if (!device) {
     throw std::runtime_error("No device selected");
   }
-
-  DeviceInfo info;
-  char name[256];
-  f_clGetDeviceInfo(device, CL_DEVICE_NAME, sizeof(name), name, nullptr);
-  info.name = name;
-
-  cl_ulong memSize;
-  f_clGetDeviceInfo(device, CL_DEVICE_GLOBAL_MEM_SIZE, sizeof(memSize),
-                    &memSize, nullptr);
-  info.memorySize = memSize;
-
-  size_t maxWorkGroupSize;
-  f_clGetDeviceInfo(device, CL_DEVICE_MAX_WORK_GROUP_SIZE,
-                    sizeof(maxWorkGroupSize), &maxWorkGroupSize, nullptr);
-  info.maxWorkGroupSize = static_cast<uint32_t>(maxWorkGroupSize);
-
-  cl_ulong localMemSize;
-  f_clGetDeviceInfo(device, CL_DEVICE_LOCAL_MEM_SIZE, sizeof(localMemSize),
-                    &localMemSize, nullptr);
-  info.maxComputeSharedMemorySize = static_cast<uint32_t>(localMemSize);
-
-  cl_ulong cacheSize;
-  f_clGetDeviceInfo(device, CL_DEVICE_GLOBAL_MEM_CACHE_SIZE, sizeof(cacheSize),
-                    &cacheSize, nullptr);
-  info.l2CacheSize = static_cast<uint32_t>(cacheSize);
-
-  size_t ext_size;
-  f_clGetDeviceInfo(device, CL_DEVICE_EXTENSIONS, 0, nullptr, &ext_size);
-  std::vector<char> extensions(ext_size);
-  f_clGetDeviceInfo(device, CL_DEVICE_EXTENSIONS, ext_size, extensions.data(),
-                    nullptr);
-  std::string ext_str(extensions.data());
-
-  info.fp64Support = (ext_str.find("cl_khr_fp64") != std::string::npos ||
-                      ext_str.find("cl_amd_fp64") != std::string::npos);
-  info.fp16Support = (ext_str.find("cl_khr_fp16") != std::string::npos);
-  info.bf16Support = true;
-  info.fp8Support = false;
-  info.fp6Support = false;
-  info.fp4Support = false;
-  info.int8Support = true;
-  info.int4Support = false;
-
-  return info;
+  return currentDeviceInfo;
 }
 
 void OpenCLContext::createContext() {
@@ -387,12 +446,68 @@ void OpenCLContext::createContext() {
 
 void OpenCLContext::createCommandQueue() {
   cl_int err;
+  // Profiling is only used when a timing region is active, but has to be
+  // requested at queue creation. Fall back to a plain queue if refused.
+  if (f_clWaitForEvents && f_clGetEventProfilingInfo && f_clReleaseEvent) {
+    cl_queue_properties props[] = {CL_QUEUE_PROPERTIES,
+                                   CL_QUEUE_PROFILING_ENABLE, 0};
+    commandQueue =
+        f_clCreateCommandQueueWithProperties(context, device, props, &err);
+    if (err == CL_SUCCESS) {
+      profilingEnabled = true;
+      return;
+    }
+  }
   commandQueue = f_clCreateCommandQueueWithProperties(context, device, 0, &err);
   if (err != CL_SUCCESS) {
     throw std::runtime_error("Failed to create OpenCL command queue");
   }
 }
 
+void OpenCLContext::beginTiming() {
+  if (!profilingEnabled) {
+    IComputeContext::beginTiming();
+    return;
+  }
+  for (cl_event ev : timingEvents) {
+    f_clReleaseEvent(ev);
+  }
+  timingEvents.clear();
+  timingActive = true;
+}
+
+void OpenCLContext::endTiming() {
+  if (!profilingEnabled) {
+    IComputeContext::endTiming();
+    return;
+  }
+  timingActive = false;
+}
+
+double OpenCLContext::getTimingResult() {
+  if (!profilingEnabled) {
+    return IComputeContext::getTimingResult();
+  }
+  if (timingEvents.empty()) {
+    return 0.0;
+  }
+  f_clWaitForEvents(static_cast<cl_uint>(timingEvents.size()),
+                    timingEvents.data());
+  cl_ulong total_ns = 0;
+  for (cl_event ev : timingEvents) {
+    cl_ulong start = 0, end = 0;
+    f_clGetEventProfilingInfo(ev, CL_PROFILING_COMMAND_START, sizeof(start),
+                              &start, nullptr);
+    f_clGetEventProfilingInfo(ev, CL_PROFILING_COMMAND_END, sizeof(end), &end,
+                              nullptr);
+    if (end > start)
+      total_ns += end - start;
+    f_clReleaseEvent(ev);
+  }
+  timingEvents.clear();
+  return total_ns / 1e6;
+}
+
 ComputeBuffer OpenCLContext::createBuffer(size_t size, const void *host_ptr) {
   if (!available)
     throw std::runtime_error("OpenCL not available");
@@ -410,7 +525,71 @@ ComputeBuffer OpenCLContext::createBuffer(size_t size, const void *host_ptr) {
   if (err != CL_SUCCESS) {
     throw std::runtime_error("Failed to create OpenCL buffer");
   }
-  return new ComputeBuffer_cl{buffer};
+  return new ComputeBuffer_cl{buffer, size};
+}
+
+bool OpenCLContext::supportsBufferFlags(BufferFlags flags) const {
+  if (!available || flags == 0)
+    return false;
+  if ((flags & BUFFER_DEVICE_LOCAL) &&
+      (flags & (BUFFER_HOST_VISIBLE | BUFFER_HOST_CACHED))) {
+    cl_bool unified = CL_FALSE;
+    f_clGetDeviceInfo(device, CL_DEVICE_HOST_UNIFIED_MEMORY, sizeof(unified),
+                      &unified, nullptr);
+    return unified == CL_TRUE;
+  }
+  return true;
+}
+
+ComputeBuffer OpenCLContext::createBuffer(size_t size, BufferFlags flags) {
+  if (!supportsBufferFlags(flags))
+    throw std::runtime_error("Buffer memory flags not supported");
+  if (!(flags & (BUFFER_HOST_VISIBLE | BUFFER_HOST_CACHED)))
+    return createBuffer(size);
+  if (size == 0) {
+    throw std::runtime_error("Cannot create OpenCL buffer with size 0");
+  }
+
+  cl_int err;
+  cl_mem buffer =
+      f_clCreateBuffer(context, CL_MEM_READ_WRITE | CL_MEM_ALLOC_HOST_PTR,
+                       size, nullptr, &err);
+  if (err != CL_SUCCESS) {
+    throw std::runtime_error("Failed to create OpenCL buffer");
+  }
+  return new ComputeBuffer_cl{buffer, size, flags};
+}
+
+void *OpenCLContext::map(ComputeBuffer buffer) {
+  auto *buffer_cl = static_cast<ComputeBuffer_cl *>(buffer);
+  if (!(buffer_cl->flags & (BUFFER_HOST_VISIBLE | BUFFER_HOST_CACHED)))
+    throw std::runtime_error("Buffer is not host-visible");
+  if (buffer_cl->mapped)
+    return buffer_cl->mapped;
+
+  // Blocking map: zero-copy for CL_MEM_ALLOC_HOST_PTR on every major driver
+  cl_int err;
+  buffer_cl->mapped = f_clEnqueueMapBuffer(
+      commandQueue, buffer_cl->buffer, CL_TRUE, CL_MAP_READ | CL_MAP_WRITE, 0,
+      buffer_cl->size, 0, nullptr, nullptr, &err);
+  if (err != CL_SUCCESS) {
+    buffer_cl->mapped = nullptr;
+    throw std::runtime_error("Failed to map OpenCL buffer");
+  }
+  return buffer_cl->mapped;
+}
+
+void OpenCLContext::unmap(ComputeBuffer buffer) {
+  auto *buffer_cl = static_cast<ComputeBuffer_cl *>(buffer);
+  if (!buffer_cl->mapped)
+    return;
+  cl_int err = f_clEnqueueUnmapMemObject(commandQueue, buffer_cl->buffer,
+                                         buffer_cl->mapped, 0, nullptr,
+                                         nullptr);
+  buffer_cl->mapped = nullptr;
+  if (err != CL_SUCCESS) {
+    throw std::runtime_error("Failed to unmap OpenCL buffer");
+  }
 }
 
 void OpenCLContext::writeBuffer(ComputeBuffer buffer, size_t offset,
@@ -435,31 +614,73 @@ void OpenCLContext::readBuffer(ComputeBuffer buffer, size_t offset, size_t size,
   }
 }
 
+void OpenCLContext::fillBuffer(ComputeBuffer buffer, size_t offset,
+                               size_t size, uint32_t pattern) {
+  if (size == 0)
+    return;
+  auto *buffer_cl = static_cast<ComputeBuffer_cl *>(buffer);
+  cl_int err =
+      f_clEnqueueFillBuffer(commandQueue, buffer_cl->buffer, &pattern,
+                            sizeof(pattern), offset, size, 0, nullptr, nullptr);
+  if (err != CL_SUCCESS) {
+    throw std::runtime_error("Failed to fill OpenCL buffer");
+  }
+}
+
+void OpenCLContext::copyBuffer(ComputeBuffer src, ComputeBuffer dst,
+                               size_t src_offset, size_t dst_offset,
+                               size_t size) {
+  if (size == 0)
+    return;
+  auto *src_cl = static_cast<ComputeBuffer_cl *>(src);
+  auto *dst_cl = static_cast<ComputeBuffer_cl *>(dst);
+  cl_int err = f_clEnqueueCopyBuffer(commandQueue, src_cl->buffer,
+                                     dst_cl->buffer, src_offset, dst_offset,
+                                     size, 0, nullptr, nullptr);
+  if (err != CL_SUCCESS) {
+    throw std::runtime_error("Failed to copy OpenCL buffer");
+  }
+}
+
 void OpenCLContext::releaseBuffer(ComputeBuffer buffer) {
   if (buffer) {
     auto *buffer_cl = static_cast<ComputeBuffer_cl *>(buffer);
+    if (buffer_cl->mapped)
+      unmap(buffer);
     f_clReleaseMemObject(buffer_cl->buffer);
     delete buffer_cl;
   }
 }
 
-ComputeKernel OpenCLContext::createKernel(const std::string &file_name,
-                                          const std::string &kernel_name,
-                                          uint32_t num_args) {
-  notifyKernelCreated(file_name);
+cl_program OpenCLContext::buildProgram(const std::string &file_name,
+                                      bool skip_cached) {
   if (!available)
     throw std::runtime_error("OpenCL not available");
+  std::ifstream file(file_name);
+  if (!file.is_open()) {
+    throw std::runtime_error("Failed to open kernel file: " + file_name);
+  }
+  std::string source((std::istreambuf_iterator<char>(file)),
+                     std::istreambuf_iterator<char>());
+
+  // The compiler is the driver, already part of the cache directory; no
+  // build options are passed
+  uint64_t cacheKey = utils::ShaderCache::makeKey(source, "", "opencl");
+
   cl_int err;
   cl_program program;
-  std::vector<char> program_binary;
-  if (utils::ShaderCache::loadOpenCLCache(
-          file_name, getDevices()[selectedDeviceIndex], program_binary)) {
+  utils::ShaderCache::Blob cached_binary;
+  bool from_cache = utils::ShaderCache::loadOpenCLCache(
+      cacheKey, currentDeviceInfo, cached_binary);
+  if (from_cache && skip_cached)
+    return nullptr;
+  if (from_cache) {
     if (verbose) {
       std::cout << "Loaded OpenCL kernel from cache: " << file_name << std::endl;
     }
     const unsigned char *binary_ptr =
-        reinterpret_cast<const unsigned char *>(program_binary.data());
-    size_t binary_size = program_binary.size();
+        reinterpret_cast<const unsigned char *>(cached_binary.data);
+    size_t binary_size = cached_binary.size;
     cl_int binary_status;
     program = f_clCreateProgramWithBinary(context, 1, &device, &binary_size,
                                           &binary_ptr, &binary_status, &err);
@@ -467,13 +688,6 @@ ComputeKernel OpenCLContext::createKernel(const std::string &file_name,
       throw std::runtime_error("Failed to create OpenCL program from binary");
     }
   } else {
-    std::ifstream file(file_name);
-    if (!file.is_open()) {
-      throw std::runtime_error("Failed to open kernel file: " + file_name);
-    }
-    std::string source((std::istreambuf_iterator<char>(file)),
-                       std::istreambuf_iterator<char>());
-
     if (verbose) {
       std::cout << "--- OPENCL COMPILER READING KERNEL ---" << std::endl;
       std::cout << "File: " << file_name << std::endl;
@@ -504,20 +718,35 @@ ComputeKernel OpenCLContext::createKernel(const std::string &file_name,
     throw std::runtime_error("Failed to build OpenCL program: " + log_str);
   }
 
-  if (program_binary.empty()) {
+  if (!from_cache) {
     size_t binary_size;
     f_clGetProgramInfo(program, CL_PROGRAM_BINARY_SIZES, sizeof(size_t),
                        &binary_size, nullptr);
     if (binary_size > 0) {
-      program_binary.resize(binary_size);
+      std::vector<char> program_binary(binary_size);
       char *bin_ptr = program_binary.data();
       f_clGetProgramInfo(program, CL_PROGRAM_BINARIES, sizeof(char *), &bin_ptr,
                          nullptr);
       utils::ShaderCache::saveOpenCLCache(
-          file_name, getDevices()[selectedDeviceIndex], program_binary);
+          cacheKey, currentDeviceInfo, program_binary);
     }
   }
+  return program;
+}
+
+void OpenCLContext::precompileKernel(const KernelSource &source) {
+  cl_program program = buildProgram(source.file, true);
+  if (program)
+    f_clReleaseProgram(program);
+}
 
+ComputeKernel OpenCLContext::createKernel(const std::string &file_name,
+                                          const std::string &kernel_name,
+                                          uint32_t num_args) {
+  notifyKernelCreated(file_name);
+  cl_program program = buildProgram(file_name, false);
+
+  cl_int err;
   cl_kernel kernel = f_clCreateKernel(program, kernel_name.c_str(), &err);
   if (err != CL_SUCCESS) {
     f_clReleaseProgram(program);
@@ -556,20 +785,102 @@ void OpenCLContext::setKernelArg(ComputeKernel kernel, uint32_t arg_index,
 void OpenCLContext::dispatch(ComputeKernel kernel, uint32_t grid_x,
                              uint32_t grid_y, uint32_t grid_z, uint32_t block_x,
                              uint32_t block_y, uint32_t block_z) {
+  dispatchBatch(kernel, grid_x, grid_y, grid_z, block_x, block_y, block_z, 1);
+}
+
+void OpenCLContext::dispatchBatch(ComputeKernel kernel, uint32_t grid_x,
+                                  uint32_t grid_y, uint32_t grid_z,
+                                  uint32_t block_x, uint32_t block_y,
+                                  uint32_t block_z, uint32_t count) {
+  enqueueBatch(kernel, grid_x, grid_y, grid_z, block_x, block_y, block_z,
+               count, nullptr);
+}
+
+void OpenCLContext::enqueueBatch(ComputeKernel kernel, uint32_t grid_x,
+                                 uint32_t grid_y, uint32_t grid_z,
+                                 uint32_t block_x, uint32_t block_y,
+                                 uint32_t block_z, uint32_t count,
+                                 cl_event *last_event) {
   auto *kernel_cl = static_cast<ComputeKernel_cl *>(kernel);
   size_t global_work_size[3] = {(size_t)grid_x * block_x,
                                 (size_t)grid_y * block_y,
                                 (size_t)grid_z * block_z};
   size_t local_work_size[3] = {(size_t)block_x, (size_t)block_y,
                                (size_t)block_z};
-  cl_int err = f_clEnqueueNDRangeKernel(commandQueue, kernel_cl->kernel, 3,
-                                        nullptr, global_work_size,
-                                        local_work_size, 0, nullptr, nullptr);
+  // The queue is in-order and only synchronized by waitIdle(), so there is
+  // no host round trip between the dispatches of a batch
+  for (uint32_t i = 0; i < count; ++i) {
+    cl_event event = nullptr;
+    bool wantEvent = timingActive || (last_event && i + 1 == count);
+    cl_int err = f_clEnqueueNDRangeKernel(
+        commandQueue, kernel_cl->kernel, 3, nullptr, global_work_size,
+        local_work_size, 0, nullptr, wantEvent ? &event : nullptr);
+    if (err != CL_SUCCESS) {
+      throw std::runtime_error("Failed to dispatch OpenCL kernel");
+    }
+    if (!event)
+      continue;
+    if (last_event && i + 1 == count) {
+      *last_event = event;
+      if (timingActive) {
+        f_clRetainEvent(event);
+        timingEvents.push_back(event);
+      }
+    } else {
+      timingEvents.push_back(event);
+    }
+  }
+}
+
+DispatchHandle OpenCLContext::dispatchAsync(ComputeKernel kernel,
+                                           uint32_t grid_x, uint32_t grid_y,
+                                           uint32_t grid_z, uint32_t block_x,
+                                           uint32_t block_y, uint32_t block_z,
+                                           uint32_t count) {
+  if (count == 0)
+    return 0;
+  cl_event event = nullptr;
+  enqueueBatch(kernel, grid_x, grid_y, grid_z, block_x, block_y, block_z,
+               count, &event);
+  // Make sure the work starts without a later blocking call
+  f_clFlush(commandQueue);
+  DispatchHandle handle = ++lastAsyncHandle;
+  asyncEvents[handle] = event;
+  return handle;
+}
+
+void OpenCLContext::wait(DispatchHandle handle) {
+  auto it = asyncEvents.find(handle);
+  if (it == asyncEvents.end())
+    return; // Already completed (or retired by waitIdle)
+  cl_int err = f_clWaitForEvents(1, &it->second);
+  f_clReleaseEvent(it->second);
+  asyncEvents.erase(it);
   if (err != CL_SUCCESS) {
-    throw std::runtime_error("Failed to dispatch OpenCL kernel");
+    throw std::runtime_error("clWaitForEvents failed: " + std::to_string(err));
   }
 }
 
+bool OpenCLContext::poll(DispatchHandle handle) {
+  auto it = asyncEvents.find(handle);
+  if (it == asyncEvents.end())
+    return true;
+  cl_int status = CL_QUEUED;
+  f_clGetEventInfo(it->second, CL_EVENT_COMMAND_EXECUTION_STATUS,
+                   sizeof(status), &status, nullptr);
+  if (status < 0) {
+    f_clReleaseEvent(it->second);
+    asyncEvents.erase(it);
+    throw std::runtime_error("OpenCL dispatch failed: " +
+                             std::to_string(status));
+  }
+  if (status != CL_COMPLETE)
+    return false;
+  f_clReleaseEvent(it->second);
+  asyncEvents.erase(it);
+  return true;
+}
+
 void OpenCLContext::releaseKernel(ComputeKernel kernel) {
   if (kernel) {
     auto *kernel_cl = static_cast<ComputeKernel_cl *>(kernel);
@@ -4,6 +4,7 @@
 #define CL_TARGET_OPENCL_VERSION 300
 #include "utils/DynamicLibrary.h"
 #include <CL/cl.h>
+#include <map>
 #include <memory>
 #include <stdexcept>
 #include <string>
@@ -22,7 +23,7 @@ public:
   bool isAvailable() const override { return available; }
   const std::vector<DeviceInfo> &getDevices() const override;
   void pickDevice(uint32_t index) override;
-  DeviceInfo getCurrentDeviceInfo() const override;
+  const DeviceInfo &getCurrentDeviceInfo() const override;
   uint32_t getSelectedDeviceIndex() const override {
     return selectedDeviceIndex;
   }
@@ -43,11 +44,22 @@ public:
   void readBuffer(ComputeBuffer buffer, size_t offset, size_t size,
                   void *host_ptr) const override;
   void releaseBuffer(ComputeBuffer buffer) override;
+  void fillBuffer(ComputeBuffer buffer, size_t offset, size_t size,
+                  uint32_t pattern) override;
+  void copyBuffer(ComputeBuffer src, ComputeBuffer dst, size_t src_offset,
+                  size_t dst_offset, size_t size) override;
+  // Host-visible buffers use CL_MEM_ALLOC_HOST_PTR; device-local memory is
+  // only host-reachable (BUFFER_REBAR) on unified-memory devices
+  bool supportsBufferFlags(BufferFlags flags) const override;
+  ComputeBuffer createBuffer(size_t size, BufferFlags flags) override;
+  void *map(ComputeBuffer buffer) override;
+  void unmap(ComputeBuffer buffer) override;
 
   // Kernel management
   ComputeKernel createKernel(const std::string &file_name,
                              const std::string &kernel_name,
                              uint32_t num_args) override;
+  void precompileKernel(const KernelSource &source) override;
   void setKernelArg(ComputeKernel kernel, uint32_t arg_index,
                     ComputeBuffer buffer) override;
   void setKernelAS(ComputeKernel kernel, uint32_t arg_index,
@@ -59,15 +71,35 @@ public:
   void dispatch(ComputeKernel kernel, uint32_t grid_x, uint32_t grid_y,
                 uint32_t grid_z, uint32_t block_x, uint32_t block_y,
                 uint32_t block_z) override;
+  void dispatchBatch(ComputeKernel kernel, uint32_t grid_x, uint32_t grid_y,
+                     uint32_t grid_z, uint32_t block_x, uint32_t block_y,
+                     uint32_t block_z, uint32_t count) override;
+  // Async dispatch: the handle maps to the event of the batch's last kernel
+  DispatchHandle dispatchAsync(ComputeKernel kernel, uint32_t grid_x,
+                               uint32_t grid_y, uint32_t grid_z,
+                               uint32_t block_x, uint32_t block_y,
+                               uint32_t block_z, uint32_t count = 1) override;
+  void wait(DispatchHandle handle) override;
+  bool poll(DispatchHandle handle) override;
+  bool hasAsyncDispatch() const override { return available; }
   void releaseKernel(ComputeKernel kernel) override;
   void waitIdle() override;
 
+  // Device timing via CL_QUEUE_PROFILING_ENABLE events on each dispatch
+  bool hasDeviceTimer() const override { return profilingEnabled; }
+  void beginTiming() override;
+  void endTiming() override;
+  double getTimingResult() override;
+
   // OpenCL-specific accessors
   cl_command_queue getCommandQueue() const { return commandQueue; }
 
 private:
   struct ComputeBuffer_cl {
     cl_mem buffer;
+    size_t size = 0;
+    BufferFlags flags = BUFFER_DEVICE_LOCAL;
+    void *mapped = nullptr;
   };
 
   struct ComputeKernel_cl {
@@ -75,6 +107,13 @@ private:
     cl_kernel kernel;
   };
 
+  void enqueueBatch(ComputeKernel kernel, uint32_t grid_x, uint32_t grid_y,
+                    uint32_t grid_z, uint32_t block_x, uint32_t block_y,
+                    uint32_t block_z, uint32_t count, cl_event *last_event);
+  // Builds file_name, from the ShaderCache when it has the binary. With
+  // skip_cached, a cache hit returns null instead of building.
+  cl_program buildProgram(const std::string &file_name, bool skip_cached);
+  static DeviceInfo queryDeviceInfo(cl_device_id dev);
   void enumeratePlatformsAndDevices();
   void createContext();
   void createCommandQueue();
@@ -90,8 +129,15 @@ private:
   cl_device_id device = nullptr;
   cl_context context = nullptr;
   cl_command_queue commandQueue = nullptr;
+  bool profilingEnabled = false;
+  bool timingActive = false;
+  std::vector<cl_event> timingEvents;
+  std::map<DispatchHandle, cl_event> asyncEvents;
+  DispatchHandle lastAsyncHandle = 0;
 
   mutable std::vector<DeviceInfo> deviceInfos;
+  // Queried once by pickDevice()
+  DeviceInfo currentDeviceInfo;
   uint32_t selectedDeviceIndex = 0;
   uint32_t expectedKernelCount = 0;
   uint32_t createdKernelCount = 0;
@@ -12,6 +12,7 @@
 #endif
 #include "utils/ShaderCache.h"
 #include <cstring>
+#include <filesystem>
 #include <fstream>
 #include <algorithm>
 #include <cctype>
@@ -30,7 +31,12 @@ typedef hipError_t (*p_hipSetDevice)(int);
 typedef const char *(*p_hipGetErrorString)(hipError_t);
 typedef hipError_t (*p_hipMalloc)(void **, size_t);
 typedef hipError_t (*p_hipMemcpy)(void *, const void *, size_t, hipMemcpyKind);
+typedef hipError_t (*p_hipMemsetD32)(hipDeviceptr_t, int, size_t);
+typedef hipError_t (*p_hipMemcpyDtoD)(hipDeviceptr_t, hipDeviceptr_t, size_t);
 typedef hipError_t (*p_hipFree)(void *);
+typedef hipError_t (*p_hipHostMalloc)(void **, size_t, unsigned int);
+typedef hipError_t (*p_hipHostGetDevicePointer)(void **, void *, unsigned int);
+typedef hipError_t (*p_hipHostFree)(void *);
 typedef hipError_t (*p_hipModuleLoadData)(hipModule_t *, const void *);
 typedef hipError_t (*p_hipModuleLoad)(hipModule_t *, const char *);
 typedef hipError_t (*p_hipModuleGetFunction)(hipFunction_t *, hipModule_t,
@@ -41,6 +47,12 @@ typedef hipError_t (*p_hipModuleLaunchKernel)(hipFunction_t, unsigned int,
                                               unsigned int, unsigned int,
                                               hipStream_t, void **, void **);
 typedef hipError_t (*p_hipDeviceSynchronize)(void);
+typedef hipError_t (*p_hipEventCreate)(hipEvent_t *);
+typedef hipError_t (*p_hipEventRecord)(hipEvent_t, hipStream_t);
+typedef hipError_t (*p_hipEventSynchronize)(hipEvent_t);
+typedef hipError_t (*p_hipEventElapsedTime)(float *, hipEvent_t, hipEvent_t);
+typedef hipError_t (*p_hipEventDestroy)(hipEvent_t);
+typedef hipError_t (*p_hipEventQuery)(hipEvent_t);
 
 // Function pointers for HIPRTC
 #ifdef HAVE_HIPRTC
@@ -54,6 +66,7 @@ typedef hiprtcResult (*p_hiprtcGetProgramLog)(hiprtcProgram, char *);
 typedef hiprtcResult (*p_hiprtcGetCodeSize)(hiprtcProgram, size_t *);
 typedef hiprtcResult (*p_hiprtcGetCode)(hiprtcProgram, char *);
 typedef hiprtcResult (*p_hiprtcDestroyProgram)(hiprtcProgram *);
+typedef hiprtcResult (*p_hiprtcVersion)(int *, int *);
 
 static p_hiprtcCreateProgram f_hiprtcCreateProgram;
 static p_hiprtcCompileProgram f_hiprtcCompileProgram;
@@ -62,6 +75,7 @@ static p_hiprtcGetProgramLog f_hiprtcGetProgramLog;
 static p_hiprtcGetCodeSize f_hiprtcGetCodeSize;
 static p_hiprtcGetCode f_hiprtcGetCode;
 static p_hiprtcDestroyProgram f_hiprtcDestroyProgram;
+static p_hiprtcVersion f_hiprtcVersion;
 #endif
 
 static p_hipInit f_hipInit;
@@ -72,12 +86,23 @@ static p_hipSetDevice f_hipSetDevice;
 static p_hipGetErrorString f_hipGetErrorString;
 static p_hipMalloc f_hipMalloc;
 static p_hipMemcpy f_hipMemcpy;
+static p_hipMemsetD32 f_hipMemsetD32;
+static p_hipMemcpyDtoD f_hipMemcpyDtoD;
 static p_hipFree f_hipFree;
+static p_hipHostMalloc f_hipHostMalloc;
+static p_hipHostGetDevicePointer f_hipHostGetDevicePointer;
+static p_hipHostFree f_hipHostFree;
 static p_hipModuleLoadData f_hipModuleLoadData;
 static p_hipModuleLoad f_hipModuleLoad;
 static p_hipModuleGetFunction f_hipModuleGetFunction;
 static p_hipModuleLaunchKernel f_hipModuleLaunchKernel;
 static p_hipDeviceSynchronize f_hipDeviceSynchronize;
+static p_hipEventCreate f_hipEventCreate;
+static p_hipEventRecord f_hipEventRecord;
+static p_hipEventSynchronize f_hipEventSynchronize;
+static p_hipEventElapsedTime f_hipEventElapsedTime;
+static p_hipEventDestroy f_hipEventDestroy;
+static p_hipEventQuery f_hipEventQuery;
 
 bool ROCmContext::loadLibraries() {
   if (librariesLoaded)
@@ -105,7 +130,13 @@ bool ROCmContext::loadLibraries() {
         hipLib->getFunction<p_hipGetErrorString>("hipGetErrorString");
     f_hipMalloc = hipLib->getFunction<p_hipMalloc>("hipMalloc");
     f_hipMemcpy = hipLib->getFunction<p_hipMemcpy>("hipMemcpy");
+    f_hipMemsetD32 = hipLib->getFunction<p_hipMemsetD32>("hipMemsetD32");
+    f_hipMemcpyDtoD = hipLib->getFunction<p_hipMemcpyDtoD>("hipMemcpyDtoD");
     f_hipFree = hipLib->getFunction<p_hipFree>("hipFree");
+    f_hipHostMalloc = hipLib->getFunction<p_hipHostMalloc>("hipHostMalloc");
+    f_hipHostGetDevicePointer = hipLib->getFunction<p_hipHostGetDevicePointer>(
+        "hipHostGetDevicePointer");
+    f_hipHostFree = hipLib->getFunction<p_hipHostFree>("hipHostFree");
     f_hipModuleLoadData =
         hipLib->getFunction<p_hipModuleLoadData>("hipModuleLoadData");
     f_hipModuleLoad = hipLib->getFunction<p_hipModuleLoad>("hipModuleLoad");
@@ -115,6 +146,15 @@ bool ROCmContext::loadLibraries() {
         hipLib->getFunction<p_hipModuleLaunchKernel>("hipModuleLaunchKernel");
     f_hipDeviceSynchronize =
         hipLib->getFunction<p_hipDeviceSynchronize>("hipDeviceSynchronize");
+    f_hipEventCreate = hipLib->getFunction<p_hipEventCreate>("hipEventCreate");
+    f_hipEventRecord = hipLib->getFunction<p_hipEventRecord>("hipEventRecord");
+    f_hipEventSynchronize =
+        hipLib->getFunction<p_hipEventSynchronize>("hipEventSynchronize");
+    f_hipEventElapsedTime =
+        hipLib->getFunction<p_hipEventElapsedTime>("hipEventElapsedTime");
+    f_hipEventDestroy =
+        hipLib->getFunction<p_hipEventDestroy>("hipEventDestroy");
+    f_hipEventQuery = hipLib->getFunction<p_hipEventQuery>("hipEventQuery");
 
 #ifdef HAVE_HIPRTC
 #ifdef _WIN32
@@ -145,6 +185,8 @@ bool ROCmContext::loadLibraries() {
           hiprtcLib->getFunction<p_hiprtcGetCode>("hiprtcGetCode");
       f_hiprtcDestroyProgram = hiprtcLib->getFunction<p_hiprtcDestroyProgram>(
           "hiprtcDestroyProgram");
+      f_hiprtcVersion =
+          hiprtcLib->getFunction<p_hiprtcVersion>("hiprtcVersion");
     }
 #endif
   }
@@ -166,10 +208,25 @@ ROCmContext::ROCmContext(bool verbose)
   }
 
   available = true;
+  eventsSupported = f_hipEventCreate && f_hipEventRecord &&
+                    f_hipEventSynchronize && f_hipEventElapsedTime &&
+                    f_hipEventDestroy;
+  asyncSupported = eventsSupported && f_hipEventQuery;
   enumerateDevices();
 }
 
-ROCmContext::~ROCmContext() = default;
+ROCmContext::~ROCmContext() {
+  for (auto &ev : timingEvents) {
+    f_hipEventDestroy(ev.first);
+    f_hipEventDestroy(ev.second);
+  }
+  for (auto &entry : asyncEvents) {
+    f_hipEventDestroy(entry.second);
+  }
+  for (hipEvent_t ev : freeAsyncEvents) {
+    f_hipEventDestroy(ev);
+  }
+}
 
 void ROCmContext::enumerateDevices() {
   if (!available)
@@ -197,6 +254,11 @@ void ROCmContext::enumerateDevices() {
                prop.pciDeviceID, i);
       info.driverUUID = std::string(uuid_str);
 
+      char pci_str[16];
+      snprintf(pci_str, sizeof(pci_str), "%04x:%02x:%02x.0",
+               prop.pciDomainID, prop.pciBusID, prop.pciDeviceID);
+      info.pciBusId = pci_str;
+
       info.memorySize = prop.totalGlobalMem;
       info.verbose = verbose;
       info.maxWorkGroupSize = prop.maxThreadsPerBlock;
@@ -206,6 +268,7 @@ void ROCmContext::enumerateDevices() {
       info.maxComputeSharedMemorySize = prop.sharedMemPerBlock;
       info.subgroupSize = prop.warpSize;
       info.l2CacheSize = prop.l2CacheSize;
+      info.unifiedMemory = (prop.integrated != 0);
 
       std::string archNameStr = prop.gcnArchName;
       std::string deviceNameStr = prop.name;
@@ -237,6 +300,16 @@ void ROCmContext::enumerateDevices() {
   }
 }
 
+void ROCmContext::bindToCurrentThread() {
+  if (!available || selectedDeviceIndex < 0)
+    return;
+  hipError_t err = f_hipSetDevice(selectedDeviceIndex);
+  if (err != hipSuccess) {
+    throw std::runtime_error("Failed to set HIP device: " +
+                             std::string(f_hipGetErrorString(err)));
+  }
+}
+
 void ROCmContext::pickDevice(uint32_t index) {
   if (!available || index >= devices.size()) {
     throw std::runtime_error("Invalid device index or ROCm not available");
@@ -261,7 +334,7 @@ void ROCmContext::pickDevice(uint32_t index) {
   }
 }
 
-DeviceInfo ROCmContext::getCurrentDeviceInfo() const {
+const DeviceInfo &ROCmContext::getCurrentDeviceInfo() const {
   if (selectedDeviceIndex < 0 ||
       selectedDeviceIndex >= static_cast<int>(devices.size())) {
     throw std::runtime_error("No device selected. Call pickDevice() first.");
@@ -316,7 +389,84 @@ void ROCmContext::readBuffer(ComputeBuffer buffer, size_t offset, size_t size,
   }
 }
 
+void ROCmContext::fillBuffer(ComputeBuffer buffer, size_t offset, size_t size,
+                             uint32_t pattern) {
+  if (size == 0)
+    return;
+  hipDeviceptr_t device_ptr = static_cast<char *>(buffer) + offset;
+  if (f_hipMemsetD32(device_ptr, static_cast<int>(pattern),
+                     size / sizeof(uint32_t)) != hipSuccess) {
+    throw std::runtime_error("Failed to fill buffer");
+  }
+}
+
+void ROCmContext::copyBuffer(ComputeBuffer src, ComputeBuffer dst,
+                             size_t src_offset, size_t dst_offset,
+                             size_t size) {
+  if (size == 0)
+    return;
+  hipDeviceptr_t src_ptr = static_cast<char *>(src) + src_offset;
+  hipDeviceptr_t dst_ptr = static_cast<char *>(dst) + dst_offset;
+  if (f_hipMemcpyDtoD(dst_ptr, src_ptr, size) != hipSuccess) {
+    throw std::runtime_error("Failed to copy buffer");
+  }
+}
+
+bool ROCmContext::supportsBufferFlags(BufferFlags flags) const {
+  if (!available || selectedDeviceIndex < 0 || flags == 0)
+    return false;
+  // Pinned host memory is only device-local when the GPU shares it
+  if ((flags & BUFFER_DEVICE_LOCAL) &&
+      (flags & (BUFFER_HOST_VISIBLE | BUFFER_HOST_CACHED)))
+    return devices[selectedDeviceIndex].unifiedMemory;
+  return true;
+}
+
+ComputeBuffer ROCmContext::createBuffer(size_t size, BufferFlags flags) {
+  if (!supportsBufferFlags(flags))
+    throw std::runtime_error("Buffer memory flags not supported");
+  if (!(flags & (BUFFER_HOST_VISIBLE | BUFFER_HOST_CACHED)))
+    return createBuffer(size);
+
+  // Coherent (fine-grained) memory bypasses the GPU caches; host-cached
+  // buffers trade that for coarse-grained memory synchronized at kernel
+  // boundaries
+  unsigned int hostFlags = hipHostMallocMapped;
+  if (flags & BUFFER_HOST_CACHED)
+    hostFlags |= hipHostMallocNonCoherent;
+  void *host_ptr = nullptr;
+  hipError_t err = f_hipHostMalloc(&host_ptr, size, hostFlags);
+  if (err != hipSuccess) {
+    throw std::runtime_error("Failed to allocate host memory: " +
+                             std::string(f_hipGetErrorString(err)));
+  }
+  void *device_ptr = nullptr;
+  err = f_hipHostGetDevicePointer(&device_ptr, host_ptr, 0);
+  if (err != hipSuccess) {
+    (void)f_hipHostFree(host_ptr);
+    throw std::runtime_error("Failed to map host memory: " +
+                             std::string(f_hipGetErrorString(err)));
+  }
+  hostBuffers[device_ptr] = host_ptr;
+  return device_ptr;
+}
+
+void *ROCmContext::map(ComputeBuffer buffer) {
+  auto it = hostBuffers.find(buffer);
+  if (it == hostBuffers.end())
+    throw std::runtime_error("Buffer is not host-visible");
+  return it->second;
+}
+
 void ROCmContext::releaseBuffer(ComputeBuffer buffer) {
+  auto it = hostBuffers.find(buffer);
+  if (it != hostBuffers.end()) {
+    if (f_hipHostFree(it->second) != hipSuccess) {
+      std::cerr << "hipHostFree failed" << std::endl;
+    }
+    hostBuffers.erase(it);
+    return;
+  }
   if (buffer) {
     if (f_hipFree(buffer) != hipSuccess) {
       std::cerr << "hipFree failed" << std::endl;
@@ -324,6 +474,100 @@ void ROCmContext::releaseBuffer(ComputeBuffer buffer) {
   }
 }
 
+#ifdef HAVE_HIPRTC
+void ROCmContext::compileHip(const std::string &file_name,
+                             std::vector<char> &code,
+                             utils::ShaderCache::Blob &cached_code) const {
+  std::ifstream file(file_name);
+  if (!file.is_open()) {
+    throw std::runtime_error("Failed to open HIP source file: " + file_name);
+  }
+  std::string source((std::istreambuf_iterator<char>(file)),
+                     std::istreambuf_iterator<char>());
+
+  std::string offload_arch =
+      "--offload-arch=" + devices[selectedDeviceIndex].archName;
+  const char *opts[] = {offload_arch.c_str(), "-I/usr/include",
+                        "-I/opt/rocm/include", "-I/usr/local/include"};
+  std::string optionsKey;
+  for (const char *opt : opts)
+    optionsKey += std::string(opt) + " ";
+  int hiprtcMajor = 0, hiprtcMinor = 0;
+  if (f_hiprtcVersion)
+    f_hiprtcVersion(&hiprtcMajor, &hiprtcMinor);
+  uint64_t cacheKey = utils::ShaderCache::makeKey(
+      source, optionsKey,
+      "hiprtc " + std::to_string(hiprtcMajor) + "." +
+          std::to_string(hiprtcMinor));
+
+  if (utils::ShaderCache::loadROCmCache(
+          cacheKey, devices[selectedDeviceIndex], cached_code)) {
+    if (verbose) {
+      std::cout << "Loaded HIP kernel from cache: " << file_name << std::endl;
+    }
+  } else {
+    if (verbose) {
+      std::cout << "Attempting to compile HIP source: " << file_name
+                << std::endl;
+    }
+    hiprtcProgram prog;
+    f_hiprtcCreateProgram(&prog, source.c_str(), file_name.c_str(), 0,
+                          nullptr, nullptr);
+
+    hiprtcResult compileResult = f_hiprtcCompileProgram(prog, 4, opts);
+
+    if (compileResult != HIPRTC_SUCCESS) {
+      std::cout << "HIPRTC compilation failed with code: " << compileResult
+                << std::endl;
+      std::cout << "Source snippet: "
+                << source.substr(0, std::min(source.length(), (size_t)150))
+                << std::endl;
+      size_t logSize = 0;
+      hiprtcResult logSizeRes = f_hiprtcGetProgramLogSize(prog, &logSize);
+      std::cout << "HIPRTC logSizeRes=" << logSizeRes
+                << " logSize=" << logSize << std::endl;
+      std::string log_str = "No log available";
+      if (logSize > 0) {
+        std::vector<char> log(logSize);
+        hiprtcResult logRes = f_hiprtcGetProgramLog(prog, log.data());
+        std::cout << "HIPRTC get log res: " << logRes << std::endl;
+        log_str = std::string(log.data(), logSize);
+      }
+      f_hiprtcDestroyProgram(&prog);
+      throw std::runtime_error("Failed to compile HIP kernel " + file_name +
+                               ":\n" + log_str);
+    }
+
+    size_t codeSize;
+    f_hiprtcGetCodeSize(prog, &codeSize);
+    code.resize(codeSize);
+    f_hiprtcGetCode(prog, code.data());
+    f_hiprtcDestroyProgram(&prog);
+
+    utils::ShaderCache::saveROCmCache(cacheKey,
+                                      devices[selectedDeviceIndex], code);
+  }
+}
+
+#endif
+
+void ROCmContext::precompileKernel(const KernelSource &source) {
+#ifdef HAVE_HIPRTC
+  // Mirrors createKernel(): a pre-compiled .co next to the source wins
+  const std::string &file_name = source.file;
+  if (!available || selectedDeviceIndex < 0 || !hiprtcLib ||
+      !hiprtcLib->isValid() || file_name.size() <= 4 ||
+      file_name.substr(file_name.size() - 4) != ".hip")
+    return;
+  std::string co_file_name = file_name.substr(0, file_name.size() - 4) + ".co";
+  if (std::filesystem::exists(co_file_name))
+    return;
+  std::vector<char> code;
+  utils::ShaderCache::Blob cached_code;
+  compileHip(file_name, code, cached_code);
+#endif
+}
+
 ComputeKernel ROCmContext::createKernel(const std::string &file_name,
                                         const std::string &kernel_name,
                                         uint32_t num_args) {
@@ -363,68 +607,12 @@ ComputeKernel ROCmContext::createKernel(const std::string &file_name,
     if (is_hip && hiprtcLib && hiprtcLib->isValid() &&
         !loaded_co_successfully) {
       std::vector<char> code;
-      if (utils::ShaderCache::loadROCmCache(
-              file_name, devices[selectedDeviceIndex], code)) {
-        if (verbose) {
-          std::cout << "Loaded HIP kernel from cache: " << file_name
-                    << std::endl;
-        }
-      } else {
-        if (verbose) {
-          std::cout << "Attempting to compile HIP source: " << file_name
-                    << std::endl;
-        }
-        std::ifstream file(file_name);
-        if (!file.is_open()) {
-          throw std::runtime_error("Failed to open HIP source file: " +
-                                   file_name);
-        }
-        std::string source((std::istreambuf_iterator<char>(file)),
-                           std::istreambuf_iterator<char>());
-
-        hiprtcProgram prog;
-        f_hiprtcCreateProgram(&prog, source.c_str(), file_name.c_str(), 0,
-                              nullptr, nullptr);
-
-        std::string offload_arch =
-            "--offload-arch=" + devices[selectedDeviceIndex].archName;
-        const char *opts[] = {offload_arch.c_str(), "-I/usr/include",
-                              "-I/opt/rocm/include", "-I/usr/local/include"};
-        hiprtcResult compileResult = f_hiprtcCompileProgram(prog, 4, opts);
-
-        if (compileResult != HIPRTC_SUCCESS) {
-          std::cout << "HIPRTC compilation failed with code: " << compileResult
-                    << std::endl;
-          std::cout << "Source snippet: "
-                    << source.substr(0, std::min(source.length(), (size_t)150))
-                    << std::endl;
-          size_t logSize = 0;
-          hiprtcResult logSizeRes = f_hiprtcGetProgramLogSize(prog, &logSize);
-          std::cout << "HIPRTC logSizeRes=" << logSizeRes
-                    << " logSize=" << logSize << std::endl;
-          std::string log_str = "No log available";
-          if (logSize > 0) {
-            std::vector<char> log(logSize);
-            hiprtcResult logRes = f_hiprtcGetProgramLog(prog, log.data());
-            std::cout << "HIPRTC get log res: " << logRes << std::endl;
-            log_str = std::string(log.data(), logSize);
-          }
-          f_hiprtcDestroyProgram(&prog);
-          throw std::runtime_error("Failed to compile HIP kernel " + file_name +
-                                   ":\n" + log_str);
-        }
-
-        size_t codeSize;
-        f_hiprtcGetCodeSize(prog, &codeSize);
-        code.resize(codeSize);
-        f_hiprtcGetCode(prog, code.data());
-        f_hiprtcDestroyProgram(&prog);
-
-        utils::ShaderCache::saveROCmCache(file_name,
-                                          devices[selectedDeviceIndex], code);
-      }
+      // Cache hits point into the ShaderCache archive mapping instead
+      utils::ShaderCache::Blob cached_code;
+      compileHip(file_name, code, cached_code);
 
-      hipError_t err = f_hipModuleLoadData(&module, code.data());
+      hipError_t err = f_hipModuleLoadData(
+          &module, cached_code.data ? cached_code.data : code.data());
       if (err != hipSuccess) {
         throw std::runtime_error("Failed to load compiled HIP module: " +
                                  std::string(f_hipGetErrorString(err)));
@@ -505,6 +693,15 @@ void ROCmContext::setKernelArg(ComputeKernel kernel, uint32_t arg_index,
 void ROCmContext::dispatch(ComputeKernel kernel, uint32_t grid_x,
                            uint32_t grid_y, uint32_t grid_z, uint32_t block_x,
                            uint32_t block_y, uint32_t block_z) {
+  dispatchBatch(kernel, grid_x, grid_y, grid_z, block_x, block_y, block_z, 1);
+}
+
+void ROCmContext::dispatchBatch(ComputeKernel kernel, uint32_t grid_x,
+                                uint32_t grid_y, uint32_t grid_z,
+                                uint32_t block_x, uint32_t block_y,
+                                uint32_t block_z, uint32_t count) {
+  if (count == 0)
+    return;
   auto it = kernels.find(kernel);
   if (it == kernels.end()) {
     throw std::runtime_error("Invalid kernel handle");
@@ -518,10 +715,31 @@ void ROCmContext::dispatch(ComputeKernel kernel, uint32_t grid_x,
     }
   }
 
-  if (f_hipModuleLaunchKernel(it->second.function, grid_x, grid_y, grid_z,
-                              block_x, block_y, block_z, 0, nullptr,
-                              arg_pointers.data(), nullptr) != hipSuccess) {
-    throw std::runtime_error("Failed to launch kernel");
+  std::pair<hipEvent_t, hipEvent_t> *events = nullptr;
+  if (timingActive) {
+    if (timingEventsUsed == timingEvents.size()) {
+      std::pair<hipEvent_t, hipEvent_t> ev{nullptr, nullptr};
+      if (f_hipEventCreate(&ev.first) != hipSuccess ||
+          f_hipEventCreate(&ev.second) != hipSuccess) {
+        throw std::runtime_error("hipEventCreate failed");
+      }
+      timingEvents.push_back(ev);
+    }
+    events = &timingEvents[timingEventsUsed++];
+    f_hipEventRecord(events->first, nullptr);
+  }
+
+  // Launches on the null stream are ordered; one event pair spans the batch
+  for (uint32_t i = 0; i < count; ++i) {
+    if (f_hipModuleLaunchKernel(it->second.function, grid_x, grid_y, grid_z,
+                                block_x, block_y, block_z, 0, nullptr,
+                                arg_pointers.data(), nullptr) != hipSuccess) {
+      throw std::runtime_error("Failed to launch kernel");
+    }
+  }
+
+  if (events) {
+    f_hipEventRecord(events->second, nullptr);
   }
 }
 
@@ -537,6 +755,103 @@ void ROCmContext::waitIdle() {
   if (available && f_hipDeviceSynchronize() != hipSuccess) {
     throw std::runtime_error("hipDeviceSynchronize failed");
   }
+  for (auto &entry : asyncEvents) {
+    freeAsyncEvents.push_back(entry.second);
+  }
+  asyncEvents.clear();
+}
+
+DispatchHandle ROCmContext::dispatchAsync(ComputeKernel kernel,
+                                         uint32_t grid_x, uint32_t grid_y,
+                                         uint32_t grid_z, uint32_t block_x,
+                                         uint32_t block_y, uint32_t block_z,
+                                         uint32_t count) {
+  if (!asyncSupported) {
+    return IComputeContext::dispatchAsync(kernel, grid_x, grid_y, grid_z,
+                                          block_x, block_y, block_z, count);
+  }
+  if (count == 0)
+    return 0;
+  dispatchBatch(kernel, grid_x, grid_y, grid_z, block_x, block_y, block_z,
+                count);
+
+  hipEvent_t event = nullptr;
+  if (!freeAsyncEvents.empty()) {
+    event = freeAsyncEvents.back();
+    freeAsyncEvents.pop_back();
+  } else if (f_hipEventCreate(&event) != hipSuccess) {
+    throw std::runtime_error("hipEventCreate failed");
+  }
+  f_hipEventRecord(event, nullptr);
+  DispatchHandle handle = ++lastAsyncHandle;
+  asyncEvents[handle] = event;
+  return handle;
+}
+
+void ROCmContext::wait(DispatchHandle handle) {
+  auto it = asyncEvents.find(handle);
+  if (it == asyncEvents.end())
+    return; // Already completed (or retired by waitIdle)
+  hipError_t err = f_hipEventSynchronize(it->second);
+  freeAsyncEvents.push_back(it->second);
+  asyncEvents.erase(it);
+  if (err != hipSuccess) {
+    throw std::runtime_error("hipEventSynchronize failed");
+  }
+}
+
+bool ROCmContext::poll(DispatchHandle handle) {
+  auto it = asyncEvents.find(handle);
+  if (it == asyncEvents.end())
+    return true;
+  hipError_t err = f_hipEventQuery(it->second);
+  if (err == hipErrorNotReady)
+    return false;
+  freeAsyncEvents.push_back(it->second);
+  asyncEvents.erase(it);
+  if (err != hipSuccess) {
+    throw std::runtime_error("hipEventQuery failed");
+  }
+  return true;
+}
+
+void ROCmContext::beginTiming() {
+  if (!eventsSupported) {
+    IComputeContext::beginTiming();
+    return;
+  }
+  timingEventsUsed = 0;
+  timingActive = true;
+}
+
+void ROCmContext::endTiming() {
+  if (!eventsSupported) {
+    IComputeContext::endTiming();
+    return;
+  }
+  timingActive = false;
+}
+
+double ROCmContext::getTimingResult() {
+  if (!eventsSupported) {
+    return IComputeContext::getTimingResult();
+  }
+  if (timingEventsUsed == 0) {
+    return 0.0;
+  }
+  // Launches are in-order on the null stream, so the last stop event
+  // completing implies all earlier ones have
+  f_hipEventSynchronize(timingEvents[timingEventsUsed - 1].second);
+  double total_ms = 0.0;
+  for (size_t i = 0; i < timingEventsUsed; ++i) {
+    float ms = 0.0f;
+    if (f_hipEventElapsedTime(&ms, timingEvents[i].first,
+                              timingEvents[i].second) == hipSuccess) {
+      total_ms += ms;
+    }
+  }
+  timingEventsUsed = 0;
+  return total_ms;
 }
 
 void ROCmContext::setExpectedKernelCount(uint32_t count) {
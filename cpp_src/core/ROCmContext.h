@@ -2,6 +2,7 @@
 
 #include "IComputeContext.h"
 #include "utils/DynamicLibrary.h"
+#include "utils/ShaderCache.h"
 #include <hip/hip_runtime.h>
 #include <hip/hip_runtime_api.h>
 #include <map>
@@ -20,7 +21,8 @@ public:
   bool isAvailable() const override { return available; }
   const std::vector<DeviceInfo> &getDevices() const override { return devices; }
   void pickDevice(uint32_t index) override;
-  DeviceInfo getCurrentDeviceInfo() const override;
+  void bindToCurrentThread() override;
+  const DeviceInfo &getCurrentDeviceInfo() const override;
   uint32_t getSelectedDeviceIndex() const override {
     return static_cast<uint32_t>(selectedDeviceIndex);
   }
@@ -33,11 +35,21 @@ public:
   void readBuffer(ComputeBuffer buffer, size_t offset, size_t size,
                   void *host_ptr) const override;
   void releaseBuffer(ComputeBuffer buffer) override;
+  void fillBuffer(ComputeBuffer buffer, size_t offset, size_t size,
+                  uint32_t pattern) override;
+  void copyBuffer(ComputeBuffer src, ComputeBuffer dst, size_t src_offset,
+                  size_t dst_offset, size_t size) override;
+  // Host-visible buffers are mapped pinned memory from hipHostMalloc; the
+  // handle is their device pointer. BUFFER_REBAR needs an integrated GPU.
+  bool supportsBufferFlags(BufferFlags flags) const override;
+  ComputeBuffer createBuffer(size_t size, BufferFlags flags) override;
+  void *map(ComputeBuffer buffer) override;
 
   // Kernel management
   ComputeKernel createKernel(const std::string &file_name,
                              const std::string &kernel_name,
                              uint32_t num_args) override;
+  void precompileKernel(const KernelSource &source) override;
   void setKernelArg(ComputeKernel kernel, uint32_t arg_index,
                     ComputeBuffer buffer) override;
   void setKernelAS(ComputeKernel kernel, uint32_t arg_index,
@@ -49,12 +61,29 @@ public:
   void dispatch(ComputeKernel kernel, uint32_t grid_x, uint32_t grid_y,
                 uint32_t grid_z, uint32_t block_x, uint32_t block_y,
                 uint32_t block_z) override;
+  void dispatchBatch(ComputeKernel kernel, uint32_t grid_x, uint32_t grid_y,
+                     uint32_t grid_z, uint32_t block_x, uint32_t block_y,
+                     uint32_t block_z, uint32_t count) override;
+  // Async dispatch: a hipEvent recorded after the batch backs each handle
+  DispatchHandle dispatchAsync(ComputeKernel kernel, uint32_t grid_x,
+                               uint32_t grid_y, uint32_t grid_z,
+                               uint32_t block_x, uint32_t block_y,
+                               uint32_t block_z, uint32_t count = 1) override;
+  void wait(DispatchHandle handle) override;
+  bool poll(DispatchHandle handle) override;
+  bool hasAsyncDispatch() const override { return asyncSupported; }
   void releaseKernel(ComputeKernel kernel) override;
   void setExpectedKernelCount(uint32_t count) override;
   void notifyKernelCreated(const std::string &kernel_name) override;
   void setVerbose(bool v) override { verbose = v; }
   void waitIdle() override;
 
+  // Device timing via a hipEvent pair recorded around each launch
+  bool hasDeviceTimer() const override { return eventsSupported; }
+  void beginTiming() override;
+  void endTiming() override;
+  double getTimingResult() override;
+
   hipDevice_t getROCmDevice() const override { return device; }
 
 private:
@@ -68,6 +97,10 @@ private:
   static bool librariesLoaded;
   static bool loadLibraries();
   void enumerateDevices();
+  // hiprtc compile of a .hip source through the ShaderCache; a hit leaves
+  // `code` empty and points cached_code into the archive
+  void compileHip(const std::string &file_name, std::vector<char> &code,
+                  utils::ShaderCache::Blob &cached_code) const;
 
   std::vector<DeviceInfo> devices;
   hipDevice_t device;
@@ -78,6 +111,17 @@ private:
   bool verbose = false;
   bool available = false;
 
+  bool eventsSupported = false;
+  bool timingActive = false;
+  std::vector<std::pair<hipEvent_t, hipEvent_t>> timingEvents;
+  size_t timingEventsUsed = 0;
+  bool asyncSupported = false;
+  std::map<DispatchHandle, hipEvent_t> asyncEvents;
+  // Device pointer -> host pointer of hipHostMalloc'ed buffers
+  std::map<ComputeBuffer, void *> hostBuffers;
+  std::vector<hipEvent_t> freeAsyncEvents;
+  DispatchHandle lastAsyncHandle = 0;
+
   uint32_t expectedKernelCount = 0;
   uint32_t createdKernelCount = 0;
   void printProgressBar(uint32_t current, uint32_t total,
@@ -38,6 +38,7 @@ ResultFormatter::ResultFormatter() {}
 ResultFormatter::~ResultFormatter() {}
 
 void ResultFormatter::addResult(const ResultData &result) {
+  std::lock_guard<std::mutex> lock(resultsMutex);
   results.push_back(result);
 }
 
@@ -229,6 +230,12 @@ void ResultFormatter::print() {
               std::cout << " : " << std::setw(12) << std::right << YELLOW
                         << backend << RESET << " | " << BOLD << GREEN
                         << std::setw(10) << valStr << RESET << unit;
+              if (res.sampleCount > 1 && res.mean_ms > 0.0) {
+                // Coefficient of variation of the per-iteration times
+                std::cout << "  \u00b1"
+                          << formatDouble(100.0 * res.stddev_ms / res.mean_ms, 1)
+                          << "% (n=" << res.sampleCount << ")";
+              }
               firstBackend = false;
             }
           }
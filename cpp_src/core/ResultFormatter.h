@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstdint>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -12,12 +13,33 @@ struct ResultData {
   std::string subcategory; // e.g., "Bandwidth", "Latency", "FP32"
   std::string metric;
   uint64_t operations;
-  double time_ms;
+  double time_ms; // device_time_ms if deviceTimed, host_time_ms otherwise
   bool isEmulated;
   uint32_t maxWorkGroupSize;
   uint32_t deviceIndex;
   uint32_t configIndex;
   int sortWeight;
+
+  // Per-iteration timing spread (ms); sampleCount == 0 if not sampled
+  uint32_t sampleCount = 0;
+  double median_ms = 0.0;
+  double mean_ms = 0.0;
+  double stddev_ms = 0.0;
+  double min_ms = 0.0;
+  double p95_ms = 0.0;
+  double p99_ms = 0.0;
+
+  // Untimed warm-up phase preceding the samples
+  uint32_t warmupIterations = 0;
+  double warmup_ms = 0.0;
+
+  // Host wall time (incl. submit/sync overhead) vs. device-measured time
+  double host_time_ms = 0.0;
+  double device_time_ms = 0.0;
+  bool deviceTimed = false;
+
+  // Dispatches per submission; all timings above are per dispatch
+  uint32_t batchSize = 1;
 };
 
 class ResultFormatter {
@@ -33,4 +55,5 @@ private:
   std::string formatNumber(uint64_t n);
   std::string formatDouble(double value, int precision);
   std::vector<ResultData> results;
+  std::mutex resultsMutex;
 };
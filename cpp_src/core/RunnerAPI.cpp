@@ -28,6 +28,10 @@ std::vector<ResultData> RunBenchmarksAPI(
                 contexts.push_back(ComputeBackendFactory::create(ComputeBackend::OpenCL, verbose, debug));
             } else if (backend_str == "rocm" && ComputeBackendFactory::isAvailable(ComputeBackend::ROCm)) {
                 contexts.push_back(ComputeBackendFactory::create(ComputeBackend::ROCm, verbose, debug));
+            } else if (backend_str == "host") {
+                contexts.push_back(ComputeBackendFactory::create(ComputeBackend::Host, verbose, debug));
+            } else if (backend_str == "simulated") {
+                contexts.push_back(ComputeBackendFactory::create(ComputeBackend::Simulated, verbose, debug));
             }
         }
     }
@@ -103,6 +107,10 @@ std::vector<std::string> GetAvailableHardwareAPI() {
             }
         }
     }
+    {
+        auto ctx = ComputeBackendFactory::create(ComputeBackend::Host, false, false);
+        results.push_back("host|0|" + ctx->getDevices()[0].name);
+    }
     return results;
 }
 
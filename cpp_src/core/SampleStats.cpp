@@ -0,0 +1,120 @@
+#include "core/SampleStats.h"
+#include <algorithm>
+#include <cmath>
+
+// Two-sided 95% Student's t critical values for 1..30 degrees of freedom.
+static const double kT95[] = {12.706, 4.303, 3.182, 2.776, 2.571, 2.447,
+                              2.365,  2.306, 2.262, 2.228, 2.201, 2.179,
+                              2.160,  2.145, 2.131, 2.120, 2.110, 2.101,
+                              2.093,  2.086, 2.080, 2.074, 2.069, 2.064,
+                              2.060,  2.056, 2.052, 2.048, 2.045, 2.042};
+
+static double t95(size_t dof) {
+  if (dof == 0)
+    return 0.0;
+  if (dof <= sizeof(kT95) / sizeof(kT95[0]))
+    return kT95[dof - 1];
+  return 1.960;
+}
+
+// Linear interpolation between closest ranks on a sorted vector
+static double percentile(const std::vector<double> &sorted, double p) {
+  if (sorted.empty())
+    return 0.0;
+  double rank = p * (sorted.size() - 1);
+  size_t lo = static_cast<size_t>(std::floor(rank));
+  size_t hi = std::min(lo + 1, sorted.size() - 1);
+  double frac = rank - lo;
+  return sorted[lo] + (sorted[hi] - sorted[lo]) * frac;
+}
+
+WarmupDetector::WarmupDetector(const SamplingPolicy &policy)
+    : policy(policy) {
+  window.reserve(policy.warmupWindow);
+}
+
+void WarmupDetector::add(double iter_ms) {
+  if (policy.warmupWindow > 0 && window.size() == policy.warmupWindow)
+    window.erase(window.begin());
+  window.push_back(iter_ms);
+  iters++;
+  elapsed += iter_ms;
+}
+
+bool WarmupDetector::isWarm() const {
+  // The very first iteration is always discarded
+  if (iters == 0)
+    return false;
+  if (elapsed >= policy.warmupMaxMs)
+    return true;
+  if (window.size() < policy.warmupWindow || window.size() < 2)
+    return false;
+
+  double n = static_cast<double>(window.size());
+  double sumX = 0, sumY = 0, sumXY = 0, sumXX = 0;
+  for (size_t i = 0; i < window.size(); ++i) {
+    sumX += i;
+    sumY += window[i];
+    sumXY += i * window[i];
+    sumXX += static_cast<double>(i) * i;
+  }
+  double mean = sumY / n;
+  if (mean <= 0.0)
+    return true;
+  double slope = (n * sumXY - sumX * sumY) / (n * sumXX - sumX * sumX);
+  // Relative improvement across the whole window
+  double drop = -slope * (n - 1) / mean;
+  return drop <= policy.warmupSlopeTol;
+}
+
+SampleCollector::SampleCollector(const SamplingPolicy &policy)
+    : policy(policy) {
+  samples.reserve(256);
+}
+
+void SampleCollector::add(double iter_ms) {
+  samples.push_back(iter_ms);
+  double delta = iter_ms - runningMean;
+  runningMean += delta / samples.size();
+  runningM2 += delta * (iter_ms - runningMean);
+}
+
+double SampleCollector::relativeCI() const {
+  size_t n = samples.size();
+  if (n < 2 || runningMean <= 0.0)
+    return INFINITY;
+  double stddev = std::sqrt(runningM2 / (n - 1));
+  return t95(n - 1) * stddev / std::sqrt(static_cast<double>(n)) /
+         runningMean;
+}
+
+bool SampleCollector::shouldStop(double elapsed_ms) const {
+  if (elapsed_ms >= policy.maxTimeMs || count() >= policy.maxSamples)
+    return true;
+  if (count() < policy.minSamples || elapsed_ms < policy.minTimeMs)
+    return false;
+  return relativeCI() <= policy.targetRelCI;
+}
+
+SampleStats SampleCollector::finalize() const {
+  SampleStats stats;
+  stats.count = count();
+  if (samples.empty())
+    return stats;
+
+  std::vector<double> sorted(samples);
+  std::sort(sorted.begin(), sorted.end());
+
+  for (double s : sorted)
+    stats.total += s;
+  stats.mean = runningMean;
+  stats.stddev =
+      sorted.size() > 1 ? std::sqrt(runningM2 / (sorted.size() - 1)) : 0.0;
+  stats.min = sorted.front();
+  stats.max = sorted.back();
+  stats.median = percentile(sorted, 0.50);
+  stats.p95 = percentile(sorted, 0.95);
+  stats.p99 = percentile(sorted, 0.99);
+  stats.relCI = sorted.size() > 1 ? relativeCI() : 0.0;
+  return stats;
+}
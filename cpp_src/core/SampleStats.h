@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Controls how long a single benchmark config is sampled. Sampling stops as
+// soon as the 95% confidence interval of the mean iteration time is within
+// targetRelCI of the mean (after minSamples and minTimeMs are satisfied), or
+// when maxTimeMs / maxSamples is reached, whichever comes first.
+struct SamplingPolicy {
+  uint32_t minSamples = 10;
+  uint32_t maxSamples = 100000;
+  double minTimeMs = 100.0;
+  double maxTimeMs = 2500.0;
+  double targetRelCI = 0.01; // 1% of the mean
+
+  // Warm-up runs until the last warmupWindow iterations no longer trend
+  // downwards by more than warmupSlopeTol of their mean, or warmupMaxMs.
+  uint32_t warmupWindow = 5;
+  double warmupSlopeTol = 0.02;
+  double warmupMaxMs = 1000.0;
+};
+
+// Summary of per-iteration durations (all values in milliseconds).
+struct SampleStats {
+  uint32_t count = 0;
+  double total = 0.0;
+  double mean = 0.0;
+  double median = 0.0;
+  double stddev = 0.0;
+  double min = 0.0;
+  double max = 0.0;
+  double p95 = 0.0;
+  double p99 = 0.0;
+  double relCI = 0.0; // 95% CI half-width relative to the mean
+};
+
+// Decides when the device has left its cold state (pipeline first use, page
+// faults, clock ramp-up). Fits a least-squares line through a rolling window
+// of iteration times and reports warm once it is flat or rising.
+class WarmupDetector {
+public:
+  explicit WarmupDetector(const SamplingPolicy &policy);
+
+  void add(double iter_ms);
+  bool isWarm() const;
+
+  uint32_t iterations() const { return iters; }
+  double elapsedMs() const { return elapsed; }
+
+private:
+  SamplingPolicy policy;
+  std::vector<double> window;
+  uint32_t iters = 0;
+  double elapsed = 0.0;
+};
+
+// Collects iteration durations and decides when enough samples have been
+// taken. The running mean/variance is updated incrementally (Welford) so the
+// convergence check stays O(1) per iteration.
+class SampleCollector {
+public:
+  explicit SampleCollector(const SamplingPolicy &policy);
+
+  void add(double iter_ms);
+  bool shouldStop(double elapsed_ms) const;
+
+  uint32_t count() const { return static_cast<uint32_t>(samples.size()); }
+  double relativeCI() const;
+  SampleStats finalize() const;
+
+private:
+  SamplingPolicy policy;
+  std::vector<double> samples;
+  double runningMean = 0.0;
+  double runningM2 = 0.0;
+};
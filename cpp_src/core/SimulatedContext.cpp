@@ -0,0 +1,304 @@
+#include "SimulatedContext.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+
+std::mutex SimulatedContext::costsMutex;
+
+std::unordered_map<std::string, SimulatedKernelCost> &
+SimulatedContext::costs() {
+  // Per invocation, as counted by the benchmarks' GetResult() on backends
+  // other than ROCm and Host
+  static std::unordered_map<std::string, SimulatedKernelCost> table = {
+      {"fp32", {16384.0 * 256, 0, 0, 0}},
+      {"fp64", {0, 65536.0 * 2, 0, 0}},
+      {"membw_128", {0, 0, 512.0 * 32, 0}},
+      {"membw_256", {0, 0, 512.0 * 32, 0}},
+      {"membw_1024", {0, 0, 512.0 * 32, 0}},
+      {"cache_latency", {0, 0, 0, 1e6}},
+  };
+  return table;
+}
+
+void SimulatedContext::setKernelCost(const std::string &name,
+                                     const SimulatedKernelCost &cost) {
+  std::lock_guard<std::mutex> lock(costsMutex);
+  costs()[name] = cost;
+}
+
+std::vector<SimulatedDevice> SimulatedContext::defaultDevices() {
+  SimulatedDevice discrete;
+  DeviceInfo &d = discrete.info;
+  d.name = "Simulated Discrete GPU";
+  d.archName = "sim";
+  d.driverUUID = "simulated";
+  d.memorySize = 16ULL << 30;
+  d.maxWorkGroupSize = 1024;
+  d.maxComputeWorkGroupCountX = 65535;
+  d.maxComputeWorkGroupCountY = 65535;
+  d.maxComputeWorkGroupCountZ = 65535;
+  d.maxComputeSharedMemorySize = 64 * 1024;
+  d.subgroupSize = 32;
+  d.l1CacheSize = 32 * 1024;
+  d.l2CacheSize = 4 * 1024 * 1024;
+  d.l3CacheSize = 64 * 1024 * 1024;
+  d.fp64Support = true;
+  discrete.fp32FlopsPerSecond = 40e12;
+  discrete.fp64FlopsPerSecond = 1.25e12;
+  discrete.bytesPerSecond = 1e12;
+  discrete.loadLatencyNs = 500.0;
+  discrete.seed = 1;
+
+  SimulatedDevice integrated;
+  DeviceInfo &i = integrated.info;
+  i = d;
+  i.name = "Simulated Integrated GPU";
+  i.memorySize = 4ULL << 30;
+  i.maxWorkGroupSize = 256;
+  i.l3CacheSize = 0;
+  i.unifiedMemory = true;
+  integrated.fp32FlopsPerSecond = 8e12;
+  integrated.fp64FlopsPerSecond = 0.25e12;
+  integrated.bytesPerSecond = 120e9;
+  integrated.loadLatencyNs = 700.0;
+  integrated.jitter = 0.03;
+  integrated.throttleDepth = 0.3;
+  integrated.heatTimeConstantMs = 5000.0;
+  integrated.seed = 2;
+
+  return {discrete, integrated};
+}
+
+SimulatedContext::SimulatedContext(std::vector<SimulatedDevice> devices,
+                                   bool verbose)
+    : devices(std::move(devices)), verbose(verbose) {
+  for (const auto &device : this->devices) {
+    deviceInfos.push_back(device.info);
+  }
+  if (!this->devices.empty()) {
+    rng.seed(this->devices[0].seed);
+  }
+}
+
+SimulatedContext::~SimulatedContext() = default;
+
+void SimulatedContext::pickDevice(uint32_t index) {
+  if (index >= devices.size()) {
+    throw std::runtime_error("Invalid device index for Simulated backend");
+  }
+  selectedDeviceIndex = index;
+  rng.seed(devices[index].seed);
+  heatLevel = 0.0;
+  if (verbose) {
+    std::cout << "Selected device: " << deviceInfos[index].name << std::endl;
+  }
+}
+
+void SimulatedContext::advance(double ns, bool busy) {
+  clockNs += ns;
+  double tau_ns = devices[selectedDeviceIndex].heatTimeConstantMs * 1e6;
+  double decay = tau_ns > 0.0 ? std::exp(-ns / tau_ns) : 0.0;
+  heatLevel = busy ? 1.0 - (1.0 - heatLevel) * decay : heatLevel * decay;
+}
+
+void SimulatedContext::transfer(size_t bytes) {
+  const SimulatedDevice &device = devices[selectedDeviceIndex];
+  advance(device.launchLatencyUs * 1e3 + bytes / device.bytesPerSecond * 1e9,
+          false);
+}
+
+std::chrono::steady_clock::time_point SimulatedContext::now() const {
+  return std::chrono::steady_clock::time_point(
+      std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+          std::chrono::nanoseconds(static_cast<int64_t>(clockNs))));
+}
+
+void SimulatedContext::sleepFor(std::chrono::milliseconds duration) {
+  advance(duration.count() * 1e6, false);
+}
+
+bool SimulatedContext::supportsBufferFlags(BufferFlags flags) const {
+  // Host memory is always there; device memory the host can reach only on
+  // unified-memory devices
+  if ((flags & BUFFER_DEVICE_LOCAL) && (flags & ~BUFFER_DEVICE_LOCAL))
+    return getCurrentDeviceInfo().unifiedMemory;
+  return true;
+}
+
+ComputeBuffer SimulatedContext::createBuffer(size_t size,
+                                             const void *host_ptr) {
+  ComputeBuffer handle = createBuffer(size, BUFFER_DEVICE_LOCAL);
+  if (host_ptr) {
+    writeBuffer(handle, 0, size, host_ptr);
+  }
+  return handle;
+}
+
+ComputeBuffer SimulatedContext::createBuffer(size_t size, BufferFlags flags) {
+  if (!supportsBufferFlags(flags)) {
+    throw std::runtime_error("Buffer memory flags not supported");
+  }
+  uint64_t limit = getCurrentDeviceInfo().memorySize;
+  bool device_local = (flags & BUFFER_DEVICE_LOCAL) != 0;
+  if (device_local && limit && allocatedBytes + size > limit) {
+    throw std::runtime_error("Out of simulated device memory");
+  }
+
+  auto buffer = std::make_unique<SimBuffer>();
+  buffer->size = size;
+  buffer->flags = flags;
+  if (device_local) {
+    allocatedBytes += size;
+  }
+  ComputeBuffer handle = buffer.get();
+  buffers[handle] = std::move(buffer);
+  return handle;
+}
+
+SimulatedContext::SimBuffer *
+SimulatedContext::getBuffer(ComputeBuffer buffer, size_t offset,
+                            size_t size) const {
+  auto it = buffers.find(buffer);
+  if (it == buffers.end()) {
+    throw std::runtime_error("Invalid buffer handle");
+  }
+  SimBuffer *b = it->second.get();
+  if (offset > b->size || size > b->size - offset) {
+    throw std::runtime_error("Simulated buffer access out of range");
+  }
+  return b;
+}
+
+char *SimulatedContext::materialize(SimBuffer &buffer) const {
+  if (buffer.data.size() != buffer.size) {
+    buffer.data.resize(buffer.size);
+    for (size_t i = 0; i < buffer.size; i += sizeof(uint32_t)) {
+      memcpy(buffer.data.data() + i, &buffer.fillPattern,
+             std::min(sizeof(uint32_t), buffer.size - i));
+    }
+  }
+  return buffer.data.data();
+}
+
+void SimulatedContext::writeBuffer(ComputeBuffer buffer, size_t offset,
+                                   size_t size, const void *host_ptr) {
+  SimBuffer *b = getBuffer(buffer, offset, size);
+  memcpy(materialize(*b) + offset, host_ptr, size);
+  transfer(size);
+}
+
+void SimulatedContext::readBuffer(ComputeBuffer buffer, size_t offset,
+                                  size_t size, void *host_ptr) const {
+  SimBuffer *b = getBuffer(buffer, offset, size);
+  memcpy(host_ptr, materialize(*b) + offset, size);
+  // Reads are const; their transfer time is not modeled
+}
+
+void SimulatedContext::releaseBuffer(ComputeBuffer buffer) {
+  auto it = buffers.find(buffer);
+  if (it == buffers.end())
+    return;
+  if (it->second->flags & BUFFER_DEVICE_LOCAL) {
+    allocatedBytes -= it->second->size;
+  }
+  buffers.erase(it);
+}
+
+void *SimulatedContext::map(ComputeBuffer buffer) {
+  SimBuffer *b = getBuffer(buffer, 0, 0);
+  if (!(b->flags & (BUFFER_HOST_VISIBLE | BUFFER_HOST_CACHED))) {
+    throw std::runtime_error("Buffer is not host-visible");
+  }
+  return materialize(*b);
+}
+
+void SimulatedContext::fillBuffer(ComputeBuffer buffer, size_t offset,
+                                  size_t size, uint32_t pattern) {
+  if (offset % sizeof(uint32_t) != 0 || size % sizeof(uint32_t) != 0) {
+    throw std::runtime_error(
+        "fillBuffer offset and size must be multiples of 4");
+  }
+  SimBuffer *b = getBuffer(buffer, offset, size);
+  if (b->data.empty() && offset == 0 && size == b->size) {
+    b->fillPattern = pattern;
+  } else {
+    char *data = materialize(*b) + offset;
+    for (size_t i = 0; i < size; i += sizeof(uint32_t)) {
+      memcpy(data + i, &pattern, sizeof(uint32_t));
+    }
+  }
+  transfer(size);
+}
+
+void SimulatedContext::copyBuffer(ComputeBuffer src, ComputeBuffer dst,
+                                  size_t src_offset, size_t dst_offset,
+                                  size_t size) {
+  SimBuffer *s = getBuffer(src, src_offset, size);
+  SimBuffer *d = getBuffer(dst, dst_offset, size);
+  if (s->data.empty() && d->data.empty() && src_offset == 0 &&
+      dst_offset == 0 && size == s->size && size == d->size) {
+    d->fillPattern = s->fillPattern;
+  } else {
+    memmove(materialize(*d) + dst_offset, materialize(*s) + src_offset, size);
+  }
+  transfer(2 * size);
+}
+
+ComputeKernel SimulatedContext::createKernel(const std::string &file_name,
+                                             const std::string &kernel_name,
+                                             uint32_t num_args) {
+  auto cost = std::make_unique<SimulatedKernelCost>();
+  {
+    std::lock_guard<std::mutex> lock(costsMutex);
+    auto it = costs().find(std::filesystem::path(file_name).stem().string());
+    if (it == costs().end()) {
+      throw std::runtime_error("No simulated cost for " + file_name);
+    }
+    *cost = it->second;
+  }
+  ComputeKernel handle = cost.get();
+  kernels[handle] = std::move(cost);
+  notifyKernelCreated(kernel_name);
+  return handle;
+}
+
+void SimulatedContext::dispatch(ComputeKernel kernel, uint32_t grid_x,
+                                uint32_t grid_y, uint32_t grid_z,
+                                uint32_t block_x, uint32_t block_y,
+                                uint32_t block_z) {
+  auto it = kernels.find(kernel);
+  if (it == kernels.end()) {
+    throw std::runtime_error("Invalid kernel handle");
+  }
+  const SimulatedKernelCost &cost = *it->second;
+  const SimulatedDevice &device = devices[selectedDeviceIndex];
+  double invocations = double(grid_x) * grid_y * grid_z * block_x * block_y *
+                       block_z;
+
+  double clock = 1.0 - device.throttleDepth * heatLevel;
+  double compute_s = invocations * (cost.fp32Flops / device.fp32FlopsPerSecond +
+                                    cost.fp64Flops / device.fp64FlopsPerSecond) /
+                     clock;
+  double memory_s = invocations * cost.bytes / device.bytesPerSecond;
+  double ns = device.launchLatencyUs * 1e3 +
+              std::max(compute_s, memory_s) * 1e9 +
+              invocations * cost.dependentLoads * device.loadLatencyNs;
+
+  // Uniform in [-1, 1), from the raw engine output so every standard
+  // library produces the same sequence
+  double u = (rng() >> 11) * 0x1.0p-53 * 2.0 - 1.0;
+  ns *= 1.0 + device.jitter * u;
+
+  advance(ns, true);
+  timedNs += ns;
+}
+
+void SimulatedContext::releaseKernel(ComputeKernel kernel) {
+  kernels.erase(kernel);
+}
+
+void SimulatedContext::beginTiming() { timedNs = 0.0; }
+
+double SimulatedContext::getTimingResult() { return timedNs / 1e6; }
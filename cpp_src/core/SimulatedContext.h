@@ -0,0 +1,166 @@
+#pragma once
+
+#include "IComputeContext.h"
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Performance model of one simulated device. A dispatch takes
+//   launchLatencyUs + max(compute, memory) + dependentLoads * loadLatencyNs
+// scaled by a uniform jitter of +-jitter, where compute runs at the FLOP
+// rates derated by the thermal state. Heat approaches 1 while busy and 0
+// while idle, both with time constant heatTimeConstantMs; at heat h clocks
+// run at 1 - throttleDepth * h.
+struct SimulatedDevice {
+  DeviceInfo info;
+  double fp32FlopsPerSecond = 20e12;
+  double fp64FlopsPerSecond = 1.25e12;
+  double bytesPerSecond = 500e9;
+  double loadLatencyNs = 400.0;
+  double launchLatencyUs = 5.0;
+  double jitter = 0.01;
+  double throttleDepth = 0.0;
+  double heatTimeConstantMs = 10000.0;
+  uint64_t seed = 1;
+};
+
+// Work of one kernel invocation. createKernel() rejects kernels without a
+// registered cost rather than timing them as free; a zero cost registered
+// with setKernelCost() takes only the launch latency.
+struct SimulatedKernelCost {
+  double fp32Flops = 0.0;
+  double fp64Flops = 0.0;
+  double bytes = 0.0;
+  double dependentLoads = 0.0;
+};
+
+// Backend presenting fake devices whose dispatches advance a virtual clock
+// by the time the SimulatedDevice model predicts, without running anything.
+// now(), sleepFor() and the device timer all follow that clock, so a
+// BenchmarkRunner run over simulated devices is deterministic and finishes
+// in milliseconds. Each context has its own clock, starting at the epoch.
+//
+// Buffers take no memory until their contents are needed (writeBuffer,
+// readBuffer, map); fills of untouched buffers are only recorded. Their
+// sizes still count against DeviceInfo::memorySize, so out-of-memory paths
+// can be exercised. Kernel costs are looked up by file stem, like
+// HostContext kernels; the built-in ones match what the benchmarks'
+// GetResult() counts for fp32, fp64, membw_* and cache_latency, so those
+// report the configured rates.
+class SimulatedContext : public IComputeContext {
+public:
+  SimulatedContext(std::vector<SimulatedDevice> devices =
+                       defaultDevices(),
+                   bool verbose = false);
+  ~SimulatedContext() override;
+
+  // Two devices: a fast discrete GPU and a slow integrated one that
+  // throttles under load
+  static std::vector<SimulatedDevice> defaultDevices();
+
+  ComputeBackend getBackend() const override {
+    return ComputeBackend::Simulated;
+  }
+  bool isAvailable() const override { return !devices.empty(); }
+  const std::vector<DeviceInfo> &getDevices() const override {
+    return deviceInfos;
+  }
+  void pickDevice(uint32_t index) override;
+  const DeviceInfo &getCurrentDeviceInfo() const override {
+    return deviceInfos[selectedDeviceIndex];
+  }
+  uint32_t getSelectedDeviceIndex() const override {
+    return selectedDeviceIndex;
+  }
+  void setVerbose(bool v) override { verbose = v; }
+
+  // Buffer management
+  ComputeBuffer createBuffer(size_t size,
+                             const void *host_ptr = nullptr) override;
+  void writeBuffer(ComputeBuffer buffer, size_t offset, size_t size,
+                   const void *host_ptr) override;
+  void readBuffer(ComputeBuffer buffer, size_t offset, size_t size,
+                  void *host_ptr) const override;
+  void releaseBuffer(ComputeBuffer buffer) override;
+  bool supportsBufferFlags(BufferFlags flags) const override;
+  ComputeBuffer createBuffer(size_t size, BufferFlags flags) override;
+  void *map(ComputeBuffer buffer) override;
+  void fillBuffer(ComputeBuffer buffer, size_t offset, size_t size,
+                  uint32_t pattern) override;
+  void copyBuffer(ComputeBuffer src, ComputeBuffer dst, size_t src_offset,
+                  size_t dst_offset, size_t size) override;
+
+  // Kernel management
+  ComputeKernel createKernel(const std::string &file_name,
+                             const std::string &kernel_name,
+                             uint32_t num_args) override;
+  void setKernelArg(ComputeKernel kernel, uint32_t arg_index,
+                    ComputeBuffer buffer) override {}
+  void setKernelAS(ComputeKernel kernel, uint32_t arg_index,
+                   AccelerationStructure as) override {
+    throw std::runtime_error("setKernelAS not supported on Simulated backend");
+  }
+  void setKernelArg(ComputeKernel kernel, uint32_t arg_index, size_t arg_size,
+                    const void *arg_value) override {}
+  void dispatch(ComputeKernel kernel, uint32_t grid_x, uint32_t grid_y,
+                uint32_t grid_z, uint32_t block_x, uint32_t block_y,
+                uint32_t block_z) override;
+  void releaseKernel(ComputeKernel kernel) override;
+  void waitIdle() override {}
+
+  // Device timer: the modeled time of the dispatches between the markers
+  bool hasDeviceTimer() const override { return true; }
+  void beginTiming() override;
+  void endTiming() override {}
+  double getTimingResult() override;
+
+  std::chrono::steady_clock::time_point now() const override;
+  void sleepFor(std::chrono::milliseconds duration) override;
+
+  // Thermal state of the selected device, 0 (cold) to 1
+  double heat() const { return heatLevel; }
+
+  // Adds or replaces the cost createKernel() resolves `name` (a file stem)
+  // to, for every SimulatedContext
+  static void setKernelCost(const std::string &name,
+                            const SimulatedKernelCost &cost);
+
+private:
+  struct SimBuffer {
+    size_t size;
+    BufferFlags flags;
+    std::vector<char> data; // Empty until materialized
+    uint32_t fillPattern = 0;
+  };
+
+  static std::unordered_map<std::string, SimulatedKernelCost> &costs();
+  static std::mutex costsMutex;
+
+  SimBuffer *getBuffer(ComputeBuffer buffer, size_t offset,
+                       size_t size) const;
+  char *materialize(SimBuffer &buffer) const;
+  // Advances the clock by `ns` of device work (busy) or idle time
+  void advance(double ns, bool busy);
+  void transfer(size_t bytes);
+
+  std::vector<SimulatedDevice> devices;
+  std::vector<DeviceInfo> deviceInfos;
+  uint32_t selectedDeviceIndex = 0;
+  bool verbose = false;
+
+  std::unordered_map<ComputeBuffer, std::unique_ptr<SimBuffer>> buffers;
+  std::unordered_map<ComputeKernel, std::unique_ptr<SimulatedKernelCost>>
+      kernels;
+  uint64_t allocatedBytes = 0;
+
+  double clockNs = 0.0;
+  double heatLevel = 0.0;
+  double timedNs = 0.0;
+  std::mt19937_64 rng;
+};
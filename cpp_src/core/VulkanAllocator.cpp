@@ -0,0 +1,346 @@
+#include "VulkanAllocator.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <stdexcept>
+
+VulkanAllocator::VulkanAllocator(VkDevice device,
+                                 VkPhysicalDevice physical_device,
+                                 bool device_address, VkDeviceSize block_size)
+    : device(device), deviceAddress(device_address) {
+  vkGetPhysicalDeviceMemoryProperties(physical_device, &memProperties);
+  VkPhysicalDeviceProperties properties;
+  vkGetPhysicalDeviceProperties(physical_device, &properties);
+  maxAllocationCount = properties.limits.maxMemoryAllocationCount;
+  nonCoherentAtomSize =
+      std::max<VkDeviceSize>(properties.limits.nonCoherentAtomSize, 1);
+
+  // Largest power of two range that fits in block_size
+  blockSize = kMinRangeSize;
+  maxOrder = 0;
+  while (blockSize * 2 <= block_size) {
+    blockSize *= 2;
+    maxOrder++;
+  }
+}
+
+VulkanAllocator::~VulkanAllocator() {
+  for (auto &block : blocks) {
+    if (block.memory != VK_NULL_HANDLE)
+      vkFreeMemory(device, block.memory, nullptr);
+  }
+}
+
+uint32_t VulkanAllocator::findMemoryType(uint32_t type_bits,
+                                         VkMemoryPropertyFlags properties,
+                                         VkMemoryPropertyFlags avoid) const {
+  // Second pass accepts avoided flags (on APUs every type is device-local)
+  for (int pass = 0; pass < 2; ++pass) {
+    for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++) {
+      VkMemoryPropertyFlags flags = memProperties.memoryTypes[i].propertyFlags;
+      if ((type_bits & (1 << i)) && (flags & properties) == properties &&
+          (pass == 1 || (flags & avoid) == 0)) {
+        return i;
+      }
+    }
+  }
+  throw std::runtime_error("failed to find suitable memory type!");
+}
+
+bool VulkanAllocator::hasMemoryType(VkMemoryPropertyFlags properties) const {
+  for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++) {
+    if ((memProperties.memoryTypes[i].propertyFlags & properties) ==
+        properties)
+      return true;
+  }
+  return false;
+}
+
+VkDeviceMemory VulkanAllocator::allocateMemory(VkDeviceSize size,
+                                               uint32_t memory_type) {
+  VkMemoryAllocateInfo allocInfo{};
+  allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+  allocInfo.allocationSize = size;
+  allocInfo.memoryTypeIndex = memory_type;
+
+  VkMemoryAllocateFlagsInfo flagsInfo{};
+  if (deviceAddress) {
+    flagsInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_FLAGS_INFO;
+    flagsInfo.flags = VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT;
+    allocInfo.pNext = &flagsInfo;
+  }
+
+  VkDeviceMemory memory = VK_NULL_HANDLE;
+  if (vkAllocateMemory(device, &allocInfo, nullptr, &memory) != VK_SUCCESS)
+    return VK_NULL_HANDLE;
+  return memory;
+}
+
+int32_t VulkanAllocator::createBlock(uint32_t memory_type) {
+  VkDeviceMemory memory = allocateMemory(blockSize, memory_type);
+  if (memory == VK_NULL_HANDLE)
+    return -1;
+
+  // Reuse a released slot so allocation indices stay valid
+  size_t index = blocks.size();
+  for (size_t i = 0; i < blocks.size(); ++i) {
+    if (blocks[i].memory == VK_NULL_HANDLE) {
+      index = i;
+      break;
+    }
+  }
+  if (index == blocks.size())
+    blocks.emplace_back();
+
+  Block &block = blocks[index];
+  block.memory = memory;
+  block.memoryType = memory_type;
+  block.reserved = 0;
+  block.mapped = nullptr;
+  block.freeLists.assign(maxOrder + 1, {});
+  block.freeLists[maxOrder].insert(0);
+  return static_cast<int32_t>(index);
+}
+
+bool VulkanAllocator::allocateRange(Block &block, uint32_t order,
+                                    VkDeviceSize &offset) {
+  uint32_t k = order;
+  while (k <= maxOrder && block.freeLists[k].empty())
+    k++;
+  if (k > maxOrder)
+    return false;
+
+  offset = *block.freeLists[k].begin();
+  block.freeLists[k].erase(block.freeLists[k].begin());
+  // Split down to the requested order, keeping the low half each time
+  while (k > order) {
+    k--;
+    block.freeLists[k].insert(offset + (kMinRangeSize << k));
+  }
+  block.reserved += kMinRangeSize << order;
+  return true;
+}
+
+VulkanAllocation VulkanAllocator::allocateDedicated(VkDeviceSize size,
+                                                    uint32_t memory_type) {
+  VulkanAllocation allocation;
+  allocation.memory = allocateMemory(size, memory_type);
+  if (allocation.memory == VK_NULL_HANDLE)
+    throw std::runtime_error("failed to allocate buffer memory!");
+  allocation.size = size;
+  allocation.memoryType = memory_type;
+  dedicatedCount++;
+  dedicatedBytes += size;
+  return allocation;
+}
+
+VulkanAllocation
+VulkanAllocator::allocate(const VkMemoryRequirements &requirements,
+                          VkMemoryPropertyFlags properties,
+                          VkMemoryPropertyFlags avoid) {
+  auto start = std::chrono::high_resolution_clock::now();
+  uint32_t memoryType =
+      findMemoryType(requirements.memoryTypeBits, properties, avoid);
+
+  VkDeviceSize need = std::max(requirements.size, requirements.alignment);
+  VkDeviceSize rangeSize = kMinRangeSize;
+  uint32_t order = 0;
+  while (rangeSize < need) {
+    rangeSize *= 2;
+    order++;
+  }
+
+  VulkanAllocation allocation;
+  if (rangeSize > blockSize / 4) {
+    allocation = allocateDedicated(requirements.size, memoryType);
+  } else {
+    int32_t index = -1;
+    VkDeviceSize offset = 0;
+    for (size_t i = 0; i < blocks.size() && index < 0; ++i) {
+      if (blocks[i].memory != VK_NULL_HANDLE &&
+          blocks[i].memoryType == memoryType &&
+          allocateRange(blocks[i], order, offset)) {
+        index = static_cast<int32_t>(i);
+      }
+    }
+    if (index < 0) {
+      index = createBlock(memoryType);
+      if (index >= 0)
+        allocateRange(blocks[index], order, offset);
+    }
+
+    if (index >= 0) {
+      allocation.memory = blocks[index].memory;
+      allocation.offset = offset;
+      allocation.size = rangeSize;
+      allocation.memoryType = memoryType;
+      allocation.block = index;
+    } else {
+      // No room for another block (small heap): try an exact-size allocation
+      allocation = allocateDedicated(requirements.size, memoryType);
+    }
+  }
+  allocation.requested = requirements.size;
+  liveAllocations++;
+  requestedBytes += requirements.size;
+
+  double ms = std::chrono::duration<double, std::milli>(
+                  std::chrono::high_resolution_clock::now() - start)
+                  .count();
+  allocateCalls++;
+  totalAllocateMs += ms;
+  maxAllocateMs = std::max(maxAllocateMs, ms);
+  return allocation;
+}
+
+void VulkanAllocator::free(const VulkanAllocation &allocation) {
+  if (allocation.memory == VK_NULL_HANDLE)
+    return;
+  liveAllocations--;
+  requestedBytes -= allocation.requested;
+
+  if (allocation.block < 0) {
+    dedicatedMapped.erase(allocation.memory);
+    vkFreeMemory(device, allocation.memory, nullptr);
+    dedicatedCount--;
+    dedicatedBytes -= allocation.size;
+    return;
+  }
+
+  Block &block = blocks[allocation.block];
+  uint32_t order = 0;
+  while ((kMinRangeSize << order) < allocation.size)
+    order++;
+  block.reserved -= allocation.size;
+
+  // Merge with free buddies as far up as possible
+  VkDeviceSize offset = allocation.offset;
+  while (order < maxOrder) {
+    VkDeviceSize buddy = offset ^ (kMinRangeSize << order);
+    auto it = block.freeLists[order].find(buddy);
+    if (it == block.freeLists[order].end())
+      break;
+    block.freeLists[order].erase(it);
+    offset = std::min(offset, buddy);
+    order++;
+  }
+  block.freeLists[order].insert(offset);
+
+  // Keep one empty block per memory type around for the next Setup()
+  if (block.reserved == 0) {
+    for (size_t i = 0; i < blocks.size(); ++i) {
+      if (static_cast<int32_t>(i) != allocation.block &&
+          blocks[i].memory != VK_NULL_HANDLE &&
+          blocks[i].memoryType == block.memoryType &&
+          blocks[i].reserved == 0) {
+        vkFreeMemory(device, block.memory, nullptr);
+        block.memory = VK_NULL_HANDLE;
+        block.mapped = nullptr;
+        block.freeLists.clear();
+        break;
+      }
+    }
+  }
+}
+
+void *VulkanAllocator::map(const VulkanAllocation &allocation) {
+  if (allocation.memory == VK_NULL_HANDLE)
+    return nullptr;
+  void **mapped = allocation.block >= 0
+                      ? &blocks[allocation.block].mapped
+                      : &dedicatedMapped[allocation.memory];
+  if (!*mapped && vkMapMemory(device, allocation.memory, 0, VK_WHOLE_SIZE, 0,
+                              mapped) != VK_SUCCESS) {
+    *mapped = nullptr;
+    throw std::runtime_error("failed to map buffer memory!");
+  }
+  return static_cast<char *>(*mapped) + allocation.offset;
+}
+
+VkMappedMemoryRange
+VulkanAllocator::mappedRange(const VulkanAllocation &allocation) const {
+  VkMappedMemoryRange range{VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE};
+  range.memory = allocation.memory;
+  if (allocation.block < 0) {
+    range.offset = 0;
+    range.size = VK_WHOLE_SIZE;
+  } else {
+    // Widen to nonCoherentAtomSize; block ranges are power-of-two aligned,
+    // so this only matters when the atom exceeds kMinRangeSize
+    range.offset = allocation.offset / nonCoherentAtomSize * nonCoherentAtomSize;
+    VkDeviceSize end = allocation.offset + allocation.size;
+    end = (end + nonCoherentAtomSize - 1) / nonCoherentAtomSize *
+          nonCoherentAtomSize;
+    range.size = std::min(end, blockSize) - range.offset;
+  }
+  return range;
+}
+
+void VulkanAllocator::flush(const VulkanAllocation &allocation) const {
+  if (memProperties.memoryTypes[allocation.memoryType].propertyFlags &
+      VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)
+    return;
+  VkMappedMemoryRange range = mappedRange(allocation);
+  vkFlushMappedMemoryRanges(device, 1, &range);
+}
+
+void VulkanAllocator::invalidate(const VulkanAllocation &allocation) const {
+  if (memProperties.memoryTypes[allocation.memoryType].propertyFlags &
+      VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)
+    return;
+  VkMappedMemoryRange range = mappedRange(allocation);
+  vkInvalidateMappedMemoryRanges(device, 1, &range);
+}
+
+VulkanAllocatorStats VulkanAllocator::getStats() const {
+  VulkanAllocatorStats stats;
+  stats.dedicatedCount = dedicatedCount;
+  stats.dedicatedBytes = dedicatedBytes;
+  stats.maxAllocationCount = maxAllocationCount;
+  stats.liveAllocations = liveAllocations;
+  stats.allocateCalls = allocateCalls;
+  stats.totalAllocateMs = totalAllocateMs;
+  stats.maxAllocateMs = maxAllocateMs;
+  stats.requestedBytes = requestedBytes;
+
+  for (const auto &block : blocks) {
+    if (block.memory == VK_NULL_HANDLE)
+      continue;
+    stats.blockCount++;
+    stats.blockBytes += blockSize;
+    stats.reservedBytes += block.reserved;
+    stats.freeBytes += blockSize - block.reserved;
+    for (uint32_t k = maxOrder + 1; k-- > 0;) {
+      if (!block.freeLists[k].empty()) {
+        stats.largestFreeBytes =
+            std::max<uint64_t>(stats.largestFreeBytes, kMinRangeSize << k);
+        break;
+      }
+    }
+  }
+  if (stats.freeBytes > 0) {
+    stats.fragmentation =
+        1.0 - static_cast<double>(stats.largestFreeBytes) / stats.freeBytes;
+  }
+  return stats;
+}
+
+void VulkanAllocator::printStats(std::ostream &os) const {
+  VulkanAllocatorStats stats = getStats();
+  auto mb = [](uint64_t bytes) { return bytes / (1024.0 * 1024.0); };
+  os << std::fixed << std::setprecision(1);
+  os << "Vulkan allocator: " << stats.blockCount << " block(s) of "
+     << mb(blockSize) << " MB, " << stats.dedicatedCount << " dedicated ("
+     << mb(stats.dedicatedBytes) << " MB); "
+     << stats.blockCount + stats.dedicatedCount << " of "
+     << stats.maxAllocationCount << " device allocations" << std::endl;
+  os << "  " << stats.liveAllocations << " live buffer(s), "
+     << mb(stats.reservedBytes) << " MB reserved in blocks, "
+     << mb(stats.freeBytes) << " MB free, fragmentation "
+     << stats.fragmentation * 100.0 << "%" << std::endl;
+  os << std::setprecision(3) << "  allocate(): " << stats.allocateCalls
+     << " call(s), avg "
+     << (stats.allocateCalls ? stats.totalAllocateMs / stats.allocateCalls
+                             : 0.0)
+     << " ms, max " << stats.maxAllocateMs << " ms" << std::endl;
+}
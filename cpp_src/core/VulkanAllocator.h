@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <set>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+// A range of device memory handed out by VulkanAllocator. Buffers are bound
+// at (memory, offset).
+struct VulkanAllocation {
+  VkDeviceMemory memory = VK_NULL_HANDLE;
+  VkDeviceSize offset = 0;
+  VkDeviceSize size = 0;      // Bytes reserved (a power of two in a block)
+  VkDeviceSize requested = 0; // Bytes asked for
+  uint32_t memoryType = 0;
+  int32_t block = -1; // -1 for a dedicated allocation
+};
+
+struct VulkanAllocatorStats {
+  uint32_t blockCount = 0;
+  uint32_t dedicatedCount = 0;
+  uint32_t maxAllocationCount = 0; // Device limit on live vkAllocateMemory
+  uint32_t liveAllocations = 0;
+  uint64_t blockBytes = 0;
+  uint64_t dedicatedBytes = 0;
+  uint64_t requestedBytes = 0; // Live allocations, as requested
+  uint64_t reservedBytes = 0;  // Live sub-allocations, rounded up
+  uint64_t freeBytes = 0;
+  uint64_t largestFreeBytes = 0;
+  // 1 - largestFree / free over all blocks: 0 when free space is contiguous
+  double fragmentation = 0.0;
+  uint64_t allocateCalls = 0;
+  double totalAllocateMs = 0.0;
+  double maxAllocateMs = 0.0;
+};
+
+// Buddy sub-allocator over large vkAllocateMemory blocks, one block list per
+// memory type. Requests are rounded up to a power of two (at least their
+// alignment), so every range is naturally aligned within its block. Requests
+// larger than a quarter of a block get a dedicated allocation. Not
+// thread-safe; each VulkanContext owns one.
+class VulkanAllocator {
+public:
+  static constexpr VkDeviceSize kMinRangeSize = 256;
+  static constexpr VkDeviceSize kDefaultBlockSize = 64ull << 20;
+
+  // device_address: allocate with VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT
+  VulkanAllocator(VkDevice device, VkPhysicalDevice physical_device,
+                  bool device_address,
+                  VkDeviceSize block_size = kDefaultBlockSize);
+  ~VulkanAllocator();
+
+  VulkanAllocator(const VulkanAllocator &) = delete;
+  VulkanAllocator &operator=(const VulkanAllocator &) = delete;
+
+  // Picks the first memory type with all of `properties`, preferring types
+  // without any of `avoid` (e.g. DEVICE_LOCAL for system-memory buffers)
+  VulkanAllocation allocate(const VkMemoryRequirements &requirements,
+                            VkMemoryPropertyFlags properties,
+                            VkMemoryPropertyFlags avoid = 0);
+  void free(const VulkanAllocation &allocation);
+  bool hasMemoryType(VkMemoryPropertyFlags properties) const;
+
+  // Host-visible allocations only. Blocks and dedicated allocations are
+  // mapped once on first use and stay mapped until freed. flush() and
+  // invalidate() are no-ops for coherent memory.
+  void *map(const VulkanAllocation &allocation);
+  void flush(const VulkanAllocation &allocation) const;
+  void invalidate(const VulkanAllocation &allocation) const;
+
+  VulkanAllocatorStats getStats() const;
+  void printStats(std::ostream &os) const;
+
+private:
+  struct Block {
+    VkDeviceMemory memory = VK_NULL_HANDLE; // Null once the slot is released
+    uint32_t memoryType = 0;
+    VkDeviceSize reserved = 0;
+    void *mapped = nullptr;
+    // freeLists[k] holds offsets of free ranges of kMinRangeSize << k bytes
+    std::vector<std::set<VkDeviceSize>> freeLists;
+  };
+
+  uint32_t findMemoryType(uint32_t type_bits, VkMemoryPropertyFlags properties,
+                          VkMemoryPropertyFlags avoid) const;
+  VkMappedMemoryRange mappedRange(const VulkanAllocation &allocation) const;
+  VkDeviceMemory allocateMemory(VkDeviceSize size, uint32_t memory_type);
+  bool allocateRange(Block &block, uint32_t order, VkDeviceSize &offset);
+  int32_t createBlock(uint32_t memory_type);
+  VulkanAllocation allocateDedicated(VkDeviceSize size, uint32_t memory_type);
+
+  VkDevice device;
+  VkPhysicalDeviceMemoryProperties memProperties;
+  bool deviceAddress;
+  VkDeviceSize blockSize;
+  uint32_t maxOrder;
+  uint32_t maxAllocationCount;
+  VkDeviceSize nonCoherentAtomSize;
+
+  std::vector<Block> blocks;
+  std::map<VkDeviceMemory, void *> dedicatedMapped;
+  uint32_t dedicatedCount = 0;
+  uint64_t dedicatedBytes = 0;
+  uint32_t liveAllocations = 0;
+  uint64_t requestedBytes = 0;
+  uint64_t allocateCalls = 0;
+  double totalAllocateMs = 0.0;
+  double maxAllocateMs = 0.0;
+};
@@ -1,7 +1,12 @@
 #pragma once
 
 #include "IComputeContext.h"
+#include "VulkanAllocator.h"
+#include "utils/ShaderCache.h"
+#include <atomic>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 #include <vulkan/vulkan.h>
@@ -19,7 +24,7 @@ public:
   bool isAvailable() const override { return instance != VK_NULL_HANDLE; }
   const std::vector<DeviceInfo> &getDevices() const override;
   void pickDevice(uint32_t index) override;
-  DeviceInfo getCurrentDeviceInfo() const override;
+  const DeviceInfo &getCurrentDeviceInfo() const override;
   uint32_t getSelectedDeviceIndex() const override {
     return selectedDeviceIndex;
   }
@@ -27,17 +32,28 @@ public:
   // Buffer management
   ComputeBuffer createBuffer(size_t size,
                              const void *host_ptr = nullptr) override;
+  // Flags select memory types by property (DEVICE_LOCAL, HOST_VISIBLE,
+  // HOST_CACHED); host-visible buffers stay persistently mapped
+  bool supportsBufferFlags(BufferFlags flags) const override;
+  ComputeBuffer createBuffer(size_t size, BufferFlags flags) override;
+  void *map(ComputeBuffer buffer) override;
+  void unmap(ComputeBuffer buffer) override;
   void writeBuffer(ComputeBuffer buffer, size_t offset, size_t size,
                    const void *host_ptr) override;
   void readBuffer(ComputeBuffer buffer, size_t offset, size_t size,
                   void *host_ptr) const override;
   void releaseBuffer(ComputeBuffer buffer) override;
+  void fillBuffer(ComputeBuffer buffer, size_t offset, size_t size,
+                  uint32_t pattern) override;
+  void copyBuffer(ComputeBuffer src, ComputeBuffer dst, size_t src_offset,
+                  size_t dst_offset, size_t size) override;
   VkDeviceAddress getBufferDeviceAddress(ComputeBuffer buffer) const;
 
   // Kernel management
   ComputeKernel createKernel(const std::string &file_name,
                              const std::string &kernel_name,
                              uint32_t num_buffer_args) override;
+  void precompileKernel(const KernelSource &source) override;
   ComputeKernel createRTPipeline(const std::string &rgen_path,
                                  const std::string &rmiss_path,
                                  const std::vector<std::string> &rchit_paths,
@@ -53,9 +69,38 @@ public:
   void dispatch(ComputeKernel kernel, uint32_t grid_x, uint32_t grid_y,
                 uint32_t grid_z, uint32_t block_x, uint32_t block_y,
                 uint32_t block_z) override;
+  void dispatchBatch(ComputeKernel kernel, uint32_t grid_x, uint32_t grid_y,
+                     uint32_t grid_z, uint32_t block_x, uint32_t block_y,
+                     uint32_t block_z, uint32_t count) override;
+  // Async dispatch completes a timeline semaphore value per submission.
+  // Without timeline semaphore support it falls back to the synchronous path.
+  DispatchHandle dispatchAsync(ComputeKernel kernel, uint32_t grid_x,
+                               uint32_t grid_y, uint32_t grid_z,
+                               uint32_t block_x, uint32_t block_y,
+                               uint32_t block_z, uint32_t count = 1) override;
+  void wait(DispatchHandle handle) override;
+  bool poll(DispatchHandle handle) override;
+  bool hasAsyncDispatch() const override {
+    return timelineSemaphore != VK_NULL_HANDLE;
+  }
   void releaseKernel(ComputeKernel kernel) override;
   void waitIdle() override;
 
+  // Device timing via a timestamp query pair around each dispatch
+  bool hasDeviceTimer() const override {
+    return timestampPool != VK_NULL_HANDLE;
+  }
+  void beginTiming() override;
+  void endTiming() override;
+  double getTimingResult() override;
+
+  // For benchmarks recording their own command buffers: bracket the work
+  // with cmdTimestampBegin/End, submit, wait, then call readTimestamps().
+  // Returns the device time in ms (also added to an active timing region).
+  void cmdTimestampBegin(VkCommandBuffer cmd);
+  void cmdTimestampEnd(VkCommandBuffer cmd);
+  double readTimestamps();
+
   void setExpectedKernelCount(uint32_t count) override;
   void notifyKernelCreated(const std::string &kernel_name) override;
   void setVerbose(bool v) override { verbose = v; }
@@ -78,6 +123,8 @@ public:
     return properties;
   }
   VkBuffer getVkBuffer(ComputeBuffer buffer) const;
+  // Device-memory sub-allocator statistics (printed on exit in verbose mode)
+  VulkanAllocatorStats getAllocatorStats() const;
 
 public:
   const std::vector<VkPhysicalDevice> &getPhysicalDevices() const {
@@ -88,8 +135,9 @@ public:
 private:
   struct VulkanBuffer {
     VkBuffer buffer;
-    VkDeviceMemory memory;
+    VulkanAllocation allocation;
     VkDeviceAddress address;
+    BufferFlags flags = BUFFER_DEVICE_LOCAL;
   };
 
   struct VulkanKernel {
@@ -108,8 +156,55 @@ private:
     VkStridedDeviceAddressRegionKHR hitRegion{};
     VkStridedDeviceAddressRegionKHR callRegion{};
     ComputeBuffer sbtBuffer = nullptr;
+
+    // Command buffer reused by every dispatch of this kernel. It is
+    // re-recorded only when an argument changes (cmdDirty) or the dispatch
+    // shape differs from the recorded one.
+    VkCommandBuffer cmd = VK_NULL_HANDLE;
+    bool cmdDirty = true;
+    uint32_t cmdGrid[3] = {0, 0, 0};
+    uint32_t cmdCount = 0;
+    bool cmdTimestamps = false;
+    // Timeline value of the last async submission of cmd
+    uint64_t cmdPendingValue = 0;
+  };
+
+  VkCommandBuffer prepareDispatch(VulkanKernel *vulkanKernel, uint32_t grid_x,
+                                  uint32_t grid_y, uint32_t grid_z,
+                                  uint32_t count, bool timestamps);
+  VkFence acquireFence();
+  void recycleFence(VkFence fence);
+
+  struct StagingSlot {
+    VkCommandBuffer cmd = VK_NULL_HANDLE;
+    VkFence fence = VK_NULL_HANDLE;
+    bool pending = false;
   };
+  void createStaging();
+  void destroyStaging();
+  void waitStagingSlot(StagingSlot &slot) const;
+  // Takes the next slot in the ring (waiting if it is still pending) and
+  // begins its command buffer; submitTransfer() ends and submits it
+  uint32_t beginTransfer() const;
+  void submitTransfer(StagingSlot &slot, bool to_host) const;
+  void flushStaging() const;
 
+  // Loads the on-disk pipeline cache if its header matches this device, and
+  // saves it back on teardown when pipelines were added
+  void createPipelineCache();
+  void savePipelineCache();
+
+  // Kernel creation up to the pipeline, minus the descriptor pool and set.
+  // Safe to call from several threads (see precompileKernel()).
+  void loadSpirv(const std::string &file_name,
+                 std::vector<uint32_t> &spirv_code,
+                 utils::ShaderCache::Blob &cached_spirv) const;
+  VulkanKernel *buildKernel(const std::string &file_name,
+                            const std::string &kernel_name,
+                            uint32_t num_buffer_args);
+  void destroyKernelObjects(VulkanKernel *vulkanKernel);
+
+  static DeviceInfo queryDeviceInfo(VkPhysicalDevice device);
   void createInstance();
   void enumeratePhysicalDevices();
   void createDevice();
@@ -125,11 +220,54 @@ private:
   uint32_t computeQueueFamilyIndex = 0;
   VkQueue computeQueue = VK_NULL_HANDLE;
   VkCommandPool commandPool = VK_NULL_HANDLE;
-  VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
-  VkFence computeFence = VK_NULL_HANDLE;
+  // Backs every createBuffer(); created with the device
+  std::unique_ptr<VulkanAllocator> allocator;
+
+  // Persistently mapped host-visible staging ring for writeBuffer() and
+  // readBuffer(). It is split into slots used in turn, so the memcpy into or
+  // out of one slot overlaps the GPU copy of the other. Uploads only block
+  // when the ring wraps onto a slot whose copy is still pending. Device-side
+  // fills and copies use the slots' command buffers without their memory.
+  static constexpr uint32_t kStagingSlots = 2;
+  static constexpr VkDeviceSize kStagingSlotSize = 16ull << 20;
+  VkBuffer stagingBuffer = VK_NULL_HANDLE;
+  VkDeviceMemory stagingMemory = VK_NULL_HANDLE;
+  uint8_t *stagingMapped = nullptr;
+  // readBuffer() is const but cycles the ring
+  mutable StagingSlot stagingSlots[kStagingSlots];
+  mutable uint32_t stagingNext = 0;
+  // Shared by every compute and RT pipeline creation on this device
+  VkPipelineCache pipelineCache = VK_NULL_HANDLE;
+  // Set by pipeline builds, which may run on compile-ahead threads
+  std::atomic<bool> pipelineCacheDirty{false};
+
+  // Unsignaled fences ready for reuse by synchronous submissions
+  std::vector<VkFence> fencePool;
+
+  // Async submissions: each signals the next timeline value
+  VkSemaphore timelineSemaphore = VK_NULL_HANDLE;
+  uint64_t timelineValue = 0;
+  PFN_vkWaitSemaphores pfnWaitSemaphores = nullptr;
+  PFN_vkGetSemaphoreCounterValue pfnGetSemaphoreCounterValue = nullptr;
+
+  // Extension entry points, resolved once in createDevice() (null when the
+  // extension is not enabled)
+  PFN_vkCmdTraceRaysKHR pfnCmdTraceRaysKHR = nullptr;
+  PFN_vkCreateRayTracingPipelinesKHR pfnCreateRayTracingPipelinesKHR = nullptr;
+  PFN_vkGetRayTracingShaderGroupHandlesKHR
+      pfnGetRayTracingShaderGroupHandlesKHR = nullptr;
+
+  VkQueryPool timestampPool = VK_NULL_HANDLE;
+  uint64_t timestampMask = 0;
+  bool timingActive = false;
+  double timedDeviceMs = 0.0;
 
   std::map<ComputeBuffer, VulkanBuffer *> buffers;
   std::map<ComputeKernel, VulkanKernel *> kernels;
+  // Built by precompileKernel(), keyed by file, entry point and buffer
+  // count; createKernel() takes them over
+  std::mutex prebuiltMutex;
+  std::map<std::string, VulkanKernel *> prebuiltKernels;
 
   mutable std::vector<DeviceInfo> deviceInfos;
   uint32_t selectedDeviceIndex = 0;
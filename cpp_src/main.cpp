@@ -1,7 +1,4 @@
 #include "CLI11.hpp"
-#include "benchmarks/RayAnyHitBench.h"
-#include "benchmarks/RayDivergenceBench.h"
-#include "benchmarks/RayTracingBench.h"
 #include "core/BenchmarkRunner.h"
 #include "core/ComputeBackendFactory.h"
 #include <cstdlib>
@@ -33,7 +30,9 @@ int main(int argc, char **argv) {
 
   std::vector<std::string> benchmarks_to_run;
   app.add_option("-b,--benchmarks,--benchmark", benchmarks_to_run,
-                 "Benchmarks to run (comma-separated)")
+                 "Benchmarks to run (comma-separated). Append :configs to "
+                 "run a subset of a benchmark's configs by index or name "
+                 "pattern, e.g. membw:Read* or raydiv:2,4")
       ->delimiter(',');
 
   bool list_benchmarks = false;
@@ -53,7 +52,8 @@ int main(int argc, char **argv) {
 
   std::vector<std::string> backend_strs;
   app.add_option("-k,--backend", backend_strs,
-                 "Backend to use: auto, vulkan, opencl, rocm (default: auto)")
+                 "Backend to use: auto, vulkan, opencl, rocm, host, simulated "
+                 "(default: auto)")
       ->delimiter(',');
 
   bool verbose = false;
@@ -66,6 +66,40 @@ int main(int argc, char **argv) {
   app.add_flag("--dump-geometry", dump_geometry,
                "Dump ray tracing geometry to OBJ files");
 
+  double time_budget_ms = 2500.0;
+  app.add_option("--time-budget", time_budget_ms,
+                 "Maximum sampling time per benchmark config in ms "
+                 "(default: 2500)");
+
+  double target_ci = 1.0;
+  app.add_option("--target-ci", target_ci,
+                 "Stop sampling once the 95% confidence interval is within "
+                 "this percentage of the mean (default: 1.0)");
+
+  bool parallel_devices = false;
+  app.add_flag("--parallel-devices", parallel_devices,
+               "Run benchmarks on all selected devices concurrently");
+
+  bool no_serialize_host = false;
+  app.add_flag("--no-serialize-host", no_serialize_host,
+               "With --parallel-devices, also overlap benchmarks that "
+               "contend for host resources");
+
+  uint32_t batch_size = 0;
+  app.add_option("--batch", batch_size,
+                 "Dispatches per submission for single-dispatch benchmarks "
+                 "(default: 0 = pick automatically)");
+
+  uint32_t in_flight = 1;
+  app.add_option("--in-flight", in_flight,
+                 "Submissions kept in flight while sampling (default: 1; "
+                 "2-3 measure sustained throughput without idle gaps)");
+
+  bool dry_run = false;
+  app.add_flag("--dry-run", dry_run,
+               "Print the benchmarks that would run on each device and an "
+               "estimated run time, then exit");
+
   CLI11_PARSE(app, argc, argv);
 
   // Default to device 0 if none specified
@@ -133,6 +167,12 @@ int main(int argc, char **argv) {
             contexts.push_back(
                 ComputeBackendFactory::create(ComputeBackend::ROCm, verbose, debug));
           }
+        } else if (backend_str == "host") {
+          contexts.push_back(
+              ComputeBackendFactory::create(ComputeBackend::Host, verbose, debug));
+        } else if (backend_str == "simulated") {
+          contexts.push_back(ComputeBackendFactory::create(
+              ComputeBackend::Simulated, verbose, debug));
         } else {
           std::cerr << "Unknown or unavailable backend: " << backend_str
                     << std::endl;
@@ -165,6 +205,8 @@ int main(int argc, char **argv) {
                         ? "Supported"
                         : "Not Supported")
                 << std::endl;
+      std::cout << "- host: Supported" << std::endl;
+      std::cout << "- simulated: Supported" << std::endl;
       return EXIT_SUCCESS;
     }
 
@@ -235,6 +277,14 @@ int main(int argc, char **argv) {
 
     // We need to keep execution_contexts alive until runner finishes
     BenchmarkRunner runner(context_ptrs, verbose, debug, dump_geometry);
+    SamplingPolicy policy;
+    policy.maxTimeMs = time_budget_ms;
+    policy.targetRelCI = target_ci / 100.0;
+    runner.setSamplingPolicy(policy);
+    runner.setParallelDevices(parallel_devices, !no_serialize_host);
+    runner.setBatchSize(batch_size);
+    runner.setInFlight(in_flight);
+    runner.setDryRun(dry_run);
     runner.run(benchmarks_to_run);
 
     // execution_contexts will be destroyed here, cleaning up resources
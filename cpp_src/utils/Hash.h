@@ -0,0 +1,126 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace utils {
+
+// Streaming XXH64 (https://github.com/Cyan4973/xxHash), small enough to
+// keep in-tree. Used for cache keys, not for anything security related.
+class Hash64 {
+public:
+  explicit Hash64(uint64_t seed = 0) : seed(seed) {
+    acc[0] = seed + kPrime1 + kPrime2;
+    acc[1] = seed + kPrime2;
+    acc[2] = seed;
+    acc[3] = seed - kPrime1;
+  }
+
+  Hash64 &update(const void *data, size_t size) {
+    const uint8_t *p = static_cast<const uint8_t *>(data);
+    total += size;
+    if (pending + size < sizeof(buffer)) {
+      memcpy(buffer + pending, p, size);
+      pending += size;
+      return *this;
+    }
+    if (pending) {
+      size_t fill = sizeof(buffer) - pending;
+      memcpy(buffer + pending, p, fill);
+      consume(buffer);
+      p += fill;
+      size -= fill;
+      pending = 0;
+    }
+    for (; size >= sizeof(buffer); p += sizeof(buffer), size -= sizeof(buffer))
+      consume(p);
+    memcpy(buffer, p, size);
+    pending = size;
+    return *this;
+  }
+
+  // Length-prefixed, so ("ab", "c") and ("a", "bc") hash differently
+  Hash64 &update(const std::string &s) {
+    uint64_t size = s.size();
+    update(&size, sizeof(size));
+    return update(s.data(), s.size());
+  }
+
+  uint64_t digest() const {
+    uint64_t h;
+    if (total >= sizeof(buffer)) {
+      h = rotl(acc[0], 1) + rotl(acc[1], 7) + rotl(acc[2], 12) +
+          rotl(acc[3], 18);
+      for (uint64_t v : acc)
+        h = (h ^ round(0, v)) * kPrime1 + kPrime4;
+    } else {
+      h = seed + kPrime5;
+    }
+    h += total;
+
+    const uint8_t *p = buffer;
+    size_t size = pending;
+    for (; size >= 8; p += 8, size -= 8) {
+      h ^= round(0, read64(p));
+      h = rotl(h, 27) * kPrime1 + kPrime4;
+    }
+    if (size >= 4) {
+      h ^= uint64_t(read32(p)) * kPrime1;
+      h = rotl(h, 23) * kPrime2 + kPrime3;
+      p += 4;
+      size -= 4;
+    }
+    for (; size > 0; ++p, --size) {
+      h ^= *p * kPrime5;
+      h = rotl(h, 11) * kPrime1;
+    }
+
+    h ^= h >> 33;
+    h *= kPrime2;
+    h ^= h >> 29;
+    h *= kPrime3;
+    h ^= h >> 32;
+    return h;
+  }
+
+private:
+  static constexpr uint64_t kPrime1 = 0x9E3779B185EBCA87ull;
+  static constexpr uint64_t kPrime2 = 0xC2B2AE3D27D4EB4Full;
+  static constexpr uint64_t kPrime3 = 0x165667B19E3779F9ull;
+  static constexpr uint64_t kPrime4 = 0x85EBCA77C2B2AE63ull;
+  static constexpr uint64_t kPrime5 = 0x27D4EB2F165667C5ull;
+
+  static uint64_t rotl(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+  static uint64_t read64(const uint8_t *p) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+  }
+  static uint32_t read32(const uint8_t *p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+  }
+  static uint64_t round(uint64_t acc, uint64_t input) {
+    acc += input * kPrime2;
+    return rotl(acc, 31) * kPrime1;
+  }
+  void consume(const uint8_t *p) {
+    for (int i = 0; i < 4; ++i)
+      acc[i] = round(acc[i], read64(p + i * 8));
+  }
+
+  uint64_t seed;
+  uint64_t acc[4];
+  uint8_t buffer[32];
+  size_t pending = 0;
+  uint64_t total = 0;
+};
+
+inline uint64_t hash64(const void *data, size_t size, uint64_t seed = 0) {
+  return Hash64(seed).update(data, size).digest();
+}
+
+} // namespace utils
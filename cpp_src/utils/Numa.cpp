@@ -0,0 +1,111 @@
+#include "utils/Numa.h"
+#include "utils/PinnedThreadPool.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace utils {
+
+static const char *kNodeDir = "/sys/devices/system/node/";
+
+// Parses a sysfs list such as "0-3,8-11"
+static std::vector<int> parseList(const std::string &list) {
+  std::vector<int> result;
+  std::stringstream ss(list);
+  std::string range;
+  while (std::getline(ss, range, ',')) {
+    if (range.empty() || range == "\n")
+      continue;
+    try {
+      size_t dash = range.find('-');
+      int first = std::stoi(range.substr(0, dash));
+      int last = dash == std::string::npos ? first
+                                           : std::stoi(range.substr(dash + 1));
+      for (int i = first; i <= last; ++i)
+        result.push_back(i);
+    } catch (...) {
+    }
+  }
+  return result;
+}
+
+static bool readLine(const std::string &path, std::string &line) {
+  std::ifstream file(path);
+  return file && std::getline(file, line);
+}
+
+std::vector<NumaNode> numaNodes() {
+  std::vector<int> allowed = PinnedThreadPool::allowedCpus();
+  std::vector<NumaNode> nodes;
+
+  std::string line;
+  if (readLine(std::string(kNodeDir) + "online", line)) {
+    std::vector<int> withMemory;
+    std::string memLine;
+    bool knowMemory = readLine(std::string(kNodeDir) + "has_memory", memLine);
+    if (knowMemory)
+      withMemory = parseList(memLine);
+
+    for (int id : parseList(line)) {
+      NumaNode node;
+      node.id = id;
+      std::string cpuLine;
+      if (readLine(kNodeDir + ("node" + std::to_string(id)) + "/cpulist",
+                   cpuLine)) {
+        for (int cpu : parseList(cpuLine)) {
+          if (std::find(allowed.begin(), allowed.end(), cpu) != allowed.end())
+            node.cpus.push_back(cpu);
+        }
+      }
+      node.hasMemory =
+          !knowMemory ||
+          std::find(withMemory.begin(), withMemory.end(), id) !=
+              withMemory.end();
+      nodes.push_back(std::move(node));
+    }
+  }
+
+  if (nodes.empty()) {
+    NumaNode node;
+    node.cpus = allowed;
+    nodes.push_back(std::move(node));
+  }
+  return nodes;
+}
+
+int pciNumaNode(const std::string &pciBusId) {
+  if (pciBusId.empty())
+    return -1;
+  std::string line;
+  if (!readLine("/sys/bus/pci/devices/" + pciBusId + "/numa_node", line))
+    return -1;
+  try {
+    return std::stoi(line); // -1 where the platform doesn't say
+  } catch (...) {
+    return -1;
+  }
+}
+
+bool bindMemoryToNode(void *addr, size_t size, int node) {
+#if defined(__linux__) && defined(SYS_mbind)
+  constexpr int kMpolBind = 2;
+  constexpr size_t kMaskBits = 1024;
+  constexpr size_t kWordBits = 8 * sizeof(unsigned long);
+  if (node < 0 || static_cast<size_t>(node) >= kMaskBits)
+    return false;
+  unsigned long mask[kMaskBits / kWordBits] = {};
+  mask[node / kWordBits] |= 1UL << (node % kWordBits);
+  // The kernel reads maxnode - 1 bits
+  return syscall(SYS_mbind, addr, size, kMpolBind, mask, kMaskBits + 1, 0) ==
+         0;
+#else
+  return false;
+#endif
+}
+
+} // namespace utils
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace utils {
+
+struct NumaNode {
+  int id = 0;
+  std::vector<int> cpus; // CPUs of the node the process may run on
+  bool hasMemory = true;
+};
+
+// Online NUMA nodes from /sys/devices/system/node. Where that is missing
+// (non-Linux, or a kernel without NUMA) the system is one node 0 with every
+// allowed CPU.
+std::vector<NumaNode> numaNodes();
+
+// NUMA node of the PCI device at `pciBusId` ("dddd:bb:dd.f"), or -1 if it
+// is unknown
+int pciNumaNode(const std::string &pciBusId);
+
+// Restricts the pages of [addr, addr + size) to `node` with mbind(MPOL_BIND).
+// Takes effect for pages not yet touched; addr must be page aligned. Returns
+// false if the kernel refused or NUMA policies are unavailable.
+bool bindMemoryToNode(void *addr, size_t size, int node);
+
+} // namespace utils
@@ -0,0 +1,140 @@
+#include "utils/PinnedThreadPool.h"
+#include <algorithm>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#endif
+
+namespace utils {
+
+static inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+  _mm_pause();
+#endif
+}
+
+std::vector<int> PinnedThreadPool::allowedCpus() {
+  std::vector<int> result;
+#ifdef __linux__
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+      if (CPU_ISSET(cpu, &set))
+        result.push_back(cpu);
+    }
+  }
+#endif
+  if (result.empty()) {
+    unsigned threads = std::thread::hardware_concurrency();
+    result.assign(threads ? threads : 1, -1);
+  }
+  return result;
+}
+
+PinnedThreadPool::PinnedThreadPool(std::vector<int> cpuList)
+    : cpus(cpuList.empty() ? allowedCpus() : std::move(cpuList)),
+      wake(cpus.size()) {
+  for (unsigned i = 0; i < cpus.size(); ++i)
+    workers.emplace_back(&PinnedThreadPool::workerLoop, this, i);
+}
+
+PinnedThreadPool::~PinnedThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  for (auto &cv : wake)
+    cv.notify_one();
+  for (auto &worker : workers)
+    worker.join();
+}
+
+void PinnedThreadPool::run(unsigned begin, unsigned end,
+                           const std::function<void(unsigned)> &fn) {
+  end = std::min(end, size());
+  if (begin >= end)
+    return;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    task = &fn;
+    firstWorker = begin;
+    endWorker = end;
+    pending.store(end - begin, std::memory_order_relaxed);
+    ++generation;
+  }
+  for (unsigned i = begin; i < end; ++i)
+    wake[i].notify_one();
+
+  std::unique_lock<std::mutex> lock(mutex);
+  done.wait(lock, [this] {
+    return pending.load(std::memory_order_acquire) == 0;
+  });
+  task = nullptr;
+}
+
+void PinnedThreadPool::workerLoop(unsigned self) {
+#ifdef __linux__
+  if (cpus[self] >= 0) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpus[self], &set);
+    // Best effort: the CPU may have gone offline since it was listed
+    sched_setaffinity(0, sizeof(set), &set);
+  }
+#endif
+  uint64_t seen = 0;
+  for (;;) {
+    const std::function<void(unsigned)> *fn;
+    unsigned count;
+    bool sense;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      wake[self].wait(lock, [&] {
+        return stopping || (generation != seen && self >= firstWorker &&
+                            self < endWorker);
+      });
+      if (stopping)
+        return;
+      seen = generation;
+      fn = task;
+      count = endWorker - firstWorker;
+      // The gate can't flip before this worker arrives, so every worker of
+      // the run reads the same value here, whichever runs it skipped
+      sense = !gateSense.load(std::memory_order_relaxed);
+    }
+
+    // Wake-ups are tens of microseconds apart; line the workers up again at
+    // a sense-reversing barrier. The last to arrive resets the count and
+    // flips the sense, releasing the others. Spin briefly, then yield so
+    // oversubscribed pools still progress.
+    if (arrived.fetch_add(1, std::memory_order_acq_rel) + 1 == count) {
+      arrived.store(0, std::memory_order_relaxed);
+      gateSense.store(sense, std::memory_order_release);
+    } else {
+      unsigned spins = 0;
+      while (gateSense.load(std::memory_order_acquire) != sense) {
+        if (++spins < 4096) {
+          cpuRelax();
+        } else {
+          std::this_thread::yield();
+        }
+      }
+    }
+
+    (*fn)(self);
+
+    if (pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      // Taking the lock orders this against the caller's predicate check
+      std::lock_guard<std::mutex> lock(mutex);
+      done.notify_one();
+    }
+  }
+}
+
+} // namespace utils
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace utils {
+
+// Persistent workers, each pinned to one CPU, that run a function all at
+// once. Unlike ThreadPool there is no queue: run() wakes just the workers it
+// needs, which then meet at a sense-reversing spin barrier so they start
+// within a cache-line hop of each other, and thread creation never lands in a measurement.
+// Between runs every worker sleeps on its condition variable and the caller
+// sleeps until the run is done, so neither competes with the measured
+// threads.
+//
+// Pinning uses sched_setaffinity on Linux; elsewhere the threads float.
+class PinnedThreadPool {
+public:
+  // One worker per CPU in `cpus`; empty means every CPU the process may run
+  // on
+  explicit PinnedThreadPool(std::vector<int> cpus = {});
+  ~PinnedThreadPool();
+
+  PinnedThreadPool(const PinnedThreadPool &) = delete;
+  PinnedThreadPool &operator=(const PinnedThreadPool &) = delete;
+
+  unsigned size() const { return static_cast<unsigned>(workers.size()); }
+  // CPU worker `index` is pinned to, -1 if unpinned
+  int cpu(unsigned index) const { return cpus[index]; }
+
+  // Calls fn(i) on workers begin..end-1 concurrently and returns once all
+  // of them have returned. The other workers stay asleep. fn must not
+  // throw.
+  void run(unsigned begin, unsigned end,
+           const std::function<void(unsigned)> &fn);
+  void run(unsigned active, const std::function<void(unsigned)> &fn) {
+    run(0, active, fn);
+  }
+
+  // CPUs the calling thread may run on, in ascending order
+  static std::vector<int> allowedCpus();
+
+private:
+  void workerLoop(unsigned self);
+
+  std::vector<int> cpus;
+  std::vector<std::thread> workers;
+
+  // Guards the run description below; workers and caller sleep on it
+  std::mutex mutex;
+  std::vector<std::condition_variable> wake; // One per worker
+  std::condition_variable done;
+  uint64_t generation = 0; // Bumped by every run()
+  const std::function<void(unsigned)> *task = nullptr;
+  unsigned firstWorker = 0;
+  unsigned endWorker = 0;
+  bool stopping = false;
+
+  // Start barrier. Workers count themselves in; the last one resets
+  // `arrived` and flips `gateSense`, which the others spin on.
+  std::atomic<unsigned> arrived{0};
+  std::atomic<bool> gateSense{false};
+  std::atomic<unsigned> pending{0}; // Workers still running the task
+};
+
+} // namespace utils
@@ -1,144 +1,432 @@
 #include "ShaderCache.h"
+#include "Hash.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
 #include <fstream>
+#include <functional>
 #include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <sstream>
+#include <thread>
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 namespace utils {
 
-std::filesystem::path ShaderCache::getCacheDir(const DeviceInfo &device) {
-  std::filesystem::path home = std::getenv("HOME") ? std::getenv("HOME") : ".";
-  std::filesystem::path cache_base = home / ".cache" / "gpubench";
+namespace {
 
-  // Create a unique directory for this driver/device combination
-  std::string sig =
-      device.driverUUID + "_" + std::to_string(device.driverVersion);
-  std::filesystem::path dir = cache_base / sig;
+const char kMagic[8] = {'G', 'P', 'B', 'K', 'P', 'A', 'C', 'K'};
+const uint32_t kVersion = 1;
+const uint64_t kAlignment = 64;
+const char *kArchiveName = "kernels.pack";
 
-  if (!std::filesystem::exists(dir)) {
-    std::filesystem::create_directories(dir);
+struct ArchiveHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t count;
+  uint64_t tableOffset;
+};
+
+struct ArchiveEntry {
+  uint64_t id; // makeKey() combined with the entry kind
+  uint64_t offset;
+  uint64_t size;
+  int64_t lastUsed; // Microseconds since the epoch
+};
+
+// Read-only view of a whole file. POSIX maps it; Windows reads it into
+// memory instead, since a mapped file there cannot be replaced by rename.
+class MappedFile {
+public:
+  explicit MappedFile(const std::filesystem::path &path) {
+#ifdef _WIN32
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open())
+      return;
+    std::streamsize n = file.tellg();
+    file.seekg(0, std::ios::beg);
+    buffer.resize(n);
+    if (n <= 0 || !file.read(buffer.data(), n))
+      return;
+    data = buffer.data();
+    size = buffer.size();
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+      return;
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+      void *p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (p != MAP_FAILED) {
+        data = static_cast<const char *>(p);
+        size = st.st_size;
+      }
+    }
+    close(fd);
+#endif
+  }
+  ~MappedFile() {
+#ifndef _WIN32
+    if (data)
+      munmap(const_cast<char *>(data), size);
+#endif
   }
 
-  return dir;
-}
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
 
-std::string ShaderCache::getSafeName(const std::string &name) {
-  std::filesystem::path p(name);
-  return p.filename().string();
-}
+  const char *data = nullptr;
+  size_t size = 0;
 
-bool ShaderCache::loadVulkanCache(const std::string &kernel_name,
-                                  const DeviceInfo &device,
-                                  std::vector<uint32_t> &spirv) {
-  std::filesystem::path cache_file =
-      getCacheDir(device) / (getSafeName(kernel_name) + ".spv");
+private:
+#ifdef _WIN32
+  std::vector<char> buffer;
+#endif
+};
 
-  if (!std::filesystem::exists(cache_file)) {
-    return false;
+struct PendingEntry {
+  std::vector<char> data;
+  int64_t lastUsed;
+};
+
+struct Archive {
+  std::unique_ptr<MappedFile> file;
+  std::map<uint64_t, ArchiveEntry> entries; // Offsets into *file
+  std::map<uint64_t, PendingEntry> pending; // Saved, not yet committed
+};
+
+std::mutex archiveMutex;
+
+// Write to a temporary file named after the process and thread, then rename
+// it into place. No two writers, in this or another gpubench process sharing
+// the cache directory, use the same temporary file at once, and readers
+// never observe a partially written file.
+bool writeFileAtomic(const std::filesystem::path &path,
+                     const std::function<bool(std::ostream &)> &write) {
+  std::ostringstream suffix;
+#ifdef _WIN32
+  suffix << ".tmp." << _getpid();
+#else
+  suffix << ".tmp." << getpid();
+#endif
+  suffix << "." << std::this_thread::get_id();
+  std::filesystem::path tmp = path;
+  tmp += suffix.str();
+
+  {
+    std::ofstream file(tmp, std::ios::binary);
+    if (!file.is_open()) {
+      return false;
+    }
+    if (!write(file) || !file) {
+      file.close();
+      std::error_code ec;
+      std::filesystem::remove(tmp, ec);
+      return false;
+    }
   }
 
-  std::ifstream file(cache_file, std::ios::binary | std::ios::ate);
-  if (!file.is_open()) {
+  std::error_code ec;
+  std::filesystem::rename(tmp, path, ec);
+  if (ec) {
+    std::filesystem::remove(tmp, ec);
     return false;
   }
+  return true;
+}
 
-  std::streamsize size = file.tellg();
-  file.seekg(0, std::ios::beg);
+int64_t nowMicroseconds() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
 
-  spirv.resize(size / sizeof(uint32_t));
-  if (file.read(reinterpret_cast<char *>(spirv.data()), size)) {
-    return true;
-  }
+uint64_t cacheLimitBytes() {
+  const char *env = std::getenv("GPUBENCH_CACHE_MAX_MB");
+  uint64_t mb = env ? std::strtoull(env, nullptr, 10) : 0;
+  return (mb ? mb : 512) << 20;
+}
 
-  return false;
+uint64_t alignUp(uint64_t value) {
+  return (value + kAlignment - 1) & ~(kAlignment - 1);
 }
 
-void ShaderCache::saveVulkanCache(const std::string &kernel_name,
-                                  const DeviceInfo &device,
-                                  const std::vector<uint32_t> &spirv) {
-  std::filesystem::path cache_file =
-      getCacheDir(device) / (getSafeName(kernel_name) + ".spv");
+// Entries of a well-formed archive; anything malformed reads as empty
+std::map<uint64_t, ArchiveEntry> parseArchive(const MappedFile &file) {
+  ArchiveHeader header;
+  if (!file.data || file.size < sizeof(header))
+    return {};
+  memcpy(&header, file.data, sizeof(header));
+  if (memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 ||
+      header.version != kVersion || header.tableOffset > file.size ||
+      header.count > (file.size - header.tableOffset) / sizeof(ArchiveEntry))
+    return {};
 
-  std::ofstream file(cache_file, std::ios::binary);
-  if (file.is_open()) {
-    file.write(reinterpret_cast<const char *>(spirv.data()),
-               spirv.size() * sizeof(uint32_t));
+  std::map<uint64_t, ArchiveEntry> entries;
+  for (uint32_t i = 0; i < header.count; ++i) {
+    ArchiveEntry entry;
+    memcpy(&entry, file.data + header.tableOffset + i * sizeof(entry),
+           sizeof(entry));
+    if (entry.offset < sizeof(header) || entry.offset > header.tableOffset ||
+        entry.size > header.tableOffset - entry.offset)
+      return {};
+    entries[entry.id] = entry;
   }
+  return entries;
 }
 
-bool ShaderCache::loadROCmCache(const std::string &kernel_name,
-                                const DeviceInfo &device,
-                                std::vector<char> &code) {
-  std::filesystem::path cache_file =
-      getCacheDir(device) / (getSafeName(kernel_name) + ".co");
+struct Archives {
+  std::map<std::filesystem::path, Archive> byDir;
+  // Blobs handed out stay valid after a commit replaces their storage
+  std::vector<std::unique_ptr<MappedFile>> retiredFiles;
+  std::vector<std::vector<char>> retiredData;
 
-  if (!std::filesystem::exists(cache_file)) {
-    return false;
-  }
+  ~Archives();
+};
+Archives archives;
 
-  std::ifstream file(cache_file, std::ios::binary | std::ios::ate);
-  if (!file.is_open()) {
-    return false;
+Archive &getArchive(const std::filesystem::path &dir) {
+  auto it = archives.byDir.find(dir);
+  if (it != archives.byDir.end())
+    return it->second;
+
+  Archive &archive = archives.byDir[dir];
+  archive.file = std::make_unique<MappedFile>(dir / kArchiveName);
+  archive.entries = parseArchive(*archive.file);
+  if (!archive.file->data) {
+    // No archive yet: files from the older one-file-per-kernel layouts can
+    // never be matched again
+    std::error_code ec;
+    for (const auto &file : std::filesystem::directory_iterator(dir, ec)) {
+      std::string ext = file.path().extension().string();
+      if (ext == ".spv" || ext == ".co" || ext == ".clbin" ||
+          file.path().filename() == "index")
+        std::filesystem::remove(file.path(), ec);
+    }
   }
+  return archive;
+}
 
-  std::streamsize size = file.tellg();
-  file.seekg(0, std::ios::beg);
+// Rewrites the archive with the pending entries added. Entries committed by
+// other processes since this one mapped the archive are kept, and entries
+// they evicted stay evicted. Last-use times refreshed by hits are persisted
+// here, so they only reach disk along with new entries.
+void commit(const std::filesystem::path &dir, Archive &archive) {
+  if (archive.pending.empty())
+    return;
 
-  code.resize(size);
-  if (file.read(code.data(), size)) {
-    return true;
+  std::filesystem::path path = dir / kArchiveName;
+  auto current = std::make_unique<MappedFile>(path);
+  std::map<uint64_t, ArchiveEntry> onDisk = parseArchive(*current);
+
+  struct Source {
+    uint64_t id;
+    const char *data;
+    uint64_t size;
+    int64_t lastUsed;
+    bool fresh;
+  };
+  std::vector<Source> sources;
+  for (const auto &it : onDisk) {
+    int64_t lastUsed = it.second.lastUsed;
+    auto ours = archive.entries.find(it.first);
+    if (ours != archive.entries.end())
+      lastUsed = std::max(lastUsed, ours->second.lastUsed);
+    sources.push_back({it.first, current->data + it.second.offset,
+                       it.second.size, lastUsed, false});
+  }
+  for (const auto &it : archive.pending) {
+    if (!onDisk.count(it.first))
+      sources.push_back({it.first, it.second.data.data(),
+                         it.second.data.size(), it.second.lastUsed, true});
   }
 
-  return false;
+  // Keep the most recently used entries that fit; new ones always stay
+  std::sort(sources.begin(), sources.end(),
+            [](const Source &a, const Source &b) {
+              return a.lastUsed > b.lastUsed;
+            });
+  uint64_t limit = cacheLimitBytes();
+  uint64_t used = 0;
+  std::vector<Source> kept;
+  std::vector<ArchiveEntry> table;
+  uint64_t offset = alignUp(sizeof(ArchiveHeader));
+  for (const Source &source : sources) {
+    if (!source.fresh && used + source.size > limit)
+      continue;
+    used += source.size;
+    kept.push_back(source);
+    table.push_back({source.id, offset, source.size, source.lastUsed});
+    offset = alignUp(offset + source.size);
+  }
+
+  ArchiveHeader header{};
+  memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.count = static_cast<uint32_t>(table.size());
+  header.tableOffset = offset;
+
+  writeFileAtomic(path, [&](std::ostream &out) {
+    static const char zeros[kAlignment] = {};
+    uint64_t pos = sizeof(header);
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    for (size_t i = 0; i < kept.size(); ++i) {
+      out.write(zeros, table[i].offset - pos);
+      out.write(kept[i].data, kept[i].size);
+      pos = table[i].offset + kept[i].size;
+    }
+    out.write(zeros, header.tableOffset - pos);
+    out.write(reinterpret_cast<const char *>(table.data()),
+              table.size() * sizeof(ArchiveEntry));
+    return static_cast<bool>(out);
+  });
+
+  archives.retiredFiles.push_back(std::move(archive.file));
+  archives.retiredFiles.push_back(std::move(current));
+  for (auto &it : archive.pending)
+    archives.retiredData.push_back(std::move(it.second.data));
+  archive.pending.clear();
+  archive.file = std::make_unique<MappedFile>(path);
+  archive.entries = parseArchive(*archive.file);
 }
 
-void ShaderCache::saveROCmCache(const std::string &kernel_name,
-                                const DeviceInfo &device,
-                                const std::vector<char> &code) {
-  std::filesystem::path cache_file =
-      getCacheDir(device) / (getSafeName(kernel_name) + ".co");
+Archives::~Archives() {
+  std::lock_guard<std::mutex> lock(archiveMutex);
+  for (auto &it : byDir)
+    commit(it.first, it.second);
+}
 
-  std::ofstream file(cache_file, std::ios::binary);
-  if (file.is_open()) {
-    file.write(code.data(), code.size());
-  }
+uint64_t entryId(uint64_t key, const char *kind) {
+  return Hash64(key).update(kind, strlen(kind)).digest();
 }
 
-bool ShaderCache::loadOpenCLCache(const std::string &kernel_name,
-                                  const DeviceInfo &device,
-                                  std::vector<char> &binary) {
-  std::filesystem::path cache_file =
-      getCacheDir(device) / (getSafeName(kernel_name) + ".clbin");
+} // namespace
 
-  if (!std::filesystem::exists(cache_file)) {
-    return false;
-  }
+std::filesystem::path ShaderCache::getCacheDir(const DeviceInfo &device) {
+  std::filesystem::path home = std::getenv("HOME") ? std::getenv("HOME") : ".";
+  std::filesystem::path cache_base = home / ".cache" / "gpubench";
 
-  std::ifstream file(cache_file, std::ios::binary | std::ios::ate);
-  if (!file.is_open()) {
-    return false;
+  // Create a unique directory for this driver/device combination
+  std::string sig =
+      device.driverUUID + "_" + std::to_string(device.driverVersion);
+  std::filesystem::path dir = cache_base / sig;
+
+  if (!std::filesystem::exists(dir)) {
+    std::error_code ec; // another device worker may create it concurrently
+    std::filesystem::create_directories(dir, ec);
   }
 
-  std::streamsize size = file.tellg();
-  file.seekg(0, std::ios::beg);
+  return dir;
+}
+
+uint64_t ShaderCache::makeKey(const std::string &source,
+                              const std::string &options,
+                              const std::string &compiler) {
+  return Hash64().update(source).update(options).update(compiler).digest();
+}
+
+bool ShaderCache::loadEntry(const DeviceInfo &device, uint64_t key,
+                            const char *kind, Blob &blob) {
+  std::filesystem::path dir = getCacheDir(device);
+  uint64_t id = entryId(key, kind);
 
-  binary.resize(size);
-  if (file.read(binary.data(), size)) {
+  std::lock_guard<std::mutex> lock(archiveMutex);
+  Archive &archive = getArchive(dir);
+  auto pending = archive.pending.find(id);
+  if (pending != archive.pending.end()) {
+    pending->second.lastUsed = nowMicroseconds();
+    blob.data = pending->second.data.data();
+    blob.size = pending->second.data.size();
     return true;
   }
+  auto entry = archive.entries.find(id);
+  if (entry == archive.entries.end())
+    return false;
+  entry->second.lastUsed = nowMicroseconds();
+  blob.data = archive.file->data + entry->second.offset;
+  blob.size = entry->second.size;
+  return true;
+}
+
+void ShaderCache::saveEntry(const DeviceInfo &device, uint64_t key,
+                            const char *kind, const char *data, size_t size) {
+  std::filesystem::path dir = getCacheDir(device);
+  uint64_t id = entryId(key, kind);
 
-  return false;
+  std::lock_guard<std::mutex> lock(archiveMutex);
+  Archive &archive = getArchive(dir);
+  // Same key, same bytes; replacing them would invalidate handed-out blobs
+  if (archive.entries.count(id) || archive.pending.count(id))
+    return;
+  archive.pending[id] =
+      PendingEntry{std::vector<char>(data, data + size), nowMicroseconds()};
 }
 
-void ShaderCache::saveOpenCLCache(const std::string &kernel_name,
-                                  const DeviceInfo &device,
-                                  const std::vector<char> &binary) {
-  std::filesystem::path cache_file =
-      getCacheDir(device) / (getSafeName(kernel_name) + ".clbin");
+void ShaderCache::flush() {
+  std::lock_guard<std::mutex> lock(archiveMutex);
+  for (auto &it : archives.byDir)
+    commit(it.first, it.second);
+}
 
-  std::ofstream file(cache_file, std::ios::binary);
-  if (file.is_open()) {
-    file.write(binary.data(), binary.size());
-  }
+bool ShaderCache::loadVulkanCache(uint64_t key, const DeviceInfo &device,
+                                  Blob &spirv) {
+  return loadEntry(device, key, "spv", spirv) &&
+         spirv.size % sizeof(uint32_t) == 0;
+}
+
+void ShaderCache::saveVulkanCache(uint64_t key, const DeviceInfo &device,
+                                  const std::vector<uint32_t> &spirv) {
+  saveEntry(device, key, "spv", reinterpret_cast<const char *>(spirv.data()),
+            spirv.size() * sizeof(uint32_t));
+}
+
+bool ShaderCache::loadVulkanPipelineCache(const DeviceInfo &device,
+                                          std::vector<char> &data) {
+  MappedFile file(getCacheDir(device) / "pipeline.vkcache");
+  if (!file.data)
+    return false;
+  data.assign(file.data, file.data + file.size);
+  return true;
+}
+
+void ShaderCache::saveVulkanPipelineCache(const DeviceInfo &device,
+                                          const std::vector<char> &data) {
+  std::filesystem::path cache_file = getCacheDir(device) / "pipeline.vkcache";
+
+  writeFileAtomic(cache_file, [&](std::ostream &out) {
+    out.write(data.data(), data.size());
+    return static_cast<bool>(out);
+  });
+}
+
+bool ShaderCache::loadROCmCache(uint64_t key, const DeviceInfo &device,
+                                Blob &code) {
+  return loadEntry(device, key, "co", code);
+}
+
+void ShaderCache::saveROCmCache(uint64_t key, const DeviceInfo &device,
+                                const std::vector<char> &code) {
+  saveEntry(device, key, "co", code.data(), code.size());
+}
+
+bool ShaderCache::loadOpenCLCache(uint64_t key, const DeviceInfo &device,
+                                  Blob &binary) {
+  return loadEntry(device, key, "clbin", binary);
+}
+
+void ShaderCache::saveOpenCLCache(uint64_t key, const DeviceInfo &device,
+                                  const std::vector<char> &binary) {
+  saveEntry(device, key, "clbin", binary.data(), binary.size());
 }
 
 } // namespace utils
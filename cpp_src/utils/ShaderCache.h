@@ -1,38 +1,70 @@
 #pragma once
 
 #include "core/IComputeContext.h"
+#include <cstdint>
 #include <filesystem>
 #include <string>
 #include <vector>
 
 namespace utils {
 
+// Compiled kernels, one archive file per driver/device signature. Entries are
+// keyed by makeKey() over everything that determines the binary, so editing
+// a source or changing compile options is a miss rather than a stale hit.
+//
+// The archive (kernels.pack) is a header, 64-byte aligned blobs and a table
+// of (id, offset, size, last use). It is memory-mapped once per process and
+// loaded kernels point straight into the mapping. Saves are buffered and
+// committed by flush() (also run at exit): the current archive, the new
+// entries and entries other processes committed meanwhile are written to a
+// temporary file that is renamed over the archive. Commits evict the least
+// recently used entries beyond GPUBENCH_CACHE_MAX_MB (default 512).
 class ShaderCache {
 public:
+  // Bytes of a cached kernel. Valid, and at least 16-byte aligned, for the
+  // life of the process.
+  struct Blob {
+    const char *data = nullptr;
+    size_t size = 0;
+  };
+
   static std::filesystem::path getCacheDir(const DeviceInfo &device);
 
-  static bool loadVulkanCache(const std::string &kernel_name,
-                              const DeviceInfo &device,
-                              std::vector<uint32_t> &spirv);
-  static void saveVulkanCache(const std::string &kernel_name,
-                              const DeviceInfo &device,
+  // source: kernel source bytes; options: compile options and target env;
+  // compiler: compiler identity and version
+  static uint64_t makeKey(const std::string &source, const std::string &options,
+                          const std::string &compiler);
+
+  static bool loadVulkanCache(uint64_t key, const DeviceInfo &device,
+                              Blob &spirv);
+  static void saveVulkanCache(uint64_t key, const DeviceInfo &device,
                               const std::vector<uint32_t> &spirv);
 
-  static bool loadROCmCache(const std::string &kernel_name,
-                            const DeviceInfo &device, std::vector<char> &code);
-  static void saveROCmCache(const std::string &kernel_name,
-                            const DeviceInfo &device,
+  // Driver-compiled pipelines (vkGetPipelineCacheData blob), one per device.
+  // The blob's header is validated by the caller.
+  static bool loadVulkanPipelineCache(const DeviceInfo &device,
+                                      std::vector<char> &data);
+  static void saveVulkanPipelineCache(const DeviceInfo &device,
+                                      const std::vector<char> &data);
+
+  static bool loadROCmCache(uint64_t key, const DeviceInfo &device,
+                            Blob &code);
+  static void saveROCmCache(uint64_t key, const DeviceInfo &device,
                             const std::vector<char> &code);
 
-  static bool loadOpenCLCache(const std::string &kernel_name,
-                              const DeviceInfo &device,
-                              std::vector<char> &binary);
-  static void saveOpenCLCache(const std::string &kernel_name,
-                              const DeviceInfo &device,
+  static bool loadOpenCLCache(uint64_t key, const DeviceInfo &device,
+                              Blob &binary);
+  static void saveOpenCLCache(uint64_t key, const DeviceInfo &device,
                               const std::vector<char> &binary);
 
+  // Commits buffered saves to disk
+  static void flush();
+
 private:
-  static std::string getSafeName(const std::string &name);
+  static bool loadEntry(const DeviceInfo &device, uint64_t key,
+                        const char *kind, Blob &blob);
+  static void saveEntry(const DeviceInfo &device, uint64_t key,
+                        const char *kind, const char *data, size_t size);
 };
 
 } // namespace utils
@@ -0,0 +1,106 @@
+#include "utils/ThreadPool.h"
+
+namespace utils {
+
+ThreadPool::ThreadPool(unsigned threads) {
+  if (threads == 0)
+    threads = std::thread::hardware_concurrency();
+  if (threads == 0)
+    threads = 1;
+  for (unsigned i = 0; i < threads; ++i)
+    queues.push_back(std::make_unique<Queue>());
+  for (unsigned i = 0; i < threads; ++i)
+    workers.emplace_back(&ThreadPool::workerLoop, this, i);
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  wake.notify_all();
+  for (auto &worker : workers)
+    worker.join();
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+  size_t target;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    target = nextQueue++ % queues.size();
+    ++unfinished;
+  }
+  {
+    std::lock_guard<std::mutex> lock(queues[target]->mutex);
+    queues[target]->tasks.push_back(std::move(task));
+  }
+  {
+    // Publish only once the task is in its deque
+    std::lock_guard<std::mutex> lock(mutex);
+    ++queued;
+  }
+  wake.notify_one();
+}
+
+void ThreadPool::wait() {
+  std::unique_lock<std::mutex> lock(mutex);
+  idle.wait(lock, [this] { return unfinished == 0; });
+  if (error) {
+    std::exception_ptr e = error;
+    error = nullptr;
+    std::rethrow_exception(e);
+  }
+}
+
+std::function<void()> ThreadPool::take(unsigned self) {
+  // The caller has claimed a queued task, so one of the deques holds it
+  for (;;) {
+    {
+      Queue &own = *queues[self];
+      std::lock_guard<std::mutex> lock(own.mutex);
+      if (!own.tasks.empty()) {
+        auto task = std::move(own.tasks.back());
+        own.tasks.pop_back();
+        return task;
+      }
+    }
+    for (size_t i = 1; i < queues.size(); ++i) {
+      Queue &victim = *queues[(self + i) % queues.size()];
+      std::lock_guard<std::mutex> lock(victim.mutex);
+      if (!victim.tasks.empty()) {
+        auto task = std::move(victim.tasks.front());
+        victim.tasks.pop_front();
+        return task;
+      }
+    }
+    std::this_thread::yield();
+  }
+}
+
+void ThreadPool::workerLoop(unsigned self) {
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      wake.wait(lock, [this] { return queued > 0 || stopping; });
+      if (queued == 0)
+        return;
+      --queued;
+    }
+
+    std::function<void()> task = take(self);
+    std::exception_ptr failure;
+    try {
+      task();
+    } catch (...) {
+      failure = std::current_exception();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (failure && !error)
+      error = failure;
+    if (--unfinished == 0)
+      idle.notify_all();
+  }
+}
+
+} // namespace utils
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace utils {
+
+// Fixed set of workers with one task deque each. submit() deals tasks out
+// round-robin; a worker runs its own deque newest-first and, once that is
+// empty, steals the oldest task of another worker, so a few long tasks (a
+// large shader) don't hold up the short ones queued behind them.
+class ThreadPool {
+public:
+  // threads == 0 uses std::thread::hardware_concurrency()
+  explicit ThreadPool(unsigned threads = 0);
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  unsigned size() const { return static_cast<unsigned>(workers.size()); }
+
+  void submit(std::function<void()> task);
+
+  // Blocks until every submitted task has finished, then rethrows the first
+  // exception a task threw, if any
+  void wait();
+
+private:
+  struct Queue {
+    std::mutex mutex;
+    std::deque<std::function<void()>> tasks;
+  };
+
+  void workerLoop(unsigned self);
+  std::function<void()> take(unsigned self);
+
+  std::vector<std::unique_ptr<Queue>> queues;
+  std::vector<std::thread> workers;
+
+  // Guards the counters below; `queued` tasks sit in some deque and each
+  // sleeping worker that claims one is guaranteed to find it
+  std::mutex mutex;
+  std::condition_variable wake;
+  std::condition_variable idle;
+  size_t queued = 0;
+  size_t unfinished = 0;
+  size_t nextQueue = 0;
+  bool stopping = false;
+  std::exception_ptr error;
+};
+
+} // namespace utils
@@ -0,0 +1,18 @@
+// The registry lists benchmarks without constructing them, so its
+// descriptors repeat each benchmark's name, aliases and category. Fails if
+// any of them has drifted from the benchmark itself.
+#include "benchmarks/BenchmarkRegistry.h"
+#include <iostream>
+
+int main() {
+  auto errors = BenchmarkRegistry::verify();
+  for (const auto &error : errors)
+    std::cerr << error << std::endl;
+  if (!errors.empty()) {
+    std::cerr << errors.size() << " descriptor mismatch(es)" << std::endl;
+    return 1;
+  }
+  std::cout << BenchmarkRegistry::all().size()
+            << " descriptors match their benchmarks" << std::endl;
+  return 0;
+}
@@ -0,0 +1,215 @@
+// Drives BenchmarkRunner over SimulatedContext devices. The simulated clock
+// makes every run deterministic and lets the sampling limits and the TDR
+// guard be hit without waiting for them.
+#include "core/BenchmarkRunner.h"
+#include "core/SimulatedContext.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+static int failures = 0;
+
+#define CHECK(cond)                                                            \
+  do {                                                                         \
+    if (!(cond)) {                                                             \
+      std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK(" #cond ") failed"  \
+                << std::endl;                                                  \
+      ++failures;                                                              \
+    }                                                                          \
+  } while (0)
+
+// One context per device, the way main() sets them up
+struct SimulatedRun {
+  std::vector<std::unique_ptr<SimulatedContext>> owned;
+  std::vector<IComputeContext *> contexts;
+
+  explicit SimulatedRun(const std::vector<SimulatedDevice> &devices) {
+    for (uint32_t i = 0; i < devices.size(); ++i) {
+      owned.push_back(std::make_unique<SimulatedContext>(devices));
+      owned.back()->pickDevice(i);
+      contexts.push_back(owned.back().get());
+    }
+  }
+};
+
+static std::vector<ResultData>
+runSimulated(const std::vector<SimulatedDevice> &devices,
+             const std::vector<std::string> &selection,
+             const SamplingPolicy &policy = SamplingPolicy(),
+             bool parallel = false) {
+  SimulatedRun run(devices);
+  BenchmarkRunner runner(run.contexts);
+  runner.onResult = [](const ResultData &) {}; // Don't print the table
+  runner.setSamplingPolicy(policy);
+  runner.setParallelDevices(parallel);
+  runner.run(selection);
+
+  // Parallel workers publish in completion order
+  std::vector<ResultData> results = runner.getResults();
+  std::stable_sort(results.begin(), results.end(),
+                   [](const ResultData &a, const ResultData &b) {
+                     return std::tie(a.deviceIndex, a.benchmarkName) <
+                            std::tie(b.deviceIndex, b.benchmarkName);
+                   });
+  return results;
+}
+
+static const ResultData *find(const std::vector<ResultData> &results,
+                              uint32_t device, const std::string &name) {
+  for (const auto &r : results) {
+    if (r.deviceIndex == device && r.benchmarkName == name)
+      return &r;
+  }
+  return nullptr;
+}
+
+static bool sameResults(const std::vector<ResultData> &a,
+                        const std::vector<ResultData> &b) {
+  if (a.size() != b.size())
+    return false;
+  for (size_t i = 0; i < a.size(); ++i) {
+    const ResultData &x = a[i], &y = b[i];
+    if (x.deviceIndex != y.deviceIndex || x.benchmarkName != y.benchmarkName ||
+        x.operations != y.operations || x.time_ms != y.time_ms ||
+        x.sampleCount != y.sampleCount || x.median_ms != y.median_ms ||
+        x.mean_ms != y.mean_ms || x.stddev_ms != y.stddev_ms ||
+        x.warmupIterations != y.warmupIterations ||
+        x.warmup_ms != y.warmup_ms || x.batchSize != y.batchSize)
+      return false;
+  }
+  return true;
+}
+
+static SimulatedDevice quietDevice() {
+  SimulatedDevice device = SimulatedContext::defaultDevices()[0];
+  device.jitter = 0.0;
+  return device;
+}
+
+static void testDeterministicScheduling() {
+  auto devices = SimulatedContext::defaultDevices();
+  auto first = runSimulated(devices, {"fp32", "fp64"});
+  auto second = runSimulated(devices, {"fp32", "fp64"});
+  CHECK(!first.empty());
+  CHECK(sameResults(first, second));
+
+  // Device order, then registry order within each device
+  std::vector<std::string> order;
+  for (const auto &r : first)
+    order.push_back(std::to_string(r.deviceIndex) + " " + r.benchmarkName);
+  CHECK((order == std::vector<std::string>{"0 FP32", "0 FP64", "1 FP32",
+                                           "1 FP64"}));
+}
+
+static void testMultiDevice() {
+  auto devices = SimulatedContext::defaultDevices();
+  auto serial = runSimulated(devices, {"fp32"});
+  auto parallel = runSimulated(devices, {"fp32"}, SamplingPolicy(), true);
+
+  const ResultData *discrete = find(serial, 0, "FP32");
+  const ResultData *integrated = find(serial, 1, "FP32");
+  CHECK(discrete && integrated);
+  if (discrete && integrated) {
+    CHECK(discrete->deviceName == devices[0].info.name);
+    CHECK(integrated->deviceName == devices[1].info.name);
+    // 40 vs 8 TFLOPS, the integrated one throttling on top
+    CHECK(discrete->median_ms * 4 < integrated->median_ms);
+  }
+  // Every context keeps its own clock, so running the devices side by side
+  // must not change what either measures
+  CHECK(sameResults(serial, parallel));
+}
+
+static void testEarlyStop() {
+  SamplingPolicy policy;
+  policy.minSamples = 10;
+  policy.minTimeMs = 100.0;
+  policy.maxTimeMs = 2000.0;
+
+  // Without jitter the confidence interval is zero as soon as the minimums
+  // are met. A FP32 dispatch takes ~55 ms, so that is after minSamples.
+  auto quiet = runSimulated({quietDevice()}, {"fp32"}, policy);
+  CHECK(quiet.size() == 1);
+  if (!quiet.empty()) {
+    CHECK(quiet[0].sampleCount == policy.minSamples);
+    CHECK(quiet[0].stddev_ms == 0.0);
+  }
+
+  // An unreachable CI target runs into maxTimeMs instead
+  SimulatedDevice noisy = quietDevice();
+  noisy.jitter = 0.5;
+  policy.targetRelCI = 1e-6;
+  auto capped = runSimulated({noisy}, {"fp32"}, policy);
+  CHECK(capped.size() == 1);
+  if (!capped.empty()) {
+    double elapsed = capped[0].sampleCount * capped[0].mean_ms;
+    CHECK(capped[0].sampleCount > policy.minSamples);
+    CHECK(elapsed >= policy.maxTimeMs);
+    CHECK(elapsed < policy.maxTimeMs + 2.0 * capped[0].mean_ms);
+  }
+}
+
+static void testTdrGuard() {
+  // At 0.5 TFLOPS a FP32 dispatch takes ~4.4 s, past the 3 s abort limit
+  SimulatedDevice slow = quietDevice();
+  slow.fp32FlopsPerSecond = 0.5e12;
+  auto results = runSimulated({slow}, {"fp32", "fp64"});
+
+  const ResultData *fp32 = find(results, 0, "FP32");
+  const ResultData *fp64 = find(results, 0, "FP64");
+  CHECK(fp32 != nullptr);
+  if (fp32) {
+    // Aborted in the first warm-up iteration, nothing sampled
+    CHECK(fp32->warmupIterations == 0);
+    CHECK(fp32->sampleCount == 0);
+    CHECK(fp32->operations == 0);
+  }
+  // The next benchmark still runs
+  CHECK(fp64 != nullptr);
+  if (fp64)
+    CHECK(fp64->sampleCount > 0);
+}
+
+static void testKernelCosts() {
+  SimulatedContext context({quietDevice()});
+  context.pickDevice(0);
+
+  // No cost registered for the stem: rejected, not timed as free
+  bool threw = false;
+  try {
+    context.createKernel("kernels/vulkan/fp16.comp", "main", 1);
+  } catch (const std::runtime_error &) {
+    threw = true;
+  }
+  CHECK(threw);
+
+  // A zero cost takes only the launch latency
+  SimulatedContext::setKernelCost("launch_only", SimulatedKernelCost());
+  ComputeKernel kernel =
+      context.createKernel("kernels/vulkan/launch_only.comp", "main", 0);
+  context.beginTiming();
+  context.dispatch(kernel, 1024, 1, 1, 64, 1, 1);
+  context.endTiming();
+  CHECK(std::abs(context.getTimingResult() * 1e3 -
+                 quietDevice().launchLatencyUs) < 1e-6);
+  context.releaseKernel(kernel);
+}
+
+int main() {
+  testDeterministicScheduling();
+  testMultiDevice();
+  testEarlyStop();
+  testTdrGuard();
+  testKernelCosts();
+  if (failures) {
+    std::cerr << failures << " check(s) failed" << std::endl;
+    return 1;
+  }
+  std::cout << "All checks passed" << std::endl;
+  return 0;
+}